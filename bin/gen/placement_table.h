@@ -0,0 +1,155 @@
+// Generated by src/tools/gen_placements.c. Do not edit.
+#ifndef PLACEMENT_TABLE_H
+#define PLACEMENT_TABLE_H
+
+#include <stdint.h>
+
+#include "bitboard.h"
+
+_Static_assert(BOARD_ROWS == 10 && BOARD_COLS == 10, "placement_table.h is stale, rerun make");
+
+#define PLACEMENT_MAX_SIZE 10
+#define PLACEMENT_MASK(hi, lo) (((BoardMask)(hi) << 64) | (BoardMask)(lo))
+
+// Cells covered by a ship of size s, orientation o, top-left cell i;
+// 0 where the ship would leave the board.
+static const BoardMask placement_at[PLACEMENT_MAX_SIZE + 1][2][BOARD_CELLS] = {
+  { // Size 0
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+  },
+  { // Size 1
+    {PLACEMENT_MASK(0x0ull, 0x1ull), PLACEMENT_MASK(0x0ull, 0x2ull), PLACEMENT_MASK(0x0ull, 0x4ull), PLACEMENT_MASK(0x0ull, 0x8ull), PLACEMENT_MASK(0x0ull, 0x10ull), PLACEMENT_MASK(0x0ull, 0x20ull), PLACEMENT_MASK(0x0ull, 0x40ull), PLACEMENT_MASK(0x0ull, 0x80ull), PLACEMENT_MASK(0x0ull, 0x100ull), PLACEMENT_MASK(0x0ull, 0x200ull), PLACEMENT_MASK(0x0ull, 0x400ull), PLACEMENT_MASK(0x0ull, 0x800ull), PLACEMENT_MASK(0x0ull, 0x1000ull), PLACEMENT_MASK(0x0ull, 0x2000ull), PLACEMENT_MASK(0x0ull, 0x4000ull), PLACEMENT_MASK(0x0ull, 0x8000ull), PLACEMENT_MASK(0x0ull, 0x10000ull), PLACEMENT_MASK(0x0ull, 0x20000ull), PLACEMENT_MASK(0x0ull, 0x40000ull), PLACEMENT_MASK(0x0ull, 0x80000ull), PLACEMENT_MASK(0x0ull, 0x100000ull), PLACEMENT_MASK(0x0ull, 0x200000ull), PLACEMENT_MASK(0x0ull, 0x400000ull), PLACEMENT_MASK(0x0ull, 0x800000ull), PLACEMENT_MASK(0x0ull, 0x1000000ull), PLACEMENT_MASK(0x0ull, 0x2000000ull), PLACEMENT_MASK(0x0ull, 0x4000000ull), PLACEMENT_MASK(0x0ull, 0x8000000ull), PLACEMENT_MASK(0x0ull, 0x10000000ull), PLACEMENT_MASK(0x0ull, 0x20000000ull), PLACEMENT_MASK(0x0ull, 0x40000000ull), PLACEMENT_MASK(0x0ull, 0x80000000ull), PLACEMENT_MASK(0x0ull, 0x100000000ull), PLACEMENT_MASK(0x0ull, 0x200000000ull), PLACEMENT_MASK(0x0ull, 0x400000000ull), PLACEMENT_MASK(0x0ull, 0x800000000ull), PLACEMENT_MASK(0x0ull, 0x1000000000ull), PLACEMENT_MASK(0x0ull, 0x2000000000ull), PLACEMENT_MASK(0x0ull, 0x4000000000ull), PLACEMENT_MASK(0x0ull, 0x8000000000ull), PLACEMENT_MASK(0x0ull, 0x10000000000ull), PLACEMENT_MASK(0x0ull, 0x20000000000ull), PLACEMENT_MASK(0x0ull, 0x40000000000ull), PLACEMENT_MASK(0x0ull, 0x80000000000ull), PLACEMENT_MASK(0x0ull, 0x100000000000ull), PLACEMENT_MASK(0x0ull, 0x200000000000ull), PLACEMENT_MASK(0x0ull, 0x400000000000ull), PLACEMENT_MASK(0x0ull, 0x800000000000ull), PLACEMENT_MASK(0x0ull, 0x1000000000000ull), PLACEMENT_MASK(0x0ull, 0x2000000000000ull), PLACEMENT_MASK(0x0ull, 0x4000000000000ull), PLACEMENT_MASK(0x0ull, 0x8000000000000ull), PLACEMENT_MASK(0x0ull, 0x10000000000000ull), PLACEMENT_MASK(0x0ull, 0x20000000000000ull), PLACEMENT_MASK(0x0ull, 0x40000000000000ull), PLACEMENT_MASK(0x0ull, 0x80000000000000ull), PLACEMENT_MASK(0x0ull, 0x100000000000000ull), PLACEMENT_MASK(0x0ull, 0x200000000000000ull), PLACEMENT_MASK(0x0ull, 0x400000000000000ull), PLACEMENT_MASK(0x0ull, 0x800000000000000ull), PLACEMENT_MASK(0x0ull, 0x1000000000000000ull), PLACEMENT_MASK(0x0ull, 0x2000000000000000ull), PLACEMENT_MASK(0x0ull, 0x4000000000000000ull), PLACEMENT_MASK(0x0ull, 0x8000000000000000ull), PLACEMENT_MASK(0x1ull, 0x0ull), PLACEMENT_MASK(0x2ull, 0x0ull), PLACEMENT_MASK(0x4ull, 0x0ull), PLACEMENT_MASK(0x8ull, 0x0ull), PLACEMENT_MASK(0x10ull, 0x0ull), PLACEMENT_MASK(0x20ull, 0x0ull), PLACEMENT_MASK(0x40ull, 0x0ull), PLACEMENT_MASK(0x80ull, 0x0ull), PLACEMENT_MASK(0x100ull, 0x0ull), PLACEMENT_MASK(0x200ull, 0x0ull), PLACEMENT_MASK(0x400ull, 0x0ull), PLACEMENT_MASK(0x800ull, 0x0ull), PLACEMENT_MASK(0x1000ull, 0x0ull), PLACEMENT_MASK(0x2000ull, 0x0ull), PLACEMENT_MASK(0x4000ull, 0x0ull), PLACEMENT_MASK(0x8000ull, 0x0ull), PLACEMENT_MASK(0x10000ull, 0x0ull), PLACEMENT_MASK(0x20000ull, 0x0ull), PLACEMENT_MASK(0x40000ull, 0x0ull), PLACEMENT_MASK(0x80000ull, 0x0ull), PLACEMENT_MASK(0x100000ull, 0x0ull), PLACEMENT_MASK(0x200000ull, 0x0ull), PLACEMENT_MASK(0x400000ull, 0x0ull), PLACEMENT_MASK(0x800000ull, 0x0ull), PLACEMENT_MASK(0x1000000ull, 0x0ull), PLACEMENT_MASK(0x2000000ull, 0x0ull), PLACEMENT_MASK(0x4000000ull, 0x0ull), PLACEMENT_MASK(0x8000000ull, 0x0ull), PLACEMENT_MASK(0x10000000ull, 0x0ull), PLACEMENT_MASK(0x20000000ull, 0x0ull), PLACEMENT_MASK(0x40000000ull, 0x0ull), PLACEMENT_MASK(0x80000000ull, 0x0ull), PLACEMENT_MASK(0x100000000ull, 0x0ull), PLACEMENT_MASK(0x200000000ull, 0x0ull), PLACEMENT_MASK(0x400000000ull, 0x0ull), PLACEMENT_MASK(0x800000000ull, 0x0ull)},
+    {PLACEMENT_MASK(0x0ull, 0x1ull), PLACEMENT_MASK(0x0ull, 0x2ull), PLACEMENT_MASK(0x0ull, 0x4ull), PLACEMENT_MASK(0x0ull, 0x8ull), PLACEMENT_MASK(0x0ull, 0x10ull), PLACEMENT_MASK(0x0ull, 0x20ull), PLACEMENT_MASK(0x0ull, 0x40ull), PLACEMENT_MASK(0x0ull, 0x80ull), PLACEMENT_MASK(0x0ull, 0x100ull), PLACEMENT_MASK(0x0ull, 0x200ull), PLACEMENT_MASK(0x0ull, 0x400ull), PLACEMENT_MASK(0x0ull, 0x800ull), PLACEMENT_MASK(0x0ull, 0x1000ull), PLACEMENT_MASK(0x0ull, 0x2000ull), PLACEMENT_MASK(0x0ull, 0x4000ull), PLACEMENT_MASK(0x0ull, 0x8000ull), PLACEMENT_MASK(0x0ull, 0x10000ull), PLACEMENT_MASK(0x0ull, 0x20000ull), PLACEMENT_MASK(0x0ull, 0x40000ull), PLACEMENT_MASK(0x0ull, 0x80000ull), PLACEMENT_MASK(0x0ull, 0x100000ull), PLACEMENT_MASK(0x0ull, 0x200000ull), PLACEMENT_MASK(0x0ull, 0x400000ull), PLACEMENT_MASK(0x0ull, 0x800000ull), PLACEMENT_MASK(0x0ull, 0x1000000ull), PLACEMENT_MASK(0x0ull, 0x2000000ull), PLACEMENT_MASK(0x0ull, 0x4000000ull), PLACEMENT_MASK(0x0ull, 0x8000000ull), PLACEMENT_MASK(0x0ull, 0x10000000ull), PLACEMENT_MASK(0x0ull, 0x20000000ull), PLACEMENT_MASK(0x0ull, 0x40000000ull), PLACEMENT_MASK(0x0ull, 0x80000000ull), PLACEMENT_MASK(0x0ull, 0x100000000ull), PLACEMENT_MASK(0x0ull, 0x200000000ull), PLACEMENT_MASK(0x0ull, 0x400000000ull), PLACEMENT_MASK(0x0ull, 0x800000000ull), PLACEMENT_MASK(0x0ull, 0x1000000000ull), PLACEMENT_MASK(0x0ull, 0x2000000000ull), PLACEMENT_MASK(0x0ull, 0x4000000000ull), PLACEMENT_MASK(0x0ull, 0x8000000000ull), PLACEMENT_MASK(0x0ull, 0x10000000000ull), PLACEMENT_MASK(0x0ull, 0x20000000000ull), PLACEMENT_MASK(0x0ull, 0x40000000000ull), PLACEMENT_MASK(0x0ull, 0x80000000000ull), PLACEMENT_MASK(0x0ull, 0x100000000000ull), PLACEMENT_MASK(0x0ull, 0x200000000000ull), PLACEMENT_MASK(0x0ull, 0x400000000000ull), PLACEMENT_MASK(0x0ull, 0x800000000000ull), PLACEMENT_MASK(0x0ull, 0x1000000000000ull), PLACEMENT_MASK(0x0ull, 0x2000000000000ull), PLACEMENT_MASK(0x0ull, 0x4000000000000ull), PLACEMENT_MASK(0x0ull, 0x8000000000000ull), PLACEMENT_MASK(0x0ull, 0x10000000000000ull), PLACEMENT_MASK(0x0ull, 0x20000000000000ull), PLACEMENT_MASK(0x0ull, 0x40000000000000ull), PLACEMENT_MASK(0x0ull, 0x80000000000000ull), PLACEMENT_MASK(0x0ull, 0x100000000000000ull), PLACEMENT_MASK(0x0ull, 0x200000000000000ull), PLACEMENT_MASK(0x0ull, 0x400000000000000ull), PLACEMENT_MASK(0x0ull, 0x800000000000000ull), PLACEMENT_MASK(0x0ull, 0x1000000000000000ull), PLACEMENT_MASK(0x0ull, 0x2000000000000000ull), PLACEMENT_MASK(0x0ull, 0x4000000000000000ull), PLACEMENT_MASK(0x0ull, 0x8000000000000000ull), PLACEMENT_MASK(0x1ull, 0x0ull), PLACEMENT_MASK(0x2ull, 0x0ull), PLACEMENT_MASK(0x4ull, 0x0ull), PLACEMENT_MASK(0x8ull, 0x0ull), PLACEMENT_MASK(0x10ull, 0x0ull), PLACEMENT_MASK(0x20ull, 0x0ull), PLACEMENT_MASK(0x40ull, 0x0ull), PLACEMENT_MASK(0x80ull, 0x0ull), PLACEMENT_MASK(0x100ull, 0x0ull), PLACEMENT_MASK(0x200ull, 0x0ull), PLACEMENT_MASK(0x400ull, 0x0ull), PLACEMENT_MASK(0x800ull, 0x0ull), PLACEMENT_MASK(0x1000ull, 0x0ull), PLACEMENT_MASK(0x2000ull, 0x0ull), PLACEMENT_MASK(0x4000ull, 0x0ull), PLACEMENT_MASK(0x8000ull, 0x0ull), PLACEMENT_MASK(0x10000ull, 0x0ull), PLACEMENT_MASK(0x20000ull, 0x0ull), PLACEMENT_MASK(0x40000ull, 0x0ull), PLACEMENT_MASK(0x80000ull, 0x0ull), PLACEMENT_MASK(0x100000ull, 0x0ull), PLACEMENT_MASK(0x200000ull, 0x0ull), PLACEMENT_MASK(0x400000ull, 0x0ull), PLACEMENT_MASK(0x800000ull, 0x0ull), PLACEMENT_MASK(0x1000000ull, 0x0ull), PLACEMENT_MASK(0x2000000ull, 0x0ull), PLACEMENT_MASK(0x4000000ull, 0x0ull), PLACEMENT_MASK(0x8000000ull, 0x0ull), PLACEMENT_MASK(0x10000000ull, 0x0ull), PLACEMENT_MASK(0x20000000ull, 0x0ull), PLACEMENT_MASK(0x40000000ull, 0x0ull), PLACEMENT_MASK(0x80000000ull, 0x0ull), PLACEMENT_MASK(0x100000000ull, 0x0ull), PLACEMENT_MASK(0x200000000ull, 0x0ull), PLACEMENT_MASK(0x400000000ull, 0x0ull), PLACEMENT_MASK(0x800000000ull, 0x0ull)},
+  },
+  { // Size 2
+    {PLACEMENT_MASK(0x0ull, 0x3ull), PLACEMENT_MASK(0x0ull, 0x6ull), PLACEMENT_MASK(0x0ull, 0xcull), PLACEMENT_MASK(0x0ull, 0x18ull), PLACEMENT_MASK(0x0ull, 0x30ull), PLACEMENT_MASK(0x0ull, 0x60ull), PLACEMENT_MASK(0x0ull, 0xc0ull), PLACEMENT_MASK(0x0ull, 0x180ull), PLACEMENT_MASK(0x0ull, 0x300ull), 0, PLACEMENT_MASK(0x0ull, 0xc00ull), PLACEMENT_MASK(0x0ull, 0x1800ull), PLACEMENT_MASK(0x0ull, 0x3000ull), PLACEMENT_MASK(0x0ull, 0x6000ull), PLACEMENT_MASK(0x0ull, 0xc000ull), PLACEMENT_MASK(0x0ull, 0x18000ull), PLACEMENT_MASK(0x0ull, 0x30000ull), PLACEMENT_MASK(0x0ull, 0x60000ull), PLACEMENT_MASK(0x0ull, 0xc0000ull), 0, PLACEMENT_MASK(0x0ull, 0x300000ull), PLACEMENT_MASK(0x0ull, 0x600000ull), PLACEMENT_MASK(0x0ull, 0xc00000ull), PLACEMENT_MASK(0x0ull, 0x1800000ull), PLACEMENT_MASK(0x0ull, 0x3000000ull), PLACEMENT_MASK(0x0ull, 0x6000000ull), PLACEMENT_MASK(0x0ull, 0xc000000ull), PLACEMENT_MASK(0x0ull, 0x18000000ull), PLACEMENT_MASK(0x0ull, 0x30000000ull), 0, PLACEMENT_MASK(0x0ull, 0xc0000000ull), PLACEMENT_MASK(0x0ull, 0x180000000ull), PLACEMENT_MASK(0x0ull, 0x300000000ull), PLACEMENT_MASK(0x0ull, 0x600000000ull), PLACEMENT_MASK(0x0ull, 0xc00000000ull), PLACEMENT_MASK(0x0ull, 0x1800000000ull), PLACEMENT_MASK(0x0ull, 0x3000000000ull), PLACEMENT_MASK(0x0ull, 0x6000000000ull), PLACEMENT_MASK(0x0ull, 0xc000000000ull), 0, PLACEMENT_MASK(0x0ull, 0x30000000000ull), PLACEMENT_MASK(0x0ull, 0x60000000000ull), PLACEMENT_MASK(0x0ull, 0xc0000000000ull), PLACEMENT_MASK(0x0ull, 0x180000000000ull), PLACEMENT_MASK(0x0ull, 0x300000000000ull), PLACEMENT_MASK(0x0ull, 0x600000000000ull), PLACEMENT_MASK(0x0ull, 0xc00000000000ull), PLACEMENT_MASK(0x0ull, 0x1800000000000ull), PLACEMENT_MASK(0x0ull, 0x3000000000000ull), 0, PLACEMENT_MASK(0x0ull, 0xc000000000000ull), PLACEMENT_MASK(0x0ull, 0x18000000000000ull), PLACEMENT_MASK(0x0ull, 0x30000000000000ull), PLACEMENT_MASK(0x0ull, 0x60000000000000ull), PLACEMENT_MASK(0x0ull, 0xc0000000000000ull), PLACEMENT_MASK(0x0ull, 0x180000000000000ull), PLACEMENT_MASK(0x0ull, 0x300000000000000ull), PLACEMENT_MASK(0x0ull, 0x600000000000000ull), PLACEMENT_MASK(0x0ull, 0xc00000000000000ull), 0, PLACEMENT_MASK(0x0ull, 0x3000000000000000ull), PLACEMENT_MASK(0x0ull, 0x6000000000000000ull), PLACEMENT_MASK(0x0ull, 0xc000000000000000ull), PLACEMENT_MASK(0x1ull, 0x8000000000000000ull), PLACEMENT_MASK(0x3ull, 0x0ull), PLACEMENT_MASK(0x6ull, 0x0ull), PLACEMENT_MASK(0xcull, 0x0ull), PLACEMENT_MASK(0x18ull, 0x0ull), PLACEMENT_MASK(0x30ull, 0x0ull), 0, PLACEMENT_MASK(0xc0ull, 0x0ull), PLACEMENT_MASK(0x180ull, 0x0ull), PLACEMENT_MASK(0x300ull, 0x0ull), PLACEMENT_MASK(0x600ull, 0x0ull), PLACEMENT_MASK(0xc00ull, 0x0ull), PLACEMENT_MASK(0x1800ull, 0x0ull), PLACEMENT_MASK(0x3000ull, 0x0ull), PLACEMENT_MASK(0x6000ull, 0x0ull), PLACEMENT_MASK(0xc000ull, 0x0ull), 0, PLACEMENT_MASK(0x30000ull, 0x0ull), PLACEMENT_MASK(0x60000ull, 0x0ull), PLACEMENT_MASK(0xc0000ull, 0x0ull), PLACEMENT_MASK(0x180000ull, 0x0ull), PLACEMENT_MASK(0x300000ull, 0x0ull), PLACEMENT_MASK(0x600000ull, 0x0ull), PLACEMENT_MASK(0xc00000ull, 0x0ull), PLACEMENT_MASK(0x1800000ull, 0x0ull), PLACEMENT_MASK(0x3000000ull, 0x0ull), 0, PLACEMENT_MASK(0xc000000ull, 0x0ull), PLACEMENT_MASK(0x18000000ull, 0x0ull), PLACEMENT_MASK(0x30000000ull, 0x0ull), PLACEMENT_MASK(0x60000000ull, 0x0ull), PLACEMENT_MASK(0xc0000000ull, 0x0ull), PLACEMENT_MASK(0x180000000ull, 0x0ull), PLACEMENT_MASK(0x300000000ull, 0x0ull), PLACEMENT_MASK(0x600000000ull, 0x0ull), PLACEMENT_MASK(0xc00000000ull, 0x0ull), 0},
+    {PLACEMENT_MASK(0x0ull, 0x401ull), PLACEMENT_MASK(0x0ull, 0x802ull), PLACEMENT_MASK(0x0ull, 0x1004ull), PLACEMENT_MASK(0x0ull, 0x2008ull), PLACEMENT_MASK(0x0ull, 0x4010ull), PLACEMENT_MASK(0x0ull, 0x8020ull), PLACEMENT_MASK(0x0ull, 0x10040ull), PLACEMENT_MASK(0x0ull, 0x20080ull), PLACEMENT_MASK(0x0ull, 0x40100ull), PLACEMENT_MASK(0x0ull, 0x80200ull), PLACEMENT_MASK(0x0ull, 0x100400ull), PLACEMENT_MASK(0x0ull, 0x200800ull), PLACEMENT_MASK(0x0ull, 0x401000ull), PLACEMENT_MASK(0x0ull, 0x802000ull), PLACEMENT_MASK(0x0ull, 0x1004000ull), PLACEMENT_MASK(0x0ull, 0x2008000ull), PLACEMENT_MASK(0x0ull, 0x4010000ull), PLACEMENT_MASK(0x0ull, 0x8020000ull), PLACEMENT_MASK(0x0ull, 0x10040000ull), PLACEMENT_MASK(0x0ull, 0x20080000ull), PLACEMENT_MASK(0x0ull, 0x40100000ull), PLACEMENT_MASK(0x0ull, 0x80200000ull), PLACEMENT_MASK(0x0ull, 0x100400000ull), PLACEMENT_MASK(0x0ull, 0x200800000ull), PLACEMENT_MASK(0x0ull, 0x401000000ull), PLACEMENT_MASK(0x0ull, 0x802000000ull), PLACEMENT_MASK(0x0ull, 0x1004000000ull), PLACEMENT_MASK(0x0ull, 0x2008000000ull), PLACEMENT_MASK(0x0ull, 0x4010000000ull), PLACEMENT_MASK(0x0ull, 0x8020000000ull), PLACEMENT_MASK(0x0ull, 0x10040000000ull), PLACEMENT_MASK(0x0ull, 0x20080000000ull), PLACEMENT_MASK(0x0ull, 0x40100000000ull), PLACEMENT_MASK(0x0ull, 0x80200000000ull), PLACEMENT_MASK(0x0ull, 0x100400000000ull), PLACEMENT_MASK(0x0ull, 0x200800000000ull), PLACEMENT_MASK(0x0ull, 0x401000000000ull), PLACEMENT_MASK(0x0ull, 0x802000000000ull), PLACEMENT_MASK(0x0ull, 0x1004000000000ull), PLACEMENT_MASK(0x0ull, 0x2008000000000ull), PLACEMENT_MASK(0x0ull, 0x4010000000000ull), PLACEMENT_MASK(0x0ull, 0x8020000000000ull), PLACEMENT_MASK(0x0ull, 0x10040000000000ull), PLACEMENT_MASK(0x0ull, 0x20080000000000ull), PLACEMENT_MASK(0x0ull, 0x40100000000000ull), PLACEMENT_MASK(0x0ull, 0x80200000000000ull), PLACEMENT_MASK(0x0ull, 0x100400000000000ull), PLACEMENT_MASK(0x0ull, 0x200800000000000ull), PLACEMENT_MASK(0x0ull, 0x401000000000000ull), PLACEMENT_MASK(0x0ull, 0x802000000000000ull), PLACEMENT_MASK(0x0ull, 0x1004000000000000ull), PLACEMENT_MASK(0x0ull, 0x2008000000000000ull), PLACEMENT_MASK(0x0ull, 0x4010000000000000ull), PLACEMENT_MASK(0x0ull, 0x8020000000000000ull), PLACEMENT_MASK(0x1ull, 0x40000000000000ull), PLACEMENT_MASK(0x2ull, 0x80000000000000ull), PLACEMENT_MASK(0x4ull, 0x100000000000000ull), PLACEMENT_MASK(0x8ull, 0x200000000000000ull), PLACEMENT_MASK(0x10ull, 0x400000000000000ull), PLACEMENT_MASK(0x20ull, 0x800000000000000ull), PLACEMENT_MASK(0x40ull, 0x1000000000000000ull), PLACEMENT_MASK(0x80ull, 0x2000000000000000ull), PLACEMENT_MASK(0x100ull, 0x4000000000000000ull), PLACEMENT_MASK(0x200ull, 0x8000000000000000ull), PLACEMENT_MASK(0x401ull, 0x0ull), PLACEMENT_MASK(0x802ull, 0x0ull), PLACEMENT_MASK(0x1004ull, 0x0ull), PLACEMENT_MASK(0x2008ull, 0x0ull), PLACEMENT_MASK(0x4010ull, 0x0ull), PLACEMENT_MASK(0x8020ull, 0x0ull), PLACEMENT_MASK(0x10040ull, 0x0ull), PLACEMENT_MASK(0x20080ull, 0x0ull), PLACEMENT_MASK(0x40100ull, 0x0ull), PLACEMENT_MASK(0x80200ull, 0x0ull), PLACEMENT_MASK(0x100400ull, 0x0ull), PLACEMENT_MASK(0x200800ull, 0x0ull), PLACEMENT_MASK(0x401000ull, 0x0ull), PLACEMENT_MASK(0x802000ull, 0x0ull), PLACEMENT_MASK(0x1004000ull, 0x0ull), PLACEMENT_MASK(0x2008000ull, 0x0ull), PLACEMENT_MASK(0x4010000ull, 0x0ull), PLACEMENT_MASK(0x8020000ull, 0x0ull), PLACEMENT_MASK(0x10040000ull, 0x0ull), PLACEMENT_MASK(0x20080000ull, 0x0ull), PLACEMENT_MASK(0x40100000ull, 0x0ull), PLACEMENT_MASK(0x80200000ull, 0x0ull), PLACEMENT_MASK(0x100400000ull, 0x0ull), PLACEMENT_MASK(0x200800000ull, 0x0ull), PLACEMENT_MASK(0x401000000ull, 0x0ull), PLACEMENT_MASK(0x802000000ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+  },
+  { // Size 3
+    {PLACEMENT_MASK(0x0ull, 0x7ull), PLACEMENT_MASK(0x0ull, 0xeull), PLACEMENT_MASK(0x0ull, 0x1cull), PLACEMENT_MASK(0x0ull, 0x38ull), PLACEMENT_MASK(0x0ull, 0x70ull), PLACEMENT_MASK(0x0ull, 0xe0ull), PLACEMENT_MASK(0x0ull, 0x1c0ull), PLACEMENT_MASK(0x0ull, 0x380ull), 0, 0, PLACEMENT_MASK(0x0ull, 0x1c00ull), PLACEMENT_MASK(0x0ull, 0x3800ull), PLACEMENT_MASK(0x0ull, 0x7000ull), PLACEMENT_MASK(0x0ull, 0xe000ull), PLACEMENT_MASK(0x0ull, 0x1c000ull), PLACEMENT_MASK(0x0ull, 0x38000ull), PLACEMENT_MASK(0x0ull, 0x70000ull), PLACEMENT_MASK(0x0ull, 0xe0000ull), 0, 0, PLACEMENT_MASK(0x0ull, 0x700000ull), PLACEMENT_MASK(0x0ull, 0xe00000ull), PLACEMENT_MASK(0x0ull, 0x1c00000ull), PLACEMENT_MASK(0x0ull, 0x3800000ull), PLACEMENT_MASK(0x0ull, 0x7000000ull), PLACEMENT_MASK(0x0ull, 0xe000000ull), PLACEMENT_MASK(0x0ull, 0x1c000000ull), PLACEMENT_MASK(0x0ull, 0x38000000ull), 0, 0, PLACEMENT_MASK(0x0ull, 0x1c0000000ull), PLACEMENT_MASK(0x0ull, 0x380000000ull), PLACEMENT_MASK(0x0ull, 0x700000000ull), PLACEMENT_MASK(0x0ull, 0xe00000000ull), PLACEMENT_MASK(0x0ull, 0x1c00000000ull), PLACEMENT_MASK(0x0ull, 0x3800000000ull), PLACEMENT_MASK(0x0ull, 0x7000000000ull), PLACEMENT_MASK(0x0ull, 0xe000000000ull), 0, 0, PLACEMENT_MASK(0x0ull, 0x70000000000ull), PLACEMENT_MASK(0x0ull, 0xe0000000000ull), PLACEMENT_MASK(0x0ull, 0x1c0000000000ull), PLACEMENT_MASK(0x0ull, 0x380000000000ull), PLACEMENT_MASK(0x0ull, 0x700000000000ull), PLACEMENT_MASK(0x0ull, 0xe00000000000ull), PLACEMENT_MASK(0x0ull, 0x1c00000000000ull), PLACEMENT_MASK(0x0ull, 0x3800000000000ull), 0, 0, PLACEMENT_MASK(0x0ull, 0x1c000000000000ull), PLACEMENT_MASK(0x0ull, 0x38000000000000ull), PLACEMENT_MASK(0x0ull, 0x70000000000000ull), PLACEMENT_MASK(0x0ull, 0xe0000000000000ull), PLACEMENT_MASK(0x0ull, 0x1c0000000000000ull), PLACEMENT_MASK(0x0ull, 0x380000000000000ull), PLACEMENT_MASK(0x0ull, 0x700000000000000ull), PLACEMENT_MASK(0x0ull, 0xe00000000000000ull), 0, 0, PLACEMENT_MASK(0x0ull, 0x7000000000000000ull), PLACEMENT_MASK(0x0ull, 0xe000000000000000ull), PLACEMENT_MASK(0x1ull, 0xc000000000000000ull), PLACEMENT_MASK(0x3ull, 0x8000000000000000ull), PLACEMENT_MASK(0x7ull, 0x0ull), PLACEMENT_MASK(0xeull, 0x0ull), PLACEMENT_MASK(0x1cull, 0x0ull), PLACEMENT_MASK(0x38ull, 0x0ull), 0, 0, PLACEMENT_MASK(0x1c0ull, 0x0ull), PLACEMENT_MASK(0x380ull, 0x0ull), PLACEMENT_MASK(0x700ull, 0x0ull), PLACEMENT_MASK(0xe00ull, 0x0ull), PLACEMENT_MASK(0x1c00ull, 0x0ull), PLACEMENT_MASK(0x3800ull, 0x0ull), PLACEMENT_MASK(0x7000ull, 0x0ull), PLACEMENT_MASK(0xe000ull, 0x0ull), 0, 0, PLACEMENT_MASK(0x70000ull, 0x0ull), PLACEMENT_MASK(0xe0000ull, 0x0ull), PLACEMENT_MASK(0x1c0000ull, 0x0ull), PLACEMENT_MASK(0x380000ull, 0x0ull), PLACEMENT_MASK(0x700000ull, 0x0ull), PLACEMENT_MASK(0xe00000ull, 0x0ull), PLACEMENT_MASK(0x1c00000ull, 0x0ull), PLACEMENT_MASK(0x3800000ull, 0x0ull), 0, 0, PLACEMENT_MASK(0x1c000000ull, 0x0ull), PLACEMENT_MASK(0x38000000ull, 0x0ull), PLACEMENT_MASK(0x70000000ull, 0x0ull), PLACEMENT_MASK(0xe0000000ull, 0x0ull), PLACEMENT_MASK(0x1c0000000ull, 0x0ull), PLACEMENT_MASK(0x380000000ull, 0x0ull), PLACEMENT_MASK(0x700000000ull, 0x0ull), PLACEMENT_MASK(0xe00000000ull, 0x0ull), 0, 0},
+    {PLACEMENT_MASK(0x0ull, 0x100401ull), PLACEMENT_MASK(0x0ull, 0x200802ull), PLACEMENT_MASK(0x0ull, 0x401004ull), PLACEMENT_MASK(0x0ull, 0x802008ull), PLACEMENT_MASK(0x0ull, 0x1004010ull), PLACEMENT_MASK(0x0ull, 0x2008020ull), PLACEMENT_MASK(0x0ull, 0x4010040ull), PLACEMENT_MASK(0x0ull, 0x8020080ull), PLACEMENT_MASK(0x0ull, 0x10040100ull), PLACEMENT_MASK(0x0ull, 0x20080200ull), PLACEMENT_MASK(0x0ull, 0x40100400ull), PLACEMENT_MASK(0x0ull, 0x80200800ull), PLACEMENT_MASK(0x0ull, 0x100401000ull), PLACEMENT_MASK(0x0ull, 0x200802000ull), PLACEMENT_MASK(0x0ull, 0x401004000ull), PLACEMENT_MASK(0x0ull, 0x802008000ull), PLACEMENT_MASK(0x0ull, 0x1004010000ull), PLACEMENT_MASK(0x0ull, 0x2008020000ull), PLACEMENT_MASK(0x0ull, 0x4010040000ull), PLACEMENT_MASK(0x0ull, 0x8020080000ull), PLACEMENT_MASK(0x0ull, 0x10040100000ull), PLACEMENT_MASK(0x0ull, 0x20080200000ull), PLACEMENT_MASK(0x0ull, 0x40100400000ull), PLACEMENT_MASK(0x0ull, 0x80200800000ull), PLACEMENT_MASK(0x0ull, 0x100401000000ull), PLACEMENT_MASK(0x0ull, 0x200802000000ull), PLACEMENT_MASK(0x0ull, 0x401004000000ull), PLACEMENT_MASK(0x0ull, 0x802008000000ull), PLACEMENT_MASK(0x0ull, 0x1004010000000ull), PLACEMENT_MASK(0x0ull, 0x2008020000000ull), PLACEMENT_MASK(0x0ull, 0x4010040000000ull), PLACEMENT_MASK(0x0ull, 0x8020080000000ull), PLACEMENT_MASK(0x0ull, 0x10040100000000ull), PLACEMENT_MASK(0x0ull, 0x20080200000000ull), PLACEMENT_MASK(0x0ull, 0x40100400000000ull), PLACEMENT_MASK(0x0ull, 0x80200800000000ull), PLACEMENT_MASK(0x0ull, 0x100401000000000ull), PLACEMENT_MASK(0x0ull, 0x200802000000000ull), PLACEMENT_MASK(0x0ull, 0x401004000000000ull), PLACEMENT_MASK(0x0ull, 0x802008000000000ull), PLACEMENT_MASK(0x0ull, 0x1004010000000000ull), PLACEMENT_MASK(0x0ull, 0x2008020000000000ull), PLACEMENT_MASK(0x0ull, 0x4010040000000000ull), PLACEMENT_MASK(0x0ull, 0x8020080000000000ull), PLACEMENT_MASK(0x1ull, 0x40100000000000ull), PLACEMENT_MASK(0x2ull, 0x80200000000000ull), PLACEMENT_MASK(0x4ull, 0x100400000000000ull), PLACEMENT_MASK(0x8ull, 0x200800000000000ull), PLACEMENT_MASK(0x10ull, 0x401000000000000ull), PLACEMENT_MASK(0x20ull, 0x802000000000000ull), PLACEMENT_MASK(0x40ull, 0x1004000000000000ull), PLACEMENT_MASK(0x80ull, 0x2008000000000000ull), PLACEMENT_MASK(0x100ull, 0x4010000000000000ull), PLACEMENT_MASK(0x200ull, 0x8020000000000000ull), PLACEMENT_MASK(0x401ull, 0x40000000000000ull), PLACEMENT_MASK(0x802ull, 0x80000000000000ull), PLACEMENT_MASK(0x1004ull, 0x100000000000000ull), PLACEMENT_MASK(0x2008ull, 0x200000000000000ull), PLACEMENT_MASK(0x4010ull, 0x400000000000000ull), PLACEMENT_MASK(0x8020ull, 0x800000000000000ull), PLACEMENT_MASK(0x10040ull, 0x1000000000000000ull), PLACEMENT_MASK(0x20080ull, 0x2000000000000000ull), PLACEMENT_MASK(0x40100ull, 0x4000000000000000ull), PLACEMENT_MASK(0x80200ull, 0x8000000000000000ull), PLACEMENT_MASK(0x100401ull, 0x0ull), PLACEMENT_MASK(0x200802ull, 0x0ull), PLACEMENT_MASK(0x401004ull, 0x0ull), PLACEMENT_MASK(0x802008ull, 0x0ull), PLACEMENT_MASK(0x1004010ull, 0x0ull), PLACEMENT_MASK(0x2008020ull, 0x0ull), PLACEMENT_MASK(0x4010040ull, 0x0ull), PLACEMENT_MASK(0x8020080ull, 0x0ull), PLACEMENT_MASK(0x10040100ull, 0x0ull), PLACEMENT_MASK(0x20080200ull, 0x0ull), PLACEMENT_MASK(0x40100400ull, 0x0ull), PLACEMENT_MASK(0x80200800ull, 0x0ull), PLACEMENT_MASK(0x100401000ull, 0x0ull), PLACEMENT_MASK(0x200802000ull, 0x0ull), PLACEMENT_MASK(0x401004000ull, 0x0ull), PLACEMENT_MASK(0x802008000ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+  },
+  { // Size 4
+    {PLACEMENT_MASK(0x0ull, 0xfull), PLACEMENT_MASK(0x0ull, 0x1eull), PLACEMENT_MASK(0x0ull, 0x3cull), PLACEMENT_MASK(0x0ull, 0x78ull), PLACEMENT_MASK(0x0ull, 0xf0ull), PLACEMENT_MASK(0x0ull, 0x1e0ull), PLACEMENT_MASK(0x0ull, 0x3c0ull), 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x3c00ull), PLACEMENT_MASK(0x0ull, 0x7800ull), PLACEMENT_MASK(0x0ull, 0xf000ull), PLACEMENT_MASK(0x0ull, 0x1e000ull), PLACEMENT_MASK(0x0ull, 0x3c000ull), PLACEMENT_MASK(0x0ull, 0x78000ull), PLACEMENT_MASK(0x0ull, 0xf0000ull), 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xf00000ull), PLACEMENT_MASK(0x0ull, 0x1e00000ull), PLACEMENT_MASK(0x0ull, 0x3c00000ull), PLACEMENT_MASK(0x0ull, 0x7800000ull), PLACEMENT_MASK(0x0ull, 0xf000000ull), PLACEMENT_MASK(0x0ull, 0x1e000000ull), PLACEMENT_MASK(0x0ull, 0x3c000000ull), 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x3c0000000ull), PLACEMENT_MASK(0x0ull, 0x780000000ull), PLACEMENT_MASK(0x0ull, 0xf00000000ull), PLACEMENT_MASK(0x0ull, 0x1e00000000ull), PLACEMENT_MASK(0x0ull, 0x3c00000000ull), PLACEMENT_MASK(0x0ull, 0x7800000000ull), PLACEMENT_MASK(0x0ull, 0xf000000000ull), 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xf0000000000ull), PLACEMENT_MASK(0x0ull, 0x1e0000000000ull), PLACEMENT_MASK(0x0ull, 0x3c0000000000ull), PLACEMENT_MASK(0x0ull, 0x780000000000ull), PLACEMENT_MASK(0x0ull, 0xf00000000000ull), PLACEMENT_MASK(0x0ull, 0x1e00000000000ull), PLACEMENT_MASK(0x0ull, 0x3c00000000000ull), 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x3c000000000000ull), PLACEMENT_MASK(0x0ull, 0x78000000000000ull), PLACEMENT_MASK(0x0ull, 0xf0000000000000ull), PLACEMENT_MASK(0x0ull, 0x1e0000000000000ull), PLACEMENT_MASK(0x0ull, 0x3c0000000000000ull), PLACEMENT_MASK(0x0ull, 0x780000000000000ull), PLACEMENT_MASK(0x0ull, 0xf00000000000000ull), 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xf000000000000000ull), PLACEMENT_MASK(0x1ull, 0xe000000000000000ull), PLACEMENT_MASK(0x3ull, 0xc000000000000000ull), PLACEMENT_MASK(0x7ull, 0x8000000000000000ull), PLACEMENT_MASK(0xfull, 0x0ull), PLACEMENT_MASK(0x1eull, 0x0ull), PLACEMENT_MASK(0x3cull, 0x0ull), 0, 0, 0, PLACEMENT_MASK(0x3c0ull, 0x0ull), PLACEMENT_MASK(0x780ull, 0x0ull), PLACEMENT_MASK(0xf00ull, 0x0ull), PLACEMENT_MASK(0x1e00ull, 0x0ull), PLACEMENT_MASK(0x3c00ull, 0x0ull), PLACEMENT_MASK(0x7800ull, 0x0ull), PLACEMENT_MASK(0xf000ull, 0x0ull), 0, 0, 0, PLACEMENT_MASK(0xf0000ull, 0x0ull), PLACEMENT_MASK(0x1e0000ull, 0x0ull), PLACEMENT_MASK(0x3c0000ull, 0x0ull), PLACEMENT_MASK(0x780000ull, 0x0ull), PLACEMENT_MASK(0xf00000ull, 0x0ull), PLACEMENT_MASK(0x1e00000ull, 0x0ull), PLACEMENT_MASK(0x3c00000ull, 0x0ull), 0, 0, 0, PLACEMENT_MASK(0x3c000000ull, 0x0ull), PLACEMENT_MASK(0x78000000ull, 0x0ull), PLACEMENT_MASK(0xf0000000ull, 0x0ull), PLACEMENT_MASK(0x1e0000000ull, 0x0ull), PLACEMENT_MASK(0x3c0000000ull, 0x0ull), PLACEMENT_MASK(0x780000000ull, 0x0ull), PLACEMENT_MASK(0xf00000000ull, 0x0ull), 0, 0, 0},
+    {PLACEMENT_MASK(0x0ull, 0x40100401ull), PLACEMENT_MASK(0x0ull, 0x80200802ull), PLACEMENT_MASK(0x0ull, 0x100401004ull), PLACEMENT_MASK(0x0ull, 0x200802008ull), PLACEMENT_MASK(0x0ull, 0x401004010ull), PLACEMENT_MASK(0x0ull, 0x802008020ull), PLACEMENT_MASK(0x0ull, 0x1004010040ull), PLACEMENT_MASK(0x0ull, 0x2008020080ull), PLACEMENT_MASK(0x0ull, 0x4010040100ull), PLACEMENT_MASK(0x0ull, 0x8020080200ull), PLACEMENT_MASK(0x0ull, 0x10040100400ull), PLACEMENT_MASK(0x0ull, 0x20080200800ull), PLACEMENT_MASK(0x0ull, 0x40100401000ull), PLACEMENT_MASK(0x0ull, 0x80200802000ull), PLACEMENT_MASK(0x0ull, 0x100401004000ull), PLACEMENT_MASK(0x0ull, 0x200802008000ull), PLACEMENT_MASK(0x0ull, 0x401004010000ull), PLACEMENT_MASK(0x0ull, 0x802008020000ull), PLACEMENT_MASK(0x0ull, 0x1004010040000ull), PLACEMENT_MASK(0x0ull, 0x2008020080000ull), PLACEMENT_MASK(0x0ull, 0x4010040100000ull), PLACEMENT_MASK(0x0ull, 0x8020080200000ull), PLACEMENT_MASK(0x0ull, 0x10040100400000ull), PLACEMENT_MASK(0x0ull, 0x20080200800000ull), PLACEMENT_MASK(0x0ull, 0x40100401000000ull), PLACEMENT_MASK(0x0ull, 0x80200802000000ull), PLACEMENT_MASK(0x0ull, 0x100401004000000ull), PLACEMENT_MASK(0x0ull, 0x200802008000000ull), PLACEMENT_MASK(0x0ull, 0x401004010000000ull), PLACEMENT_MASK(0x0ull, 0x802008020000000ull), PLACEMENT_MASK(0x0ull, 0x1004010040000000ull), PLACEMENT_MASK(0x0ull, 0x2008020080000000ull), PLACEMENT_MASK(0x0ull, 0x4010040100000000ull), PLACEMENT_MASK(0x0ull, 0x8020080200000000ull), PLACEMENT_MASK(0x1ull, 0x40100400000000ull), PLACEMENT_MASK(0x2ull, 0x80200800000000ull), PLACEMENT_MASK(0x4ull, 0x100401000000000ull), PLACEMENT_MASK(0x8ull, 0x200802000000000ull), PLACEMENT_MASK(0x10ull, 0x401004000000000ull), PLACEMENT_MASK(0x20ull, 0x802008000000000ull), PLACEMENT_MASK(0x40ull, 0x1004010000000000ull), PLACEMENT_MASK(0x80ull, 0x2008020000000000ull), PLACEMENT_MASK(0x100ull, 0x4010040000000000ull), PLACEMENT_MASK(0x200ull, 0x8020080000000000ull), PLACEMENT_MASK(0x401ull, 0x40100000000000ull), PLACEMENT_MASK(0x802ull, 0x80200000000000ull), PLACEMENT_MASK(0x1004ull, 0x100400000000000ull), PLACEMENT_MASK(0x2008ull, 0x200800000000000ull), PLACEMENT_MASK(0x4010ull, 0x401000000000000ull), PLACEMENT_MASK(0x8020ull, 0x802000000000000ull), PLACEMENT_MASK(0x10040ull, 0x1004000000000000ull), PLACEMENT_MASK(0x20080ull, 0x2008000000000000ull), PLACEMENT_MASK(0x40100ull, 0x4010000000000000ull), PLACEMENT_MASK(0x80200ull, 0x8020000000000000ull), PLACEMENT_MASK(0x100401ull, 0x40000000000000ull), PLACEMENT_MASK(0x200802ull, 0x80000000000000ull), PLACEMENT_MASK(0x401004ull, 0x100000000000000ull), PLACEMENT_MASK(0x802008ull, 0x200000000000000ull), PLACEMENT_MASK(0x1004010ull, 0x400000000000000ull), PLACEMENT_MASK(0x2008020ull, 0x800000000000000ull), PLACEMENT_MASK(0x4010040ull, 0x1000000000000000ull), PLACEMENT_MASK(0x8020080ull, 0x2000000000000000ull), PLACEMENT_MASK(0x10040100ull, 0x4000000000000000ull), PLACEMENT_MASK(0x20080200ull, 0x8000000000000000ull), PLACEMENT_MASK(0x40100401ull, 0x0ull), PLACEMENT_MASK(0x80200802ull, 0x0ull), PLACEMENT_MASK(0x100401004ull, 0x0ull), PLACEMENT_MASK(0x200802008ull, 0x0ull), PLACEMENT_MASK(0x401004010ull, 0x0ull), PLACEMENT_MASK(0x802008020ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+  },
+  { // Size 5
+    {PLACEMENT_MASK(0x0ull, 0x1full), PLACEMENT_MASK(0x0ull, 0x3eull), PLACEMENT_MASK(0x0ull, 0x7cull), PLACEMENT_MASK(0x0ull, 0xf8ull), PLACEMENT_MASK(0x0ull, 0x1f0ull), PLACEMENT_MASK(0x0ull, 0x3e0ull), 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x7c00ull), PLACEMENT_MASK(0x0ull, 0xf800ull), PLACEMENT_MASK(0x0ull, 0x1f000ull), PLACEMENT_MASK(0x0ull, 0x3e000ull), PLACEMENT_MASK(0x0ull, 0x7c000ull), PLACEMENT_MASK(0x0ull, 0xf8000ull), 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x1f00000ull), PLACEMENT_MASK(0x0ull, 0x3e00000ull), PLACEMENT_MASK(0x0ull, 0x7c00000ull), PLACEMENT_MASK(0x0ull, 0xf800000ull), PLACEMENT_MASK(0x0ull, 0x1f000000ull), PLACEMENT_MASK(0x0ull, 0x3e000000ull), 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x7c0000000ull), PLACEMENT_MASK(0x0ull, 0xf80000000ull), PLACEMENT_MASK(0x0ull, 0x1f00000000ull), PLACEMENT_MASK(0x0ull, 0x3e00000000ull), PLACEMENT_MASK(0x0ull, 0x7c00000000ull), PLACEMENT_MASK(0x0ull, 0xf800000000ull), 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x1f0000000000ull), PLACEMENT_MASK(0x0ull, 0x3e0000000000ull), PLACEMENT_MASK(0x0ull, 0x7c0000000000ull), PLACEMENT_MASK(0x0ull, 0xf80000000000ull), PLACEMENT_MASK(0x0ull, 0x1f00000000000ull), PLACEMENT_MASK(0x0ull, 0x3e00000000000ull), 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x7c000000000000ull), PLACEMENT_MASK(0x0ull, 0xf8000000000000ull), PLACEMENT_MASK(0x0ull, 0x1f0000000000000ull), PLACEMENT_MASK(0x0ull, 0x3e0000000000000ull), PLACEMENT_MASK(0x0ull, 0x7c0000000000000ull), PLACEMENT_MASK(0x0ull, 0xf80000000000000ull), 0, 0, 0, 0, PLACEMENT_MASK(0x1ull, 0xf000000000000000ull), PLACEMENT_MASK(0x3ull, 0xe000000000000000ull), PLACEMENT_MASK(0x7ull, 0xc000000000000000ull), PLACEMENT_MASK(0xfull, 0x8000000000000000ull), PLACEMENT_MASK(0x1full, 0x0ull), PLACEMENT_MASK(0x3eull, 0x0ull), 0, 0, 0, 0, PLACEMENT_MASK(0x7c0ull, 0x0ull), PLACEMENT_MASK(0xf80ull, 0x0ull), PLACEMENT_MASK(0x1f00ull, 0x0ull), PLACEMENT_MASK(0x3e00ull, 0x0ull), PLACEMENT_MASK(0x7c00ull, 0x0ull), PLACEMENT_MASK(0xf800ull, 0x0ull), 0, 0, 0, 0, PLACEMENT_MASK(0x1f0000ull, 0x0ull), PLACEMENT_MASK(0x3e0000ull, 0x0ull), PLACEMENT_MASK(0x7c0000ull, 0x0ull), PLACEMENT_MASK(0xf80000ull, 0x0ull), PLACEMENT_MASK(0x1f00000ull, 0x0ull), PLACEMENT_MASK(0x3e00000ull, 0x0ull), 0, 0, 0, 0, PLACEMENT_MASK(0x7c000000ull, 0x0ull), PLACEMENT_MASK(0xf8000000ull, 0x0ull), PLACEMENT_MASK(0x1f0000000ull, 0x0ull), PLACEMENT_MASK(0x3e0000000ull, 0x0ull), PLACEMENT_MASK(0x7c0000000ull, 0x0ull), PLACEMENT_MASK(0xf80000000ull, 0x0ull), 0, 0, 0, 0},
+    {PLACEMENT_MASK(0x0ull, 0x10040100401ull), PLACEMENT_MASK(0x0ull, 0x20080200802ull), PLACEMENT_MASK(0x0ull, 0x40100401004ull), PLACEMENT_MASK(0x0ull, 0x80200802008ull), PLACEMENT_MASK(0x0ull, 0x100401004010ull), PLACEMENT_MASK(0x0ull, 0x200802008020ull), PLACEMENT_MASK(0x0ull, 0x401004010040ull), PLACEMENT_MASK(0x0ull, 0x802008020080ull), PLACEMENT_MASK(0x0ull, 0x1004010040100ull), PLACEMENT_MASK(0x0ull, 0x2008020080200ull), PLACEMENT_MASK(0x0ull, 0x4010040100400ull), PLACEMENT_MASK(0x0ull, 0x8020080200800ull), PLACEMENT_MASK(0x0ull, 0x10040100401000ull), PLACEMENT_MASK(0x0ull, 0x20080200802000ull), PLACEMENT_MASK(0x0ull, 0x40100401004000ull), PLACEMENT_MASK(0x0ull, 0x80200802008000ull), PLACEMENT_MASK(0x0ull, 0x100401004010000ull), PLACEMENT_MASK(0x0ull, 0x200802008020000ull), PLACEMENT_MASK(0x0ull, 0x401004010040000ull), PLACEMENT_MASK(0x0ull, 0x802008020080000ull), PLACEMENT_MASK(0x0ull, 0x1004010040100000ull), PLACEMENT_MASK(0x0ull, 0x2008020080200000ull), PLACEMENT_MASK(0x0ull, 0x4010040100400000ull), PLACEMENT_MASK(0x0ull, 0x8020080200800000ull), PLACEMENT_MASK(0x1ull, 0x40100401000000ull), PLACEMENT_MASK(0x2ull, 0x80200802000000ull), PLACEMENT_MASK(0x4ull, 0x100401004000000ull), PLACEMENT_MASK(0x8ull, 0x200802008000000ull), PLACEMENT_MASK(0x10ull, 0x401004010000000ull), PLACEMENT_MASK(0x20ull, 0x802008020000000ull), PLACEMENT_MASK(0x40ull, 0x1004010040000000ull), PLACEMENT_MASK(0x80ull, 0x2008020080000000ull), PLACEMENT_MASK(0x100ull, 0x4010040100000000ull), PLACEMENT_MASK(0x200ull, 0x8020080200000000ull), PLACEMENT_MASK(0x401ull, 0x40100400000000ull), PLACEMENT_MASK(0x802ull, 0x80200800000000ull), PLACEMENT_MASK(0x1004ull, 0x100401000000000ull), PLACEMENT_MASK(0x2008ull, 0x200802000000000ull), PLACEMENT_MASK(0x4010ull, 0x401004000000000ull), PLACEMENT_MASK(0x8020ull, 0x802008000000000ull), PLACEMENT_MASK(0x10040ull, 0x1004010000000000ull), PLACEMENT_MASK(0x20080ull, 0x2008020000000000ull), PLACEMENT_MASK(0x40100ull, 0x4010040000000000ull), PLACEMENT_MASK(0x80200ull, 0x8020080000000000ull), PLACEMENT_MASK(0x100401ull, 0x40100000000000ull), PLACEMENT_MASK(0x200802ull, 0x80200000000000ull), PLACEMENT_MASK(0x401004ull, 0x100400000000000ull), PLACEMENT_MASK(0x802008ull, 0x200800000000000ull), PLACEMENT_MASK(0x1004010ull, 0x401000000000000ull), PLACEMENT_MASK(0x2008020ull, 0x802000000000000ull), PLACEMENT_MASK(0x4010040ull, 0x1004000000000000ull), PLACEMENT_MASK(0x8020080ull, 0x2008000000000000ull), PLACEMENT_MASK(0x10040100ull, 0x4010000000000000ull), PLACEMENT_MASK(0x20080200ull, 0x8020000000000000ull), PLACEMENT_MASK(0x40100401ull, 0x40000000000000ull), PLACEMENT_MASK(0x80200802ull, 0x80000000000000ull), PLACEMENT_MASK(0x100401004ull, 0x100000000000000ull), PLACEMENT_MASK(0x200802008ull, 0x200000000000000ull), PLACEMENT_MASK(0x401004010ull, 0x400000000000000ull), PLACEMENT_MASK(0x802008020ull, 0x800000000000000ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+  },
+  { // Size 6
+    {PLACEMENT_MASK(0x0ull, 0x3full), PLACEMENT_MASK(0x0ull, 0x7eull), PLACEMENT_MASK(0x0ull, 0xfcull), PLACEMENT_MASK(0x0ull, 0x1f8ull), PLACEMENT_MASK(0x0ull, 0x3f0ull), 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xfc00ull), PLACEMENT_MASK(0x0ull, 0x1f800ull), PLACEMENT_MASK(0x0ull, 0x3f000ull), PLACEMENT_MASK(0x0ull, 0x7e000ull), PLACEMENT_MASK(0x0ull, 0xfc000ull), 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x3f00000ull), PLACEMENT_MASK(0x0ull, 0x7e00000ull), PLACEMENT_MASK(0x0ull, 0xfc00000ull), PLACEMENT_MASK(0x0ull, 0x1f800000ull), PLACEMENT_MASK(0x0ull, 0x3f000000ull), 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xfc0000000ull), PLACEMENT_MASK(0x0ull, 0x1f80000000ull), PLACEMENT_MASK(0x0ull, 0x3f00000000ull), PLACEMENT_MASK(0x0ull, 0x7e00000000ull), PLACEMENT_MASK(0x0ull, 0xfc00000000ull), 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x3f0000000000ull), PLACEMENT_MASK(0x0ull, 0x7e0000000000ull), PLACEMENT_MASK(0x0ull, 0xfc0000000000ull), PLACEMENT_MASK(0x0ull, 0x1f80000000000ull), PLACEMENT_MASK(0x0ull, 0x3f00000000000ull), 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xfc000000000000ull), PLACEMENT_MASK(0x0ull, 0x1f8000000000000ull), PLACEMENT_MASK(0x0ull, 0x3f0000000000000ull), PLACEMENT_MASK(0x0ull, 0x7e0000000000000ull), PLACEMENT_MASK(0x0ull, 0xfc0000000000000ull), 0, 0, 0, 0, 0, PLACEMENT_MASK(0x3ull, 0xf000000000000000ull), PLACEMENT_MASK(0x7ull, 0xe000000000000000ull), PLACEMENT_MASK(0xfull, 0xc000000000000000ull), PLACEMENT_MASK(0x1full, 0x8000000000000000ull), PLACEMENT_MASK(0x3full, 0x0ull), 0, 0, 0, 0, 0, PLACEMENT_MASK(0xfc0ull, 0x0ull), PLACEMENT_MASK(0x1f80ull, 0x0ull), PLACEMENT_MASK(0x3f00ull, 0x0ull), PLACEMENT_MASK(0x7e00ull, 0x0ull), PLACEMENT_MASK(0xfc00ull, 0x0ull), 0, 0, 0, 0, 0, PLACEMENT_MASK(0x3f0000ull, 0x0ull), PLACEMENT_MASK(0x7e0000ull, 0x0ull), PLACEMENT_MASK(0xfc0000ull, 0x0ull), PLACEMENT_MASK(0x1f80000ull, 0x0ull), PLACEMENT_MASK(0x3f00000ull, 0x0ull), 0, 0, 0, 0, 0, PLACEMENT_MASK(0xfc000000ull, 0x0ull), PLACEMENT_MASK(0x1f8000000ull, 0x0ull), PLACEMENT_MASK(0x3f0000000ull, 0x0ull), PLACEMENT_MASK(0x7e0000000ull, 0x0ull), PLACEMENT_MASK(0xfc0000000ull, 0x0ull), 0, 0, 0, 0, 0},
+    {PLACEMENT_MASK(0x0ull, 0x4010040100401ull), PLACEMENT_MASK(0x0ull, 0x8020080200802ull), PLACEMENT_MASK(0x0ull, 0x10040100401004ull), PLACEMENT_MASK(0x0ull, 0x20080200802008ull), PLACEMENT_MASK(0x0ull, 0x40100401004010ull), PLACEMENT_MASK(0x0ull, 0x80200802008020ull), PLACEMENT_MASK(0x0ull, 0x100401004010040ull), PLACEMENT_MASK(0x0ull, 0x200802008020080ull), PLACEMENT_MASK(0x0ull, 0x401004010040100ull), PLACEMENT_MASK(0x0ull, 0x802008020080200ull), PLACEMENT_MASK(0x0ull, 0x1004010040100400ull), PLACEMENT_MASK(0x0ull, 0x2008020080200800ull), PLACEMENT_MASK(0x0ull, 0x4010040100401000ull), PLACEMENT_MASK(0x0ull, 0x8020080200802000ull), PLACEMENT_MASK(0x1ull, 0x40100401004000ull), PLACEMENT_MASK(0x2ull, 0x80200802008000ull), PLACEMENT_MASK(0x4ull, 0x100401004010000ull), PLACEMENT_MASK(0x8ull, 0x200802008020000ull), PLACEMENT_MASK(0x10ull, 0x401004010040000ull), PLACEMENT_MASK(0x20ull, 0x802008020080000ull), PLACEMENT_MASK(0x40ull, 0x1004010040100000ull), PLACEMENT_MASK(0x80ull, 0x2008020080200000ull), PLACEMENT_MASK(0x100ull, 0x4010040100400000ull), PLACEMENT_MASK(0x200ull, 0x8020080200800000ull), PLACEMENT_MASK(0x401ull, 0x40100401000000ull), PLACEMENT_MASK(0x802ull, 0x80200802000000ull), PLACEMENT_MASK(0x1004ull, 0x100401004000000ull), PLACEMENT_MASK(0x2008ull, 0x200802008000000ull), PLACEMENT_MASK(0x4010ull, 0x401004010000000ull), PLACEMENT_MASK(0x8020ull, 0x802008020000000ull), PLACEMENT_MASK(0x10040ull, 0x1004010040000000ull), PLACEMENT_MASK(0x20080ull, 0x2008020080000000ull), PLACEMENT_MASK(0x40100ull, 0x4010040100000000ull), PLACEMENT_MASK(0x80200ull, 0x8020080200000000ull), PLACEMENT_MASK(0x100401ull, 0x40100400000000ull), PLACEMENT_MASK(0x200802ull, 0x80200800000000ull), PLACEMENT_MASK(0x401004ull, 0x100401000000000ull), PLACEMENT_MASK(0x802008ull, 0x200802000000000ull), PLACEMENT_MASK(0x1004010ull, 0x401004000000000ull), PLACEMENT_MASK(0x2008020ull, 0x802008000000000ull), PLACEMENT_MASK(0x4010040ull, 0x1004010000000000ull), PLACEMENT_MASK(0x8020080ull, 0x2008020000000000ull), PLACEMENT_MASK(0x10040100ull, 0x4010040000000000ull), PLACEMENT_MASK(0x20080200ull, 0x8020080000000000ull), PLACEMENT_MASK(0x40100401ull, 0x40100000000000ull), PLACEMENT_MASK(0x80200802ull, 0x80200000000000ull), PLACEMENT_MASK(0x100401004ull, 0x100400000000000ull), PLACEMENT_MASK(0x200802008ull, 0x200800000000000ull), PLACEMENT_MASK(0x401004010ull, 0x401000000000000ull), PLACEMENT_MASK(0x802008020ull, 0x802000000000000ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+  },
+  { // Size 7
+    {PLACEMENT_MASK(0x0ull, 0x7full), PLACEMENT_MASK(0x0ull, 0xfeull), PLACEMENT_MASK(0x0ull, 0x1fcull), PLACEMENT_MASK(0x0ull, 0x3f8ull), 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x1fc00ull), PLACEMENT_MASK(0x0ull, 0x3f800ull), PLACEMENT_MASK(0x0ull, 0x7f000ull), PLACEMENT_MASK(0x0ull, 0xfe000ull), 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x7f00000ull), PLACEMENT_MASK(0x0ull, 0xfe00000ull), PLACEMENT_MASK(0x0ull, 0x1fc00000ull), PLACEMENT_MASK(0x0ull, 0x3f800000ull), 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x1fc0000000ull), PLACEMENT_MASK(0x0ull, 0x3f80000000ull), PLACEMENT_MASK(0x0ull, 0x7f00000000ull), PLACEMENT_MASK(0x0ull, 0xfe00000000ull), 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x7f0000000000ull), PLACEMENT_MASK(0x0ull, 0xfe0000000000ull), PLACEMENT_MASK(0x0ull, 0x1fc0000000000ull), PLACEMENT_MASK(0x0ull, 0x3f80000000000ull), 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x1fc000000000000ull), PLACEMENT_MASK(0x0ull, 0x3f8000000000000ull), PLACEMENT_MASK(0x0ull, 0x7f0000000000000ull), PLACEMENT_MASK(0x0ull, 0xfe0000000000000ull), 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x7ull, 0xf000000000000000ull), PLACEMENT_MASK(0xfull, 0xe000000000000000ull), PLACEMENT_MASK(0x1full, 0xc000000000000000ull), PLACEMENT_MASK(0x3full, 0x8000000000000000ull), 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x1fc0ull, 0x0ull), PLACEMENT_MASK(0x3f80ull, 0x0ull), PLACEMENT_MASK(0x7f00ull, 0x0ull), PLACEMENT_MASK(0xfe00ull, 0x0ull), 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x7f0000ull, 0x0ull), PLACEMENT_MASK(0xfe0000ull, 0x0ull), PLACEMENT_MASK(0x1fc0000ull, 0x0ull), PLACEMENT_MASK(0x3f80000ull, 0x0ull), 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x1fc000000ull, 0x0ull), PLACEMENT_MASK(0x3f8000000ull, 0x0ull), PLACEMENT_MASK(0x7f0000000ull, 0x0ull), PLACEMENT_MASK(0xfe0000000ull, 0x0ull), 0, 0, 0, 0, 0, 0},
+    {PLACEMENT_MASK(0x0ull, 0x1004010040100401ull), PLACEMENT_MASK(0x0ull, 0x2008020080200802ull), PLACEMENT_MASK(0x0ull, 0x4010040100401004ull), PLACEMENT_MASK(0x0ull, 0x8020080200802008ull), PLACEMENT_MASK(0x1ull, 0x40100401004010ull), PLACEMENT_MASK(0x2ull, 0x80200802008020ull), PLACEMENT_MASK(0x4ull, 0x100401004010040ull), PLACEMENT_MASK(0x8ull, 0x200802008020080ull), PLACEMENT_MASK(0x10ull, 0x401004010040100ull), PLACEMENT_MASK(0x20ull, 0x802008020080200ull), PLACEMENT_MASK(0x40ull, 0x1004010040100400ull), PLACEMENT_MASK(0x80ull, 0x2008020080200800ull), PLACEMENT_MASK(0x100ull, 0x4010040100401000ull), PLACEMENT_MASK(0x200ull, 0x8020080200802000ull), PLACEMENT_MASK(0x401ull, 0x40100401004000ull), PLACEMENT_MASK(0x802ull, 0x80200802008000ull), PLACEMENT_MASK(0x1004ull, 0x100401004010000ull), PLACEMENT_MASK(0x2008ull, 0x200802008020000ull), PLACEMENT_MASK(0x4010ull, 0x401004010040000ull), PLACEMENT_MASK(0x8020ull, 0x802008020080000ull), PLACEMENT_MASK(0x10040ull, 0x1004010040100000ull), PLACEMENT_MASK(0x20080ull, 0x2008020080200000ull), PLACEMENT_MASK(0x40100ull, 0x4010040100400000ull), PLACEMENT_MASK(0x80200ull, 0x8020080200800000ull), PLACEMENT_MASK(0x100401ull, 0x40100401000000ull), PLACEMENT_MASK(0x200802ull, 0x80200802000000ull), PLACEMENT_MASK(0x401004ull, 0x100401004000000ull), PLACEMENT_MASK(0x802008ull, 0x200802008000000ull), PLACEMENT_MASK(0x1004010ull, 0x401004010000000ull), PLACEMENT_MASK(0x2008020ull, 0x802008020000000ull), PLACEMENT_MASK(0x4010040ull, 0x1004010040000000ull), PLACEMENT_MASK(0x8020080ull, 0x2008020080000000ull), PLACEMENT_MASK(0x10040100ull, 0x4010040100000000ull), PLACEMENT_MASK(0x20080200ull, 0x8020080200000000ull), PLACEMENT_MASK(0x40100401ull, 0x40100400000000ull), PLACEMENT_MASK(0x80200802ull, 0x80200800000000ull), PLACEMENT_MASK(0x100401004ull, 0x100401000000000ull), PLACEMENT_MASK(0x200802008ull, 0x200802000000000ull), PLACEMENT_MASK(0x401004010ull, 0x401004000000000ull), PLACEMENT_MASK(0x802008020ull, 0x802008000000000ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+  },
+  { // Size 8
+    {PLACEMENT_MASK(0x0ull, 0xffull), PLACEMENT_MASK(0x0ull, 0x1feull), PLACEMENT_MASK(0x0ull, 0x3fcull), 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x3fc00ull), PLACEMENT_MASK(0x0ull, 0x7f800ull), PLACEMENT_MASK(0x0ull, 0xff000ull), 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xff00000ull), PLACEMENT_MASK(0x0ull, 0x1fe00000ull), PLACEMENT_MASK(0x0ull, 0x3fc00000ull), 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x3fc0000000ull), PLACEMENT_MASK(0x0ull, 0x7f80000000ull), PLACEMENT_MASK(0x0ull, 0xff00000000ull), 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xff0000000000ull), PLACEMENT_MASK(0x0ull, 0x1fe0000000000ull), PLACEMENT_MASK(0x0ull, 0x3fc0000000000ull), 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x3fc000000000000ull), PLACEMENT_MASK(0x0ull, 0x7f8000000000000ull), PLACEMENT_MASK(0x0ull, 0xff0000000000000ull), 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0xfull, 0xf000000000000000ull), PLACEMENT_MASK(0x1full, 0xe000000000000000ull), PLACEMENT_MASK(0x3full, 0xc000000000000000ull), 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x3fc0ull, 0x0ull), PLACEMENT_MASK(0x7f80ull, 0x0ull), PLACEMENT_MASK(0xff00ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0xff0000ull, 0x0ull), PLACEMENT_MASK(0x1fe0000ull, 0x0ull), PLACEMENT_MASK(0x3fc0000ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x3fc000000ull, 0x0ull), PLACEMENT_MASK(0x7f8000000ull, 0x0ull), PLACEMENT_MASK(0xff0000000ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0},
+    {PLACEMENT_MASK(0x40ull, 0x1004010040100401ull), PLACEMENT_MASK(0x80ull, 0x2008020080200802ull), PLACEMENT_MASK(0x100ull, 0x4010040100401004ull), PLACEMENT_MASK(0x200ull, 0x8020080200802008ull), PLACEMENT_MASK(0x401ull, 0x40100401004010ull), PLACEMENT_MASK(0x802ull, 0x80200802008020ull), PLACEMENT_MASK(0x1004ull, 0x100401004010040ull), PLACEMENT_MASK(0x2008ull, 0x200802008020080ull), PLACEMENT_MASK(0x4010ull, 0x401004010040100ull), PLACEMENT_MASK(0x8020ull, 0x802008020080200ull), PLACEMENT_MASK(0x10040ull, 0x1004010040100400ull), PLACEMENT_MASK(0x20080ull, 0x2008020080200800ull), PLACEMENT_MASK(0x40100ull, 0x4010040100401000ull), PLACEMENT_MASK(0x80200ull, 0x8020080200802000ull), PLACEMENT_MASK(0x100401ull, 0x40100401004000ull), PLACEMENT_MASK(0x200802ull, 0x80200802008000ull), PLACEMENT_MASK(0x401004ull, 0x100401004010000ull), PLACEMENT_MASK(0x802008ull, 0x200802008020000ull), PLACEMENT_MASK(0x1004010ull, 0x401004010040000ull), PLACEMENT_MASK(0x2008020ull, 0x802008020080000ull), PLACEMENT_MASK(0x4010040ull, 0x1004010040100000ull), PLACEMENT_MASK(0x8020080ull, 0x2008020080200000ull), PLACEMENT_MASK(0x10040100ull, 0x4010040100400000ull), PLACEMENT_MASK(0x20080200ull, 0x8020080200800000ull), PLACEMENT_MASK(0x40100401ull, 0x40100401000000ull), PLACEMENT_MASK(0x80200802ull, 0x80200802000000ull), PLACEMENT_MASK(0x100401004ull, 0x100401004000000ull), PLACEMENT_MASK(0x200802008ull, 0x200802008000000ull), PLACEMENT_MASK(0x401004010ull, 0x401004010000000ull), PLACEMENT_MASK(0x802008020ull, 0x802008020000000ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+  },
+  { // Size 9
+    {PLACEMENT_MASK(0x0ull, 0x1ffull), PLACEMENT_MASK(0x0ull, 0x3feull), 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x7fc00ull), PLACEMENT_MASK(0x0ull, 0xff800ull), 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x1ff00000ull), PLACEMENT_MASK(0x0ull, 0x3fe00000ull), 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x7fc0000000ull), PLACEMENT_MASK(0x0ull, 0xff80000000ull), 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x1ff0000000000ull), PLACEMENT_MASK(0x0ull, 0x3fe0000000000ull), 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x7fc000000000000ull), PLACEMENT_MASK(0x0ull, 0xff8000000000000ull), 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x1full, 0xf000000000000000ull), PLACEMENT_MASK(0x3full, 0xe000000000000000ull), 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x7fc0ull, 0x0ull), PLACEMENT_MASK(0xff80ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x1ff0000ull, 0x0ull), PLACEMENT_MASK(0x3fe0000ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x7fc000000ull, 0x0ull), PLACEMENT_MASK(0xff8000000ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, 0},
+    {PLACEMENT_MASK(0x10040ull, 0x1004010040100401ull), PLACEMENT_MASK(0x20080ull, 0x2008020080200802ull), PLACEMENT_MASK(0x40100ull, 0x4010040100401004ull), PLACEMENT_MASK(0x80200ull, 0x8020080200802008ull), PLACEMENT_MASK(0x100401ull, 0x40100401004010ull), PLACEMENT_MASK(0x200802ull, 0x80200802008020ull), PLACEMENT_MASK(0x401004ull, 0x100401004010040ull), PLACEMENT_MASK(0x802008ull, 0x200802008020080ull), PLACEMENT_MASK(0x1004010ull, 0x401004010040100ull), PLACEMENT_MASK(0x2008020ull, 0x802008020080200ull), PLACEMENT_MASK(0x4010040ull, 0x1004010040100400ull), PLACEMENT_MASK(0x8020080ull, 0x2008020080200800ull), PLACEMENT_MASK(0x10040100ull, 0x4010040100401000ull), PLACEMENT_MASK(0x20080200ull, 0x8020080200802000ull), PLACEMENT_MASK(0x40100401ull, 0x40100401004000ull), PLACEMENT_MASK(0x80200802ull, 0x80200802008000ull), PLACEMENT_MASK(0x100401004ull, 0x100401004010000ull), PLACEMENT_MASK(0x200802008ull, 0x200802008020000ull), PLACEMENT_MASK(0x401004010ull, 0x401004010040000ull), PLACEMENT_MASK(0x802008020ull, 0x802008020080000ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+  },
+  { // Size 10
+    {PLACEMENT_MASK(0x0ull, 0x3ffull), 0, 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xffc00ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x3ff00000ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xffc0000000ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0x3ff0000000000ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x0ull, 0xffc000000000000ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x3full, 0xf000000000000000ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0xffc0ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0x3ff0000ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, PLACEMENT_MASK(0xffc000000ull, 0x0ull), 0, 0, 0, 0, 0, 0, 0, 0, 0},
+    {PLACEMENT_MASK(0x4010040ull, 0x1004010040100401ull), PLACEMENT_MASK(0x8020080ull, 0x2008020080200802ull), PLACEMENT_MASK(0x10040100ull, 0x4010040100401004ull), PLACEMENT_MASK(0x20080200ull, 0x8020080200802008ull), PLACEMENT_MASK(0x40100401ull, 0x40100401004010ull), PLACEMENT_MASK(0x80200802ull, 0x80200802008020ull), PLACEMENT_MASK(0x100401004ull, 0x100401004010040ull), PLACEMENT_MASK(0x200802008ull, 0x200802008020080ull), PLACEMENT_MASK(0x401004010ull, 0x401004010040100ull), PLACEMENT_MASK(0x802008020ull, 0x802008020080200ull), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0},
+  },
+};
+
+// Legal top-left cells by size and orientation.
+static const BoardMask placement_starts[PLACEMENT_MAX_SIZE + 1][2] = {
+  {0, 0},
+  {PLACEMENT_MASK(0xfffffffffull, 0xffffffffffffffffull), PLACEMENT_MASK(0xfffffffffull, 0xffffffffffffffffull)},
+  {PLACEMENT_MASK(0x7fdff7fdfull, 0xf7fdff7fdff7fdffull), PLACEMENT_MASK(0x3ffffffull, 0xffffffffffffffffull)},
+  {PLACEMENT_MASK(0x3fcff3fcfull, 0xf3fcff3fcff3fcffull), PLACEMENT_MASK(0xffffull, 0xffffffffffffffffull)},
+  {PLACEMENT_MASK(0x1fc7f1fc7ull, 0xf1fc7f1fc7f1fc7full), PLACEMENT_MASK(0x3full, 0xffffffffffffffffull)},
+  {PLACEMENT_MASK(0xfc3f0fc3ull, 0xf0fc3f0fc3f0fc3full), PLACEMENT_MASK(0x0ull, 0xfffffffffffffffull)},
+  {PLACEMENT_MASK(0x7c1f07c1ull, 0xf07c1f07c1f07c1full), PLACEMENT_MASK(0x0ull, 0x3ffffffffffffull)},
+  {PLACEMENT_MASK(0x3c0f03c0ull, 0xf03c0f03c0f03c0full), PLACEMENT_MASK(0x0ull, 0xffffffffffull)},
+  {PLACEMENT_MASK(0x1c0701c0ull, 0x701c0701c0701c07ull), PLACEMENT_MASK(0x0ull, 0x3fffffffull)},
+  {PLACEMENT_MASK(0xc0300c0ull, 0x300c0300c0300c03ull), PLACEMENT_MASK(0x0ull, 0xfffffull)},
+  {PLACEMENT_MASK(0x4010040ull, 0x1004010040100401ull), PLACEMENT_MASK(0x0ull, 0x3ffull)},
+};
+
+// Legal placements of size s are placement_list[placement_first[s]]
+// up to placement_list[placement_first[s + 1]], each the top-left cell
+// index shifted left by one, or'd with 1 when vertical.
+static const uint16_t placement_first[PLACEMENT_MAX_SIZE + 2] = {0, 0, 200, 380, 540, 680, 800, 900, 980, 1040, 1080, 1100};
+
+static const uint16_t placement_list[1100] = {
+  0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30,
+  32, 34, 36, 38, 40, 42, 44, 46, 48, 50, 52, 54, 56, 58, 60, 62,
+  64, 66, 68, 70, 72, 74, 76, 78, 80, 82, 84, 86, 88, 90, 92, 94,
+  96, 98, 100, 102, 104, 106, 108, 110, 112, 114, 116, 118, 120, 122, 124, 126,
+  128, 130, 132, 134, 136, 138, 140, 142, 144, 146, 148, 150, 152, 154, 156, 158,
+  160, 162, 164, 166, 168, 170, 172, 174, 176, 178, 180, 182, 184, 186, 188, 190,
+  192, 194, 196, 198, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23,
+  25, 27, 29, 31, 33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55,
+  57, 59, 61, 63, 65, 67, 69, 71, 73, 75, 77, 79, 81, 83, 85, 87,
+  89, 91, 93, 95, 97, 99, 101, 103, 105, 107, 109, 111, 113, 115, 117, 119,
+  121, 123, 125, 127, 129, 131, 133, 135, 137, 139, 141, 143, 145, 147, 149, 151,
+  153, 155, 157, 159, 161, 163, 165, 167, 169, 171, 173, 175, 177, 179, 181, 183,
+  185, 187, 189, 191, 193, 195, 197, 199, 0, 2, 4, 6, 8, 10, 12, 14,
+  16, 20, 22, 24, 26, 28, 30, 32, 34, 36, 40, 42, 44, 46, 48, 50,
+  52, 54, 56, 60, 62, 64, 66, 68, 70, 72, 74, 76, 80, 82, 84, 86,
+  88, 90, 92, 94, 96, 100, 102, 104, 106, 108, 110, 112, 114, 116, 120, 122,
+  124, 126, 128, 130, 132, 134, 136, 140, 142, 144, 146, 148, 150, 152, 154, 156,
+  160, 162, 164, 166, 168, 170, 172, 174, 176, 180, 182, 184, 186, 188, 190, 192,
+  194, 196, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27,
+  29, 31, 33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55, 57, 59,
+  61, 63, 65, 67, 69, 71, 73, 75, 77, 79, 81, 83, 85, 87, 89, 91,
+  93, 95, 97, 99, 101, 103, 105, 107, 109, 111, 113, 115, 117, 119, 121, 123,
+  125, 127, 129, 131, 133, 135, 137, 139, 141, 143, 145, 147, 149, 151, 153, 155,
+  157, 159, 161, 163, 165, 167, 169, 171, 173, 175, 177, 179, 0, 2, 4, 6,
+  8, 10, 12, 14, 20, 22, 24, 26, 28, 30, 32, 34, 40, 42, 44, 46,
+  48, 50, 52, 54, 60, 62, 64, 66, 68, 70, 72, 74, 80, 82, 84, 86,
+  88, 90, 92, 94, 100, 102, 104, 106, 108, 110, 112, 114, 120, 122, 124, 126,
+  128, 130, 132, 134, 140, 142, 144, 146, 148, 150, 152, 154, 160, 162, 164, 166,
+  168, 170, 172, 174, 180, 182, 184, 186, 188, 190, 192, 194, 1, 3, 5, 7,
+  9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31, 33, 35, 37, 39,
+  41, 43, 45, 47, 49, 51, 53, 55, 57, 59, 61, 63, 65, 67, 69, 71,
+  73, 75, 77, 79, 81, 83, 85, 87, 89, 91, 93, 95, 97, 99, 101, 103,
+  105, 107, 109, 111, 113, 115, 117, 119, 121, 123, 125, 127, 129, 131, 133, 135,
+  137, 139, 141, 143, 145, 147, 149, 151, 153, 155, 157, 159, 0, 2, 4, 6,
+  8, 10, 12, 20, 22, 24, 26, 28, 30, 32, 40, 42, 44, 46, 48, 50,
+  52, 60, 62, 64, 66, 68, 70, 72, 80, 82, 84, 86, 88, 90, 92, 100,
+  102, 104, 106, 108, 110, 112, 120, 122, 124, 126, 128, 130, 132, 140, 142, 144,
+  146, 148, 150, 152, 160, 162, 164, 166, 168, 170, 172, 180, 182, 184, 186, 188,
+  190, 192, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27,
+  29, 31, 33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55, 57, 59,
+  61, 63, 65, 67, 69, 71, 73, 75, 77, 79, 81, 83, 85, 87, 89, 91,
+  93, 95, 97, 99, 101, 103, 105, 107, 109, 111, 113, 115, 117, 119, 121, 123,
+  125, 127, 129, 131, 133, 135, 137, 139, 0, 2, 4, 6, 8, 10, 20, 22,
+  24, 26, 28, 30, 40, 42, 44, 46, 48, 50, 60, 62, 64, 66, 68, 70,
+  80, 82, 84, 86, 88, 90, 100, 102, 104, 106, 108, 110, 120, 122, 124, 126,
+  128, 130, 140, 142, 144, 146, 148, 150, 160, 162, 164, 166, 168, 170, 180, 182,
+  184, 186, 188, 190, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23,
+  25, 27, 29, 31, 33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55,
+  57, 59, 61, 63, 65, 67, 69, 71, 73, 75, 77, 79, 81, 83, 85, 87,
+  89, 91, 93, 95, 97, 99, 101, 103, 105, 107, 109, 111, 113, 115, 117, 119,
+  0, 2, 4, 6, 8, 20, 22, 24, 26, 28, 40, 42, 44, 46, 48, 60,
+  62, 64, 66, 68, 80, 82, 84, 86, 88, 100, 102, 104, 106, 108, 120, 122,
+  124, 126, 128, 140, 142, 144, 146, 148, 160, 162, 164, 166, 168, 180, 182, 184,
+  186, 188, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27,
+  29, 31, 33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55, 57, 59,
+  61, 63, 65, 67, 69, 71, 73, 75, 77, 79, 81, 83, 85, 87, 89, 91,
+  93, 95, 97, 99, 0, 2, 4, 6, 20, 22, 24, 26, 40, 42, 44, 46,
+  60, 62, 64, 66, 80, 82, 84, 86, 100, 102, 104, 106, 120, 122, 124, 126,
+  140, 142, 144, 146, 160, 162, 164, 166, 180, 182, 184, 186, 1, 3, 5, 7,
+  9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31, 33, 35, 37, 39,
+  41, 43, 45, 47, 49, 51, 53, 55, 57, 59, 61, 63, 65, 67, 69, 71,
+  73, 75, 77, 79, 0, 2, 4, 20, 22, 24, 40, 42, 44, 60, 62, 64,
+  80, 82, 84, 100, 102, 104, 120, 122, 124, 140, 142, 144, 160, 162, 164, 180,
+  182, 184, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27,
+  29, 31, 33, 35, 37, 39, 41, 43, 45, 47, 49, 51, 53, 55, 57, 59,
+  0, 2, 20, 22, 40, 42, 60, 62, 80, 82, 100, 102, 120, 122, 140, 142,
+  160, 162, 180, 182, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23,
+  25, 27, 29, 31, 33, 35, 37, 39, 0, 20, 40, 60, 80, 100, 120, 140,
+  160, 180, 1, 3, 5, 7, 9, 11, 13, 15, 17, 19
+};
+
+#endif // PLACEMENT_TABLE_H
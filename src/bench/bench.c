@@ -0,0 +1,335 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "../common/common.h"
+#include "../common/game_logic.h"
+#include "../common/rng.h"
+#include "../common/ai.h"
+
+// Microbenchmarks for game_logic.c. Each case runs over a pool of randomized
+// boards so results are not dominated by a single, perfectly cached layout.
+// Human-readable results go to stdout, tab-separated results to the output
+// file so runs from different commits can be diffed or plotted.
+
+#ifdef BITBOARD_ENGINE
+#define ENGINE_NAME "bitboard"
+#else
+#define ENGINE_NAME "grid"
+#endif
+
+#ifndef BENCH_COMMIT
+#define BENCH_COMMIT "unknown"
+#endif
+
+#define BOARD_POOL 4096
+#define CANDIDATE_POOL 8192
+
+typedef struct {
+  const char *name;
+  long ops;
+  double ns;
+  double cycles;
+} BenchResult;
+
+static volatile long sink; // Keeps results observable so loops are not optimised away
+static uint64_t rng_state;
+
+static PlayerBoard empty_boards[BOARD_POOL];
+static PlayerBoard fleet_boards[BOARD_POOL];  // Fully placed, no shots yet
+static Ship fleets[BOARD_POOL][NUM_SHIPS];    // The placements behind fleet_boards
+static Ship candidates[CANDIDATE_POOL];       // Random, possibly invalid placements
+static unsigned char shot_orders[BOARD_POOL][BOARD_ROWS * BOARD_COLS];
+
+static double now_ns(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static unsigned long long cycles_now(void){
+#ifdef HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static void random_fleet(PlayerBoard *board, Ship *placed){
+  init_board(board);
+  for(int i = 0; i < NUM_SHIPS; i++){
+    Ship ship = board->ships[i];
+    do{
+      ship.row = (int)rng_below(&rng_state, BOARD_ROWS);
+      ship.col = (int)rng_below(&rng_state, BOARD_COLS);
+      ship.orientation = rng_below(&rng_state, 2) ? VERTICAL : HORIZONTAL;
+    } while(!can_place_ship(board, &ship));
+    place_ship(board, &ship);
+    placed[i] = ship;
+  }
+}
+
+static void shuffled_cells(unsigned char *order){
+  for(int i = 0; i < BOARD_ROWS * BOARD_COLS; i++)
+    order[i] = (unsigned char)i;
+  for(int i = BOARD_ROWS * BOARD_COLS - 1; i > 0; i--){
+    int j = (int)rng_below(&rng_state, (uint32_t)i + 1);
+    unsigned char tmp = order[i];
+    order[i] = order[j];
+    order[j] = tmp;
+  }
+}
+
+static void prepare_pools(void){
+  for(int i = 0; i < BOARD_POOL; i++){
+    init_board(&empty_boards[i]);
+    random_fleet(&fleet_boards[i], fleets[i]);
+    shuffled_cells(shot_orders[i]);
+  }
+  for(int i = 0; i < CANDIDATE_POOL; i++){
+    ShipType type = (ShipType)rng_below(&rng_state, NUM_SHIPS);
+    candidates[i] = (Ship){
+      .type = type,
+      .size = get_ship_size(type),
+      .row = (int)rng_below(&rng_state, BOARD_ROWS),
+      .col = (int)rng_below(&rng_state, BOARD_COLS),
+      .orientation = rng_below(&rng_state, 2) ? VERTICAL : HORIZONTAL,
+      .hits = 0,
+      .is_placed = 0
+    };
+  }
+}
+
+static BenchResult bench_init_board(long iterations){
+  static PlayerBoard boards[BOARD_POOL];
+  unsigned long long c0 = cycles_now();
+  double t0 = now_ns();
+  for(long i = 0; i < iterations; i++)
+    init_board(&boards[i & (BOARD_POOL - 1)]);
+  double t1 = now_ns();
+  unsigned long long c1 = cycles_now();
+  sink += boards[0].ships_remaining;
+  return (BenchResult){"init_board", iterations, t1 - t0, (double)(c1 - c0)};
+}
+
+static BenchResult bench_can_place_ship(long iterations){
+  long ok = 0;
+  unsigned long long c0 = cycles_now();
+  double t0 = now_ns();
+  for(long i = 0; i < iterations; i++)
+    ok += can_place_ship(&fleet_boards[i & (BOARD_POOL - 1)], &candidates[i & (CANDIDATE_POOL - 1)]);
+  double t1 = now_ns();
+  unsigned long long c1 = cycles_now();
+  sink += ok;
+  return (BenchResult){"can_place_ship", iterations, t1 - t0, (double)(c1 - c0)};
+}
+
+// Boards are reset in batches outside the timed region, then a whole fleet
+// is placed on each board of the batch.
+static BenchResult bench_place_ship(long iterations){
+  static PlayerBoard batch[BOARD_POOL];
+  BenchResult result = {"place_ship", 0, 0.0, 0.0};
+  for(long done = 0; done < iterations; done += (long)BOARD_POOL * NUM_SHIPS){
+    memcpy(batch, empty_boards, sizeof(batch));
+    unsigned long long c0 = cycles_now();
+    double t0 = now_ns();
+    for(int b = 0; b < BOARD_POOL; b++){
+      for(int s = 0; s < NUM_SHIPS; s++)
+        place_ship(&batch[b], &fleets[b][s]);
+    }
+    double t1 = now_ns();
+    unsigned long long c1 = cycles_now();
+    result.ns += t1 - t0;
+    result.cycles += (double)(c1 - c0);
+    result.ops += (long)BOARD_POOL * NUM_SHIPS;
+    sink += batch[0].ships[0].is_placed;
+  }
+  return result;
+}
+
+// Every cell of every board in the batch is shot once, in random order.
+static BenchResult bench_take_shot(long iterations){
+  static PlayerBoard batch[BOARD_POOL];
+  BenchResult result = {"take_shot", 0, 0.0, 0.0};
+  const long per_batch = (long)BOARD_POOL * BOARD_ROWS * BOARD_COLS;
+  for(long done = 0; done < iterations; done += per_batch){
+    memcpy(batch, fleet_boards, sizeof(batch));
+    long hits = 0;
+    unsigned long long c0 = cycles_now();
+    double t0 = now_ns();
+    for(int b = 0; b < BOARD_POOL; b++){
+      for(int k = 0; k < BOARD_ROWS * BOARD_COLS; k++){
+        int cell = shot_orders[b][k];
+        int is_hit, is_sunk;
+        ShipType sunk_type;
+        hits += take_shot(&batch[b], cell / BOARD_COLS, cell % BOARD_COLS, &is_hit, &is_sunk, &sunk_type);
+      }
+    }
+    double t1 = now_ns();
+    unsigned long long c1 = cycles_now();
+    result.ns += t1 - t0;
+    result.cycles += (double)(c1 - c0);
+    result.ops += per_batch;
+    sink += hits;
+  }
+  return result;
+}
+
+static BenchResult bench_check_game_over(long iterations){
+  static PlayerBoard boards[BOARD_POOL];
+  // Boards at random points of a game, some finished, most not
+  for(int b = 0; b < BOARD_POOL; b++){
+    boards[b] = fleet_boards[b];
+    int shots = (int)rng_below(&rng_state, BOARD_ROWS * BOARD_COLS + 1);
+    for(int k = 0; k < shots; k++){
+      int cell = shot_orders[b][k];
+      int is_hit, is_sunk;
+      take_shot(&boards[b], cell / BOARD_COLS, cell % BOARD_COLS, &is_hit, &is_sunk, NULL);
+    }
+  }
+  long over = 0;
+  unsigned long long c0 = cycles_now();
+  double t0 = now_ns();
+  for(long i = 0; i < iterations; i++)
+    over += check_game_over(&boards[i & (BOARD_POOL - 1)]);
+  double t1 = now_ns();
+  unsigned long long c1 = cycles_now();
+  sink += over;
+  return (BenchResult){"check_game_over", iterations, t1 - t0, (double)(c1 - c0)};
+}
+
+// One computer move from a random point of a game, fed by real shot results.
+static BenchResult bench_ai_choose_shot(long iterations){
+  static AiPlayer states[BOARD_POOL / 4];
+  const int pool = BOARD_POOL / 4;
+  for(int b = 0; b < pool; b++){
+    PlayerBoard board = fleet_boards[b];
+    ai_init(&states[b], (uint64_t)b + 1);
+    int shots = (int)rng_below(&rng_state, 60);
+    for(int k = 0; k < shots; k++){
+      int row, col, is_hit, is_sunk;
+      ShipType sunk_type;
+      ai_choose_shot(&states[b], &row, &col);
+      take_shot(&board, row, col, &is_hit, &is_sunk, &sunk_type);
+      ai_observe(&states[b], row, col, is_hit, sunk_type);
+    }
+  }
+  long acc = 0;
+  unsigned long long c0 = cycles_now();
+  double t0 = now_ns();
+  for(long i = 0; i < iterations; i++){
+    int row, col;
+    ai_choose_shot(&states[i % pool], &row, &col);
+    acc += row * BOARD_COLS + col;
+  }
+  double t1 = now_ns();
+  unsigned long long c1 = cycles_now();
+  sink += acc;
+  return (BenchResult){"ai_choose_shot", iterations, t1 - t0, (double)(c1 - c0)};
+}
+
+// End-to-end game: both fleets placed at random, then alternating random
+// shots until one side is sunk. One op is one complete game.
+static BenchResult bench_full_game(long games){
+  long total_shots = 0;
+  unsigned long long c0 = cycles_now();
+  double t0 = now_ns();
+  for(long g = 0; g < games; g++){
+    PlayerBoard boards[2];
+    Ship placed[NUM_SHIPS];
+    unsigned char order[2][BOARD_ROWS * BOARD_COLS];
+    int next[2] = {0, 0};
+    random_fleet(&boards[0], placed);
+    random_fleet(&boards[1], placed);
+    shuffled_cells(order[0]);
+    shuffled_cells(order[1]);
+    int turn = 0;
+    for(;;){
+      int target = 1 - turn;
+      int cell = order[turn][next[turn]++];
+      int is_hit, is_sunk;
+      take_shot(&boards[target], cell / BOARD_COLS, cell % BOARD_COLS, &is_hit, &is_sunk, NULL);
+      total_shots++;
+      if(check_game_over(&boards[target]))
+        break;
+      turn = target;
+    }
+  }
+  double t1 = now_ns();
+  unsigned long long c1 = cycles_now();
+  sink += total_shots;
+  return (BenchResult){"full_game", games, t1 - t0, (double)(c1 - c0)};
+}
+
+static void report(FILE *out, const BenchResult *r){
+  double ns_per_op = r->ns / (double)r->ops;
+  double ops_per_sec = (double)r->ops * 1e9 / r->ns;
+  double cycles_per_op = r->cycles / (double)r->ops;
+  printf("%-16s %12ld %12.2f %16.0f %12.1f\n", r->name, r->ops, ns_per_op, ops_per_sec, cycles_per_op);
+  if(out != NULL)
+    fprintf(out, "%s\t%s\t%s\t%ld\t%.3f\t%.0f\t%.1f\n", BENCH_COMMIT, ENGINE_NAME, r->name, r->ops, ns_per_op, ops_per_sec, cycles_per_op);
+}
+
+int main(int argc, char *argv[]){
+  long iterations = 1L << 24;
+  long games = 1L << 18;
+  const char *output_path = "bench_output.txt";
+  uint64_t seed = 42;
+
+  int opt;
+  while((opt = getopt(argc, argv, "n:g:o:s:")) != -1){
+    switch(opt){
+      case 'n': iterations = atol(optarg); break;
+      case 'g': games = atol(optarg); break;
+      case 'o': output_path = optarg; break;
+      case 's': seed = strtoull(optarg, NULL, 10); break;
+      default:
+        fprintf(stderr, "Usage: %s [-n ops] [-g games] [-o output.tsv] [-s seed]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  rng_state = rng_seed(seed);
+
+  FILE *out = fopen(output_path, "w");
+  if(out == NULL)
+    perror("Cannot open benchmark output");
+  else
+    fprintf(out, "commit\tengine\tbenchmark\tops\tns_per_op\tops_per_sec\tcycles_per_op\n");
+
+  prepare_pools();
+
+  printf("engine %s, commit %s, seed %llu%s\n", ENGINE_NAME, BENCH_COMMIT, (unsigned long long)seed,
+#ifdef HAVE_TSC
+         ""
+#else
+         " (no cycle counter, cycles/op reported as 0)"
+#endif
+         );
+  printf("%-16s %12s %12s %16s %12s\n", "benchmark", "ops", "ns/op", "ops/sec", "cycles/op");
+
+  BenchResult results[] = {
+    bench_init_board(iterations),
+    bench_can_place_ship(iterations),
+    bench_place_ship(iterations),
+    bench_take_shot(iterations),
+    bench_check_game_over(iterations),
+    bench_full_game(games),
+    bench_ai_choose_shot(iterations / 16),
+  };
+  for(size_t i = 0; i < sizeof(results) / sizeof(results[0]); i++)
+    report(out, &results[i]);
+
+  if(out != NULL){
+    fclose(out);
+    printf("results written to %s\n", output_path);
+  }
+  return sink == 0x7fffffff; // Never true, keeps sink alive
+}
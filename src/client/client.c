@@ -3,14 +3,20 @@
 #include <string.h>
 #include <unistd.h>
 #include <sys/socket.h>
+#include <sys/un.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <ncurses.h> // Include ncurses library
 #include <sys/time.h>
 #include <sys/select.h>
+#include <errno.h>
+#include <time.h>
 
 #include "../common/common.h"
 #include "../common/game_logic.h" 
+#include "../common/protocol.h"
+#include "../common/ai.h"
+#include "../common/rng.h"
 
 WINDOW *my_board_win;
 WINDOW *opponent_board_win;
@@ -19,23 +25,42 @@ WINDOW *message_win;
 PlayerBoard my_board;
 PlayerBoard opponent_board;
 
+#define RESUME_FILE ".battleship_resume" // Token for rejoining the last game after a server restart
+
 int my_cursor_y = 0, my_cursor_x = 0; // For placement cursor (row, col)
 int op_cursor_y = 0, op_cursor_x = 0; // For shooting cursor (row, col)
 
-void draw_board(WINDOW *win, const PlayerBoard *board, int offset_y, int offset_x, int show_ships, int cursor_y, int cursor_x){
-  wclear(win);
-  box(win, 0, 0);
-
-  mvwprintw(win, offset_y, offset_x + 2, "A B C D E F G H I J");
+// What is currently on screen for one board window. Redraws compare against
+// it and only touch cells whose glyph or cursor highlight changed, so an idle
+// screen produces no terminal output at all.
+typedef struct {
+  WINDOW *win;
+  chtype shown[BOARD_ROWS][BOARD_COLS];
+  int frame_drawn; // Border, column letters and row numbers are static
+} BoardView;
+
+void draw_board(BoardView *view, const PlayerBoard *board, int offset_y, int offset_x, int show_ships, int cursor_y, int cursor_x){
+  WINDOW *win = view->win;
+  int changed = 0;
+
+  if(!view->frame_drawn){
+    werase(win);
+    box(win, 0, 0);
+    mvwprintw(win, offset_y, offset_x + 2, "A B C D E F G H I J");
+    for(int r = 0; r < BOARD_ROWS; r++)
+      mvwprintw(win, offset_y + r + 1, offset_x, "%d ", r); // Print row numbers
+    memset(view->shown, 0, sizeof(view->shown));
+    view->frame_drawn = 1;
+    changed = 1;
+  }
 
   for(int r = 0; r < BOARD_ROWS; r++){
-    mvwprintw(win, offset_y + r + 1, offset_x, "%d ", r); // Print row numbers
     for(int c = 0; c < BOARD_COLS; c++){
       char cell_char = '?'; // Default for fog of war
       int color_pair = 0;
 
       if(show_ships){ // Display own board fully
-        switch (board->grid[r][c]) {
+        switch (get_cell(board, r, c)) {
           case WATER: cell_char = '~'; color_pair = 1; break; // Blue for water
           case SHIP:  cell_char = '#'; color_pair = 2; break; // Grey for ship
           case HIT:   cell_char = 'X'; color_pair = 3; break; // Red for hit
@@ -43,57 +68,85 @@ void draw_board(WINDOW *win, const PlayerBoard *board, int offset_y, int offset_
         }
       } 
       else{ // Opponent's board (fog of war)
-        switch (board->grid[r][c]) {
+        switch (get_cell(board, r, c)) {
           case WATER:
           case SHIP:  cell_char = '~'; color_pair = 1; break; // Water or undiscovered ship
           case HIT:   cell_char = 'X'; color_pair = 3; break; // Red for hit
           case MISS:  cell_char = 'O'; color_pair = 4; break; // White for miss
         }
       }
-
-      wattron(win, COLOR_PAIR(color_pair));
-      mvwaddch(win, offset_y + r + 1, offset_x + c * 2 + 2, cell_char); // +2 for row num and space
-      wattroff(win, COLOR_PAIR(color_pair));
-
-      // Draw cursor
-      if (r == cursor_y && c == cursor_x) {
-        wattron(win, COLOR_PAIR(5)); // Reverse colors for cursor
-        mvwaddch(win, offset_y + r + 1, offset_x + c * 2 + 2, cell_char);
-        wattroff(win, COLOR_PAIR(5));
+      if (r == cursor_y && c == cursor_x)
+        color_pair = 5; // Cursor highlight
+
+      chtype glyph = (chtype)cell_char | COLOR_PAIR(color_pair);
+      if(view->shown[r][c] != glyph){
+        mvwaddch(win, offset_y + r + 1, offset_x + c * 2 + 2, glyph); // +2 for row num and space
+        view->shown[r][c] = glyph;
+        changed = 1;
       }
     }
   }
-  wrefresh(win);
+  // Queue the window; the caller flushes everything with one doupdate()
+  if(changed)
+    wnoutrefresh(win);
+}
+
+static const char *ship_name(ShipType type){
+  return (type == CARRIER) ? "Carrier" : (type == BATTLESHIP) ? "Battleship" : (type == CRUISER) ? "Cruiser" : (type == SUBMARINE) ? "Submarine" : "Destroyer";
 }
 
-// Function to display messages
+// Function to display messages. Queued like the boards, flushed by doupdate().
 void display_message(WINDOW *win, const char *msg) {
-  wclear(win);
+  static char shown[MAX_MSG_LEN * 2];
+  static WINDOW *shown_win;
+  if (win == shown_win && strcmp(shown, msg) == 0)
+    return;
+  snprintf(shown, sizeof(shown), "%s", msg);
+  shown_win = win;
+  werase(win);
   box(win, 0, 0);
   mvwprintw(win, 1, 1, "%s", msg);
-  wrefresh(win);
+  wnoutrefresh(win);
 }
 
 int main(int argc, char *argv[]){
   int client_sock;
   struct sockaddr_in server_addr;
+  struct sockaddr_un unix_addr;
   char *server_ip;
 
   ssize_t bytes_received;
+  FrameReader reader;
+  char status_text[MAX_MSG_LEN * 2];
 
   PlayerBoard my_board;        // My ships
   PlayerBoard opponent_board; // My view of opponent's board (fog of war)
 
     // ncurses variables
   WINDOW *my_board_win, *opponent_board_win, *message_win;
+  BoardView my_board_view, opponent_board_view;
   int my_cursor_y = 0, my_cursor_x = 0; // For placement cursor
   int op_cursor_y = 0, op_cursor_x = 0; // For shooting cursor
 
-  if (argc != 2) {
-    fprintf(stderr, "Usage: %s <server_ip>\n", argv[0]);
+  int vs_computer = (argc == 3 && strcmp(argv[2], "-a") == 0);
+  int resume = (argc == 3 && strcmp(argv[2], "-r") == 0);
+  if (argc != 2 && !vs_computer && !resume) {
+    fprintf(stderr, "Usage: %s <server_ip | unix_socket_path> [-a | -r]\n", argv[0]);
     return EXIT_FAILURE;
   }
   server_ip = argv[1];
+  int local = (server_ip[0] == '/'); // A path: the server's -u socket
+
+  char resume_token[MAX_MSG_LEN] = "";
+  if (resume) {
+    FILE *token_file = fopen(RESUME_FILE, "r");
+    if (token_file == NULL || fgets(resume_token, sizeof(resume_token), token_file) == NULL) {
+      fprintf(stderr, "No game to resume (%s not found).\n", RESUME_FILE);
+      return EXIT_FAILURE;
+    }
+    fclose(token_file);
+    resume_token[strcspn(resume_token, "\n")] = '\0';
+  }
 
   // --- Ncurses Initialization ---
   initscr();             // Start ncurses mode
@@ -114,12 +167,17 @@ int main(int argc, char *argv[]){
   my_board_win = newwin(BOARD_ROWS + 3, BOARD_COLS * 2 + 4, 0, 0);
   opponent_board_win = newwin(BOARD_ROWS + 3, BOARD_COLS * 2 + 4, 0, BOARD_COLS * 2 + 5);
   message_win = newwin(5, (BOARD_COLS * 2 + 4) * 2 + 1, BOARD_ROWS + 4, 0);
+  memset(&my_board_view, 0, sizeof(my_board_view));
+  memset(&opponent_board_view, 0, sizeof(opponent_board_view));
+  my_board_view.win = my_board_win;
+  opponent_board_view.win = opponent_board_win;
 
-  display_message(message_win, "Connecting to server...");
   refresh();
+  display_message(message_win, "Connecting to server...");
+  doupdate();
 
   // creating socket
-  client_sock = socket(AF_INET, SOCK_STREAM, 0);
+  client_sock = socket(local ? AF_UNIX : AF_INET, SOCK_STREAM, 0);
   if(client_sock < 0){
     perror("Socker creation failed");
     endwin();
@@ -127,17 +185,23 @@ int main(int argc, char *argv[]){
   }
 
   // prepare socketaddr_in structure
+  memset(&unix_addr, 0, sizeof(unix_addr));
+  unix_addr.sun_family = AF_UNIX;
   server_addr.sin_family = AF_INET;
   server_addr.sin_port = htons(PORT);
-  if (inet_pton(AF_INET, server_ip, &server_addr.sin_addr) <= 0) {
+  if (local ? strlen(server_ip) >= sizeof(unix_addr.sun_path) : inet_pton(AF_INET, server_ip, &server_addr.sin_addr) <= 0) {
     fprintf(stderr, "Invalid address/ Address not supported\n");
     close(client_sock);
     endwin();
     exit(EXIT_FAILURE);
   }
+  if (local)
+    strcpy(unix_addr.sun_path, server_ip);
 
   // connect to the server
-  if (connect(client_sock, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
+  int rc = local ? connect(client_sock, (struct sockaddr *)&unix_addr, sizeof(unix_addr))
+                 : connect(client_sock, (struct sockaddr *)&server_addr, sizeof(server_addr));
+  if (rc < 0) {
     perror("Connection failed");
     close(client_sock);
     endwin();
@@ -146,6 +210,20 @@ int main(int argc, char *argv[]){
 
   display_message(message_win, "Connected to server. Waiting for game to start...");
 
+  if (vs_computer) {
+    GameMessage ai_request;
+    memset(&ai_request, 0, sizeof(ai_request));
+    ai_request.type = MSG_TYPE_AI_GAME_REQ;
+    send_framed_message(client_sock, &ai_request);
+  }
+  if (resume) {
+    GameMessage resume_request;
+    memset(&resume_request, 0, sizeof(resume_request));
+    resume_request.type = MSG_TYPE_RESUME_REQ;
+    snprintf(resume_request.message, sizeof(resume_request.message), "%s", resume_token);
+    send_framed_message(client_sock, &resume_request);
+  }
+
   // Initialize both boards locally
   init_board(&my_board);
   init_board(&opponent_board);
@@ -153,30 +231,81 @@ int main(int argc, char *argv[]){
   GamePhase current_client_phase = GAME_PHASE_PLACEMENT;
   GameMessage received_msg;
   GameMessage send_msg;
+  frame_reader_init(&reader);
   int ch; // For keyboard input
 
     // Placement phase specific variables
   ShipType current_ship_to_place_type = -1; // -1 indicates not yet prompted for a ship
   Orientation current_placement_orientation = HORIZONTAL;
   Ship temp_ship_for_placement; // Temporary ship object to hold current placement attempt
+  int in_game = 0; // Paired, so the server takes a fleet from us
+  int fleet_pending = 0; // Auto-placed fleet sent, waiting for the server
+  int my_turn = 0; // TURN_IND came and we have not fired yet
+  int hint_pending = 0; // HINT_REQ sent this turn, no answer yet
+  PlayerBoard auto_fleet; // Fleet sent with F, adopted once the server accepts it
+  uint64_t placement_rng = rng_seed((uint64_t)time(NULL) ^ (uint64_t)getpid());
+
+  nodelay(stdscr, TRUE);
 
   while(current_client_phase != GAME_PHASE_GAMEOVER){
     if(current_client_phase == GAME_PHASE_PLACEMENT){
-      draw_board(my_board_win, &my_board, 0, 0, 1, my_cursor_y, my_cursor_x);
-      draw_board(opponent_board_win, &opponent_board, 0, 0, 0, -1, -1);
+      draw_board(&my_board_view, &my_board, 0, 0, 1, my_cursor_y, my_cursor_x);
+      draw_board(&opponent_board_view, &opponent_board, 0, 0, 0, -1, -1);
     }
     else{
       // GAME PHASE shooting
-      draw_board(my_board_win, &my_board, 0, 0, 1, -1, -1); // No cursor on own board during shooting
-      draw_board(opponent_board_win, &opponent_board, 0, 0, 0, op_cursor_y, op_cursor_x);
+      draw_board(&my_board_view, &my_board, 0, 0, 1, -1, -1); // No cursor on own board during shooting
+      draw_board(&opponent_board_view, &opponent_board, 0, 0, 0, op_cursor_y, op_cursor_x);
     }
-    doupdate();
+    doupdate(); // Single flush of everything queued this iteration
 
-    nodelay(stdscr, TRUE);
+    // Sleep until a key is pressed or the server says something
+    fd_set read_fds;
+    FD_ZERO(&read_fds);
+    FD_SET(STDIN_FILENO, &read_fds);
+    FD_SET(client_sock, &read_fds);
 
-    if(current_client_phase == GAME_PHASE_PLACEMENT){
-      ch = getch();
-      if(ch != ERR){
+    int select_result = select(client_sock + 1, &read_fds, NULL, NULL, NULL);
+    if (select_result == -1 && errno == EINTR)
+      continue;
+
+    if(select_result > 0 && FD_ISSET(STDIN_FILENO, &read_fds)){
+      nodelay(stdscr, TRUE);
+      // Drain every pending key; outside placement and our turn they are simply discarded
+      while((ch = getch()) != ERR){
+        if(current_client_phase == GAME_PHASE_SHOOTING && my_turn){
+          switch(ch){
+            case 'w': // WASD controls for shooting
+            case 'W': if(op_cursor_y > 0) op_cursor_y--; break;
+            case 's':
+            case 'S': if(op_cursor_y < BOARD_ROWS - 1) op_cursor_y++; break;
+            case 'a':
+            case 'A': if(op_cursor_x > 0) op_cursor_x--; break;
+            case 'd':
+            case 'D': if(op_cursor_x < BOARD_COLS - 1) op_cursor_x++; break;
+            case 'h':
+            case 'H': // The server's solver answers with HINT_RES
+                      if(hint_pending)
+                        break;
+                      memset(&send_msg, 0, sizeof(send_msg));
+                      send_msg.type = MSG_TYPE_HINT_REQ;
+                      send_framed_message(client_sock, &send_msg);
+                      hint_pending = 1;
+                      display_message(message_win, "Asking for a hint...");
+                      break;
+            case 10: // Enter key
+                      memset(&send_msg, 0, sizeof(send_msg));
+                      send_msg.type = MSG_TYPE_SHOT_REQ;
+                      send_msg.row = op_cursor_y;
+                      send_msg.col = op_cursor_x;
+                      send_framed_message(client_sock, &send_msg);
+                      my_turn = 0;
+                      break;
+          }
+          continue;
+        }
+        if(current_client_phase != GAME_PHASE_PLACEMENT)
+          continue;
         switch(ch){
           case 'w':
           case 'W': if(my_cursor_y > 0) my_cursor_y--; break;
@@ -186,6 +315,28 @@ int main(int argc, char *argv[]){
           case 'S': if(my_cursor_y < BOARD_ROWS - 1) my_cursor_y++; break;
           case 'd':
           case 'D': if(my_cursor_x < BOARD_COLS - 1) my_cursor_x++; break;
+          case 'f':
+          case 'F': {
+                    // Auto-place: a random valid fleet goes to the server in one message
+                    int any_placed = 0;
+                    for (int i = 0; i < NUM_SHIPS; i++)
+                      any_placed |= my_board.ships[i].is_placed;
+                    if (!in_game || fleet_pending || any_placed) {
+                      display_message(message_win, any_placed ? "Auto-place only works before your first ship is down." : "Waiting for the game to start...");
+                      break;
+                    }
+                    init_board(&auto_fleet);
+                    ai_place_fleet(&auto_fleet, &placement_rng);
+                    memset(&send_msg, 0, sizeof(send_msg));
+                    send_msg.type = MSG_TYPE_FLEET_REQ;
+                    send_msg.fleet_count = NUM_SHIPS;
+                    for (int i = 0; i < NUM_SHIPS; i++)
+                      send_msg.fleet[i] = (ShipPlacement){(uint16_t)auto_fleet.ships[i].row, (uint16_t)auto_fleet.ships[i].col, (uint8_t)auto_fleet.ships[i].orientation};
+                    send_framed_message(client_sock, &send_msg);
+                    fleet_pending = 1;
+                    display_message(message_win, "Sending fleet to server...");
+                    break;
+                  }
           case 'r':
           case 'R': current_placement_orientation = (current_placement_orientation == HORIZONTAL) ? VERTICAL : HORIZONTAL;
                     display_message(message_win, (current_placement_orientation == HORIZONTAL) ? "Orientation: HORIZONTAL (Press R to rotate)" : "Orientation: VERTICAL (Press R to rotate)"); break;
@@ -201,15 +352,14 @@ int main(int argc, char *argv[]){
                         .is_placed = 0
                       };
                       if(can_place_ship(&my_board, &temp_ship_for_placement)){
+                        memset(&send_msg, 0, sizeof(send_msg));
                         send_msg.type = MSG_TYPE_PLACEMENT_REQ;
                         send_msg.row = my_cursor_y;
                         send_msg.col = my_cursor_x;
                         send_msg.ship_type = current_ship_to_place_type;
                         send_msg.orientation = current_placement_orientation;
-                        sprintf(send_msg.message, "Placement attempt for %s at (%d,%d) %s.", (current_ship_to_place_type == CARRIER) ? "Carrier" : (current_ship_to_place_type == BATTLESHIP) ? "Battleship" : (current_ship_to_place_type == CRUISER) ? "Cruiser" : (current_ship_to_place_type == SUBMARINE) ? "Submarine" : "Destroyer", my_cursor_y, my_cursor_x, (current_placement_orientation == HORIZONTAL) ? "Horizontal" : "Vertical");
-                        send(client_sock, &send_msg, sizeof(send_msg), 0);
+                        send_framed_message(client_sock, &send_msg);
                         display_message(message_win, "Sending placement request to server...");
-                        nodelay(stdscr, FALSE); // Make getch() blocking again while waiting for server response
                        }
                       else{
                         display_message(message_win, "Invalid placement (local check). Overlaps or out of bounds. Try again.");
@@ -222,32 +372,34 @@ int main(int argc, char *argv[]){
         }
       }
     }
-    struct timeval tv;
-    tv.tv_sec = 0;
-    tv.tv_usec = 10000;
-
-    fd_set read_fds;
-    FD_ZERO(&read_fds);
-    FD_SET(client_sock, &read_fds);
-
-    int select_result = select(client_sock + 1, &read_fds, NULL, NULL, &tv);
-
     if(select_result > 0 && FD_ISSET(client_sock, &read_fds)){
-      bytes_received = recv(client_sock, &received_msg, sizeof(received_msg), 0);
+      bytes_received = frame_reader_recv(&reader, client_sock);
       if (bytes_received <= 0) {
         display_message(message_win, "Server disconnected or error.");
         current_client_phase = GAME_PHASE_GAMEOVER;
         continue;
       }
 
+      // One read may carry several frames, or only part of one.
+      int frame_status = 0;
+      while (current_client_phase != GAME_PHASE_GAMEOVER && (frame_status = frame_reader_next(&reader, &received_msg)) == 1) {
       switch (received_msg.type) {
         case MSG_TYPE_TEST:
                             display_message(message_win, received_msg.message);
                             break;
 
+        case MSG_TYPE_CONFIG:
+                            in_game = received_msg.success;
+                            if (in_game)
+                              display_message(message_win, "Game found. Place your ships, or press F to place the whole fleet at random.");
+                            break;
+
         case MSG_TYPE_PLACE_SHIP_PROMPT:
+                            if (fleet_pending)
+                              break; // Our whole fleet is already on its way
                             current_ship_to_place_type = received_msg.ship_type;
-                            display_message(message_win, received_msg.message);
+                            snprintf(status_text, sizeof(status_text), "Place your %s (size %d).", ship_name(received_msg.ship_type), get_ship_size(received_msg.ship_type));
+                            display_message(message_win, status_text);
                             // Reset cursor for new placement
                             my_cursor_y = 0;
                             my_cursor_x = 0;
@@ -266,7 +418,7 @@ int main(int argc, char *argv[]){
                             temp_ship_for_placement.size = get_ship_size(received_msg.ship_type);
                             place_ship(&my_board, &temp_ship_for_placement);
 
-                            display_message(message_win, received_msg.message);
+                            display_message(message_win, "Ship placed successfully!");
 
                             // Check if all ships are placed locally
                             bool all_ships_placed_locally = true;
@@ -285,69 +437,94 @@ int main(int argc, char *argv[]){
                             }
                           } 
                           else {
-                            display_message(message_win, received_msg.message);
+                            display_message(message_win, "Invalid placement. Try again.");
                             // Stay in placement phase for the same ship type.
                           }
                           current_ship_to_place_type = -1; // Reset so we don't accidentally reuse old prompt
                           break;
 
+        case MSG_TYPE_FLEET_RES:
+                          fleet_pending = 0;
+                          if (received_msg.success) {
+                            my_board = auto_fleet;
+                            current_ship_to_place_type = -1;
+                            current_client_phase = GAME_PHASE_SHOOTING;
+                            display_message(message_win, "Fleet placed! Waiting for opponent...");
+                            op_cursor_y = 0;
+                            op_cursor_x = 0;
+                          }
+                          else {
+                            snprintf(status_text, sizeof(status_text), "Fleet rejected. %s", received_msg.message);
+                            display_message(message_win, status_text);
+                          }
+                          break;
+
         case MSG_TYPE_TURN_IND:
                           current_client_phase = GAME_PHASE_SHOOTING; // Confirm shooting phase
-                          display_message(message_win, "YOUR TURN! Use WASD to aim, ENTER to fire."); // Updated message
-                          nodelay(stdscr, FALSE); // Make getch() blocking again for turn
-                          // --- Input loop for shooting ---
-                          bool shot_fired = false;
-                          while (!shot_fired) {
-                            draw_board(my_board_win, &my_board, 0, 0, true, -1, -1);
-                            draw_board(opponent_board_win, &opponent_board, 0, 0, false, op_cursor_y, op_cursor_x);
-                            doupdate();
-
-                            ch = getch();
-                            switch (ch) {
-                              case 'w': // WASD controls for shooting
-                              case 'W': if (op_cursor_y > 0) op_cursor_y--; break;
-                              case 's':
-                              case 'S': if (op_cursor_y < BOARD_ROWS - 1) op_cursor_y++; break;
-                              case 'a':
-                              case 'A': if (op_cursor_x > 0) op_cursor_x--; break;
-                              case 'd':
-                              case 'D': if (op_cursor_x < BOARD_COLS - 1) op_cursor_x++; break;
-                              case 10: // Enter key
-                                        send_msg.type = MSG_TYPE_SHOT_REQ;
-                                        send_msg.row = op_cursor_y;
-                                        send_msg.col = op_cursor_x;
-                                        sprintf(send_msg.message, "Shot at %c%d", 'A'+op_cursor_x, op_cursor_y);
-                                        send(client_sock, &send_msg, sizeof(send_msg), 0);
-                                        shot_fired = true;
-                                        break;
-                            }
+                          display_message(message_win, "YOUR TURN! Use WASD to aim, ENTER to fire, H for a hint."); // Updated message
+                          my_turn = 1;
+                          hint_pending = 0;
+                          break;
+
+        case MSG_TYPE_HINT_RES:
+                          hint_pending = 0;
+                          if (received_msg.success && my_turn) {
+                            op_cursor_y = received_msg.row;
+                            op_cursor_x = received_msg.col;
                           }
-                          nodelay(stdscr, TRUE); // After shot, make getch() non-blocking again
-                          break; // End of MSG_TYPE_TURN_IND block
+                          snprintf(status_text, sizeof(status_text), "Hint: %s", received_msg.message);
+                          display_message(message_win, status_text);
+                          break;
 
         case MSG_TYPE_SHOT_RES:
-                        if (strcmp(received_msg.message, "HIT!") == 0 || strcmp(received_msg.message, "HIT and SUNK!") == 0 || strstr(received_msg.message, "was HIT") != NULL) {
-                          if (strstr(received_msg.message, "Your ship at") != NULL) {
-                            my_board.grid[received_msg.row][received_msg.col] = HIT;
-                          } 
-                          else {
-                            opponent_board.grid[received_msg.row][received_msg.col] = HIT;
-                          }
-                         } 
+                        if (received_msg.own_board) {
+                          set_cell(&my_board, received_msg.row, received_msg.col, received_msg.is_hit ? HIT : MISS);
+                          if (received_msg.is_sunk)
+                            snprintf(status_text, sizeof(status_text), "Your %s at (%d,%d) was HIT and SUNK!", ship_name(received_msg.ship_type), received_msg.row, received_msg.col);
+                          else if (received_msg.is_hit)
+                            snprintf(status_text, sizeof(status_text), "Your ship at (%d,%d) was HIT!", received_msg.row, received_msg.col);
+                          else
+                            snprintf(status_text, sizeof(status_text), "Opponent MISSED your board at (%d,%d).", received_msg.row, received_msg.col);
+                        }
                         else {
-                          if (strstr(received_msg.message, "Opponent MISSED your board at") != NULL) {
-                            my_board.grid[received_msg.row][received_msg.col] = MISS;
-                          } 
-                          else {
-                            opponent_board.grid[received_msg.row][received_msg.col] = MISS;
-                          }
+                          set_cell(&opponent_board, received_msg.row, received_msg.col, received_msg.is_hit ? HIT : MISS);
+                          if (received_msg.is_sunk)
+                            snprintf(status_text, sizeof(status_text), "HIT and SUNK! Your shot at (%d,%d) sunk the %s.", received_msg.row, received_msg.col, ship_name(received_msg.ship_type));
+                          else if (received_msg.is_hit)
+                            snprintf(status_text, sizeof(status_text), "HIT! Your shot at (%d,%d) hit a ship.", received_msg.row, received_msg.col);
+                          else
+                            snprintf(status_text, sizeof(status_text), "MISS. Your shot at (%d,%d) hit water.", received_msg.row, received_msg.col);
                         }
-                        display_message(message_win, received_msg.message);
+                        display_message(message_win, status_text);
                         nodelay(stdscr, TRUE);
                         break;
 
+        case MSG_TYPE_RESUME_TOKEN: {
+                        FILE *token_file = fopen(RESUME_FILE, "w");
+                        if (token_file != NULL) {
+                          fprintf(token_file, "%s\n", received_msg.message);
+                          fclose(token_file);
+                        }
+                        break;
+                      }
+
+        case MSG_TYPE_RESUME_RES:
+                        if (received_msg.success) {
+                          display_message(message_win, "Rejoined your game.");
+                          break;
+                        }
+                        snprintf(status_text, sizeof(status_text), "Could not resume: %s Press any key.", received_msg.message);
+                        display_message(message_win, status_text);
+                        doupdate();
+                        current_client_phase = GAME_PHASE_GAMEOVER;
+                        nodelay(stdscr, FALSE);
+                        getch();
+                        break;
+
         case MSG_TYPE_GAME_OVER:
-                        display_message(message_win, received_msg.message);
+                        snprintf(status_text, sizeof(status_text), "GAME OVER! You %s! %s", received_msg.success ? "win" : "lose", received_msg.message);
+                        display_message(message_win, status_text);
+                        doupdate();
                         current_client_phase = GAME_PHASE_GAMEOVER;
                         nodelay(stdscr, FALSE);
                         getch();
@@ -358,6 +535,11 @@ int main(int argc, char *argv[]){
                         nodelay(stdscr, TRUE);
                         break;
       }
+      }
+      if (frame_status < 0) {
+        display_message(message_win, "Protocol error. Disconnecting.");
+        current_client_phase = GAME_PHASE_GAMEOVER;
+      }
     } 
     else if (select_result == -1) {
       perror("select error");
@@ -0,0 +1,153 @@
+#include <string.h>
+
+#include "ai.h"
+#include "game_logic.h"
+#include "placement.h"
+#include "rng.h"
+
+// The density kernel keeps one counter per cell as bit planes: plane j holds
+// bit j of every cell's counter. Adding a placement mask to all 100 counters
+// is then a ripple-carry over a handful of 128-bit words, so a whole heatmap
+// costs a few hundred word operations and no per-cell loop.
+
+#define COUNTER_PLANES 7 // Up to 127 placements per cell; the classic fleet needs at most 34
+
+typedef struct {
+  BoardMask plane[COUNTER_PLANES];
+} CellCounters;
+
+static void counters_add(CellCounters *counters, BoardMask mask){
+  BoardMask carry = mask;
+  for(int j = 0; j < COUNTER_PLANES && carry; j++){
+    BoardMask next = counters->plane[j] & carry;
+    counters->plane[j] ^= carry;
+    carry = next;
+  }
+}
+
+// Narrow candidates down to the cells holding the largest counter value by
+// walking the planes from the most significant bit.
+static BoardMask counters_argmax(const CellCounters *counters, BoardMask candidates){
+  for(int j = COUNTER_PLANES - 1; j >= 0; j--){
+    BoardMask keep = candidates & counters->plane[j];
+    if(keep)
+      candidates = keep;
+  }
+  return candidates;
+}
+
+// Accumulate every legal placement of every live ship into all_counts, and
+// those passing through at least one open hit into hit_counts.
+static void density_kernel(const AiPlayer *ai, CellCounters *all_counts, CellCounters *hit_counts){
+  memset(all_counts, 0, sizeof(*all_counts));
+  memset(hit_counts, 0, sizeof(*hit_counts));
+  BoardMask free_cells = full_board_mask() & ~(ai->misses | ai->sunk_cells);
+
+  for(int type = 0; type < NUM_SHIPS; type++){
+    if(!ai->ship_alive[type])
+      continue;
+    int size = get_ship_size((ShipType)type);
+    for(int orientation = HORIZONTAL; orientation <= VERTICAL; orientation++){
+      int step = (orientation == HORIZONTAL) ? 1 : BOARD_COLS;
+      BoardMask starts = placement_starts[size][orientation];
+      BoardMask through_hit = 0;
+      for(int k = 0; k < size; k++){
+        starts &= free_cells >> (k * step);
+        through_hit |= ai->open_hits >> (k * step);
+      }
+      through_hit &= starts;
+      for(int k = 0; k < size; k++){
+        counters_add(all_counts, starts << (k * step));
+        if(through_hit)
+          counters_add(hit_counts, through_hit << (k * step));
+      }
+    }
+  }
+}
+
+void ai_init(AiPlayer *ai, uint64_t seed){
+  memset(ai, 0, sizeof(*ai));
+  for(int i = 0; i < NUM_SHIPS; i++)
+    ai->ship_alive[i] = 1;
+  ai->rng = rng_seed(seed);
+}
+
+void ai_place_fleet(PlayerBoard *board, uint64_t *rng){
+  for(int i = 0; i < NUM_SHIPS; i++){
+    Ship ship = board->ships[i];
+    // Draw from the legal placements only; retries are for overlaps alone
+    int choices = placement_count(ship.size);
+    do{
+      placement_nth(ship.size, (int)rng_below(rng, (uint32_t)choices), &ship.row, &ship.col, &ship.orientation);
+    } while(!can_place_ship(board, &ship));
+    place_ship(board, &ship);
+  }
+}
+
+void ai_choose_shot(AiPlayer *ai, int *row, int *col){
+  CellCounters all_counts, hit_counts;
+  density_kernel(ai, &all_counts, &hit_counts);
+
+  BoardMask unshot = full_board_mask() & ~(ai->open_hits | ai->sunk_cells | ai->misses);
+  BoardMask best = unshot;
+  if(ai->open_hits)
+    best = counters_argmax(&hit_counts, best);
+  best = counters_argmax(&all_counts, best);
+  if(best == 0)
+    best = unshot;
+
+  // Break ties at random so the AI is not predictable
+  int choices = mask_popcount(best);
+  int pick = choices > 1 ? (int)rng_below(&ai->rng, (uint32_t)choices) : 0;
+  while(pick-- > 0)
+    best &= best - 1;
+  int index = best ? mask_lowest_index(best) : 0;
+  *row = index / BOARD_COLS;
+  *col = index % BOARD_COLS;
+}
+
+// The sinking shot is one end of, or inside, a run of open hits the size of
+// the sunk ship. Retire the first such run so its cells stop attracting shots.
+static void retire_sunk_ship(AiPlayer *ai, int row, int col, ShipType sunk_type){
+  int size = get_ship_size(sunk_type);
+  for(int orientation = HORIZONTAL; orientation <= VERTICAL; orientation++){
+    for(int offset = 0; offset < size; offset++){
+      int r = row - (orientation == VERTICAL ? offset : 0);
+      int c = col - (orientation == HORIZONTAL ? offset : 0);
+      BoardMask cells = placement_mask(r, c, size, (Orientation)orientation);
+      if(cells != 0 && (cells & ai->open_hits) == cells){
+        ai->open_hits &= ~cells;
+        ai->sunk_cells |= cells;
+        return;
+      }
+    }
+  }
+  // No clean run found (adjacent ships): at least retire the sinking cell
+  ai->open_hits &= ~cell_bit(row, col);
+  ai->sunk_cells |= cell_bit(row, col);
+}
+
+void ai_observe(AiPlayer *ai, int row, int col, int is_hit, ShipType sunk_type){
+  if(row < 0 || row >= BOARD_ROWS || col < 0 || col >= BOARD_COLS)
+    return;
+  if(!is_hit){
+    ai->misses |= cell_bit(row, col);
+    return;
+  }
+  ai->open_hits |= cell_bit(row, col);
+  if(sunk_type >= 0 && sunk_type < NUM_SHIPS){
+    ai->ship_alive[sunk_type] = 0;
+    retire_sunk_ship(ai, row, col, sunk_type);
+  }
+}
+
+void ai_heatmap(const AiPlayer *ai, uint16_t density[BOARD_CELLS]){
+  CellCounters all_counts, hit_counts;
+  density_kernel(ai, &all_counts, &hit_counts);
+  for(int i = 0; i < BOARD_CELLS; i++){
+    uint16_t value = 0;
+    for(int j = 0; j < COUNTER_PLANES; j++)
+      value |= (uint16_t)(((all_counts.plane[j] >> i) & 1) << j);
+    density[i] = value;
+  }
+}
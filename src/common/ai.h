@@ -0,0 +1,35 @@
+#ifndef AI_H
+#define AI_H
+
+#include <stdint.h>
+
+#include "common.h"
+#include "bitboard.h"
+
+// Probability-density computer opponent. It only sees what a human would:
+// where it hit, where it missed and which ship type each sinking shot sank.
+typedef struct {
+  BoardMask open_hits;  // Hits not yet attributed to a sunk ship
+  BoardMask sunk_cells; // Cells of ships known to be sunk
+  BoardMask misses;
+  int ship_alive[NUM_SHIPS]; // Indexed by ShipType
+  uint64_t rng;
+} AiPlayer;
+
+void ai_init(AiPlayer *ai, uint64_t seed);
+
+// Place a complete random fleet on board (which must be freshly initialised).
+void ai_place_fleet(PlayerBoard *board, uint64_t *rng);
+
+// Pick the next cell to fire at: the densest unshot cell, preferring
+// placements through open hits (target mode) over plain search (hunt mode).
+void ai_choose_shot(AiPlayer *ai, int *row, int *col);
+
+// Feed back the result of a shot the AI fired.
+void ai_observe(AiPlayer *ai, int row, int col, int is_hit, ShipType sunk_type);
+
+// Number of legal remaining-ship placements covering each cell, indexed by
+// cell_index(). Exposed for benchmarks and hints.
+void ai_heatmap(const AiPlayer *ai, uint16_t density[BOARD_CELLS]);
+
+#endif // AI_H
@@ -0,0 +1,36 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include "common.h"
+
+// A BOARD_ROWS x BOARD_COLS board packed into one 128-bit mask, one bit per
+// cell at index row * BOARD_COLS + col.
+typedef unsigned __int128 BoardMask;
+
+#define BOARD_CELLS (BOARD_ROWS * BOARD_COLS)
+
+static inline int cell_index(int row, int col){
+  return row * BOARD_COLS + col;
+}
+
+static inline BoardMask cell_bit(int row, int col){
+  return (BoardMask)1 << cell_index(row, col);
+}
+
+static inline BoardMask full_board_mask(void){
+  return ((BoardMask)1 << BOARD_CELLS) - 1;
+}
+
+static inline int mask_popcount(BoardMask mask){
+  return __builtin_popcountll((unsigned long long)mask) + __builtin_popcountll((unsigned long long)(mask >> 64));
+}
+
+// Index of the lowest set bit. mask must be non-zero.
+static inline int mask_lowest_index(BoardMask mask){
+  unsigned long long low = (unsigned long long)mask;
+  if(low != 0)
+    return __builtin_ctzll(low);
+  return 64 + __builtin_ctzll((unsigned long long)(mask >> 64));
+}
+
+#endif // BITBOARD_H
@@ -1,11 +1,16 @@
 #ifndef COMMON_H
 #define COMMON_H
 
+#include <stdint.h>
+
 #define PORT 8080
-#define MAX_MSG_LEN 1024
+#define MAX_MSG_LEN 128
 #define BOARD_COLS 10
 #define BOARD_ROWS 10
 #define NUM_SHIPS 5
+#define MAX_BOARD_DIM 10000 // Largest side of a custom board
+#define MAX_FLEET 64 // Most ships in a custom fleet; indices travel as i8
+#define MAX_SALVO MAX_FLEET // A salvo has one shot per ship still afloat
 
 typedef enum {
   WATER,
@@ -44,11 +49,42 @@ typedef struct{
   int is_placed;
 } Ship;
 
+#ifdef BITBOARD_ENGINE
+// Bitboard engine: one bit per cell in each mask (see bitboard.h). Cell
+// state is read and written through get_cell()/set_cell().
+typedef struct{
+  unsigned __int128 ship_cells;
+  unsigned __int128 hit_cells;
+  unsigned __int128 miss_cells;
+  unsigned __int128 ship_id_bits[3]; // Bit planes of the ships[] index owning each ship cell
+  Ship ships[NUM_SHIPS];
+  int ships_remaining;
+} PlayerBoard;
+#else
 typedef struct{
   CellState grid[BOARD_ROWS][BOARD_COLS];
+  signed char ship_at[BOARD_ROWS][BOARD_COLS]; // Index into ships[] of the ship on each cell, -1 for none
   Ship ships[NUM_SHIPS];
   int ships_remaining;
 } PlayerBoard;
+#endif
+
+// One shot of a salvo: the target cell and, once resolved, what it did.
+typedef struct{
+  uint16_t row;
+  uint16_t col;
+  uint8_t is_hit;
+  uint8_t is_sunk;
+  int8_t sunk_ship; // Fleet index of the ship this shot sank, NO_SHIP otherwise
+} Shot;
+
+// Where one ship of a fleet submission goes; its fleet index is its
+// position in the list.
+typedef struct{
+  uint16_t row;
+  uint16_t col;
+  uint8_t orientation;
+} ShipPlacement;
 
 typedef struct{
   int type;
@@ -57,7 +93,14 @@ typedef struct{
   ShipType ship_type;
   Orientation orientation;
   int success;
-  char message[MAX_MSG_LEN];
+  int is_hit;
+  int is_sunk;
+  int own_board; // Shot result refers to the receiver's own board
+  char message[MAX_MSG_LEN]; // Optional text, only sent when non-empty
+  int shot_count; // Salvo shots, only sent when non-zero
+  int fleet_count; // Fleet submission, only sent when non-zero
+  Shot shots[MAX_SALVO];
+  ShipPlacement fleet[MAX_FLEET];
 } GameMessage;
 
 // Message types (example)
@@ -66,8 +109,28 @@ typedef struct{
 #define MSG_TYPE_PLACEMENT_RES 2
 #define MSG_TYPE_SHOT_REQ 3
 #define MSG_TYPE_SHOT_RES 4
-#define MSG_TYPE_TURN_IND 5 // Turn indication
+#define MSG_TYPE_TURN_IND 5 // Turn indication; in salvo games row is the number of shots to fire
 #define MSG_TYPE_GAME_OVER 6
 #define MSG_TYPE_PLACE_SHIP_PROMPT 7 
+#define MSG_TYPE_AI_GAME_REQ 8 // Unpaired player asks for a computer opponent
+#define MSG_TYPE_RESUME_TOKEN 9 // Server hands out the token that resumes this seat (text)
+#define MSG_TYPE_RESUME_REQ 10 // Reconnecting player presents a resume token (text)
+#define MSG_TYPE_RESUME_RES 11 // success set if the player is back in their game
+#define MSG_TYPE_CONFIG_REQ 12 // Board wanted: row x col, fleet as text (see game_board.h)
+#define MSG_TYPE_CONFIG 13 // Board and fleet the game is played with, sent when it starts
+#define MSG_TYPE_SALVO_REQ 14 // Salvo games: all of a turn's shots at once
+#define MSG_TYPE_SALVO_RES 15 // Every shot of a salvo resolved, to both players
+#define MSG_TYPE_FLEET_REQ 16 // Whole fleet at once, any time before the player's first ship is down
+#define MSG_TYPE_FLEET_RES 17 // success, or ship_type is the first ship that did not fit
+#define MSG_TYPE_SPECTATE_REQ 18 // Watch a game: its id as text, empty for the newest on the shard
+// success, then the game's CONFIG and its shots so far. From then on the
+// spectator gets every SHOT_RES and SALVO_RES as the shooter saw it, with
+// orientation holding the shooter's player index, and finally GAME_OVER
+// with success set and row holding the winner if there was one.
+#define MSG_TYPE_SPECTATE_RES 19
+#define MSG_TYPE_SHM_REQ 20 // Unix socket clients: move to the shared-memory rings (see shm_ring.h)
+#define MSG_TYPE_SHM_RES 21 // success: carries the ring's descriptors; every later frame uses the rings
+#define MSG_TYPE_HINT_REQ 22 // Classic board, on the player's turn: suggest a shot (see solver.h)
+#define MSG_TYPE_HINT_RES 23 // success: row, col is the suggestion and the text says why
 
 #endif // !COMMON_H
@@ -0,0 +1,176 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "game_board.h"
+
+void game_config_classic(GameConfig *config){
+  memset(config, 0, sizeof(*config));
+  config->rows = BOARD_ROWS;
+  config->cols = BOARD_COLS;
+  config->num_ships = NUM_SHIPS;
+  for(int i = 0; i < NUM_SHIPS; i++)
+    config->ship_sizes[i] = (unsigned short)get_ship_size((ShipType)i);
+}
+
+int game_config_is_classic(const GameConfig *config){
+  if(config->rows != BOARD_ROWS || config->cols != BOARD_COLS || config->num_ships != NUM_SHIPS)
+    return 0;
+  for(int i = 0; i < NUM_SHIPS; i++)
+    if(config->ship_sizes[i] != get_ship_size((ShipType)i))
+      return 0;
+  return 1;
+}
+
+static long fleet_cells(const GameConfig *config){
+  long cells = 0;
+  for(int i = 0; i < config->num_ships; i++)
+    cells += config->ship_sizes[i];
+  return cells;
+}
+
+int game_config_valid(const GameConfig *config){
+  if(config->rows < 1 || config->rows > MAX_BOARD_DIM || config->cols < 1 || config->cols > MAX_BOARD_DIM)
+    return 0;
+  if(config->num_ships < 1 || config->num_ships > MAX_FLEET)
+    return 0;
+  int longest = config->rows > config->cols ? config->rows : config->cols;
+  for(int i = 0; i < config->num_ships; i++)
+    if(config->ship_sizes[i] < 1 || config->ship_sizes[i] > longest)
+      return 0;
+  return fleet_cells(config) * 2 <= (long)config->rows * config->cols;
+}
+
+int game_config_parse(GameConfig *config, const char *text){
+  config->salvo = 0;
+  if(strncmp(text, "salvo:", 6) == 0){
+    config->salvo = 1;
+    text += 6;
+  }
+  if(*text == '\0'){
+    GameConfig classic;
+    game_config_classic(&classic);
+    config->num_ships = classic.num_ships;
+    memcpy(config->ship_sizes, classic.ship_sizes, sizeof(config->ship_sizes));
+    return 0;
+  }
+  int count = 0;
+  const char *p = text;
+  for(;;){
+    char *end;
+    long size = strtol(p, &end, 10);
+    if(end == p || size < 1 || size > MAX_BOARD_DIM)
+      return -1;
+    long repeat = 1;
+    p = end;
+    if(*p == 'x'){
+      repeat = strtol(p + 1, &end, 10);
+      if(end == p + 1 || repeat < 1 || repeat > MAX_FLEET)
+        return -1;
+      p = end;
+    }
+    if(count + repeat > MAX_FLEET)
+      return -1;
+    while(repeat-- > 0)
+      config->ship_sizes[count++] = (unsigned short)size;
+    if(*p == '\0')
+      break;
+    if(*p++ != ',')
+      return -1;
+  }
+  config->num_ships = count;
+  return 0;
+}
+
+void game_config_format(const GameConfig *config, char *out, size_t len){
+  size_t used = (size_t)snprintf(out, len, "%s", config->salvo ? "salvo:" : "");
+  for(int i = 0; i < config->num_ships && used < len;){
+    int run = 1;
+    while(i + run < config->num_ships && config->ship_sizes[i + run] == config->ship_sizes[i])
+      run++;
+    int n = (run > 1) ? snprintf(out + used, len - used, "%s%ux%d", i ? "," : "", config->ship_sizes[i], run)
+                      : snprintf(out + used, len - used, "%s%u", i ? "," : "", config->ship_sizes[i]);
+    if(n < 0)
+      break;
+    used += (size_t)n;
+    i += run;
+  }
+}
+
+void game_config_negotiate(const GameConfig *first, const GameConfig *second, GameConfig *out){
+  GameConfig shared = *first;
+  shared.salvo = first->salvo && second->salvo;
+  shared.rows = first->rows < second->rows ? first->rows : second->rows;
+  shared.cols = first->cols < second->cols ? first->cols : second->cols;
+
+  const GameConfig *smaller = (fleet_cells(second) < fleet_cells(first)) ? second : first;
+  const GameConfig *larger = (smaller == first) ? second : first;
+  const GameConfig *fleets[2] = { smaller, larger };
+  for(int i = 0; i < 2; i++){
+    shared.num_ships = fleets[i]->num_ships;
+    memcpy(shared.ship_sizes, fleets[i]->ship_sizes, sizeof(shared.ship_sizes));
+    if(game_config_valid(&shared)){
+      *out = shared;
+      return;
+    }
+  }
+  *out = *first;
+}
+
+void game_board_init(GameBoard *board, const GameConfig *config){
+  if(game_config_is_classic(config)){
+    board->sparse = 0;
+    init_board(&board->dense);
+    return;
+  }
+  board->sparse = 1;
+  sparse_board_init(&board->big, config->rows, config->cols, config->num_ships, config->ship_sizes);
+}
+
+void game_board_free(GameBoard *board){
+  if(board->sparse)
+    sparse_board_free(&board->big);
+}
+
+int game_board_place(GameBoard *board, int ship_idx, int row, int col, Orientation orientation){
+  if(ship_idx < 0 || ship_idx >= game_board_num_ships(board) || game_board_ship(board, ship_idx)->is_placed)
+    return 0;
+  Ship ship = {
+    .type = (ShipType)ship_idx,
+    .size = game_board_ship(board, ship_idx)->size,
+    .row = row,
+    .col = col,
+    .orientation = orientation,
+    .hits = 0,
+    .is_placed = 0
+  };
+  if(board->sparse)
+    return sparse_can_place_ship(&board->big, &ship) && sparse_place_ship(&board->big, &ship) == 0;
+  if(!can_place_ship(&board->dense, &ship))
+    return 0;
+  place_ship(&board->dense, &ship);
+  return 1;
+}
+
+int game_board_next_unplaced(const GameBoard *board){
+  for(int i = 0; i < game_board_num_ships(board); i++)
+    if(!game_board_ship(board, i)->is_placed)
+      return i;
+  return -1;
+}
+
+int game_board_next_shot(const GameBoard *board, uint32_t *pos, int *row, int *col, int *is_hit){
+  if(board->sparse)
+    return sparse_next_shot(&board->big, pos, row, col, is_hit);
+  for(; *pos < BOARD_ROWS * BOARD_COLS; (*pos)++){
+    CellState cell = get_cell(&board->dense, (int)*pos / BOARD_COLS, (int)*pos % BOARD_COLS);
+    if(cell != HIT && cell != MISS)
+      continue;
+    *row = (int)*pos / BOARD_COLS;
+    *col = (int)*pos % BOARD_COLS;
+    *is_hit = (cell == HIT);
+    (*pos)++;
+    return 1;
+  }
+  return 0;
+}
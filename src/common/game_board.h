@@ -0,0 +1,113 @@
+#ifndef GAME_BOARD_H
+#define GAME_BOARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+#include "game_logic.h"
+#include "sparse_board.h"
+
+// Board size, fleet and mode of one game. The classic board is BOARD_ROWS
+// x BOARD_COLS with the five ShipType ships; anything else is a custom
+// board. In salvo games a turn is one shot per ship the shooter has afloat.
+typedef struct {
+  int rows;
+  int cols;
+  int num_ships;
+  unsigned short ship_sizes[MAX_FLEET];
+  int salvo;
+} GameConfig;
+
+// Classic board and fleet, one shot per turn.
+void game_config_classic(GameConfig *config);
+
+// Classic board and fleet, whatever the mode.
+int game_config_is_classic(const GameConfig *config);
+
+// Every dimension within MAX_BOARD_DIM, every ship fits on the board and
+// the fleet covers at most half of it.
+int game_config_valid(const GameConfig *config);
+
+// Fleet and mode travel as text: comma separated ship sizes, where "SxN"
+// stands for N ships of size S, e.g. "5,4,3x2,2" for the classic fleet,
+// optionally prefixed with "salvo:". An empty fleet is the classic one.
+// Returns -1 if text is malformed or names more than MAX_FLEET ships.
+int game_config_parse(GameConfig *config, const char *text);
+
+void game_config_format(const GameConfig *config, char *out, size_t len);
+
+// Settle the game two players asked for: the board both fit in, with the
+// smaller of their fleets, in salvo mode only if both want it. If neither
+// fleet fits that board the first player's request wins as a whole.
+void game_config_negotiate(const GameConfig *first, const GameConfig *second, GameConfig *out);
+
+// One player's board. Classic games keep the compiled-in engine (grid or
+// bitboard) as the fast path; custom games use the sparse engine.
+typedef struct {
+  int sparse;
+  union {
+    PlayerBoard dense;
+    SparseBoard big;
+  };
+} GameBoard;
+
+void game_board_init(GameBoard *board, const GameConfig *config);
+
+void game_board_free(GameBoard *board);
+
+// Take the cell tables of a sparse board from alloc from now on. Classic
+// boards allocate nothing.
+static inline void game_board_set_alloc(GameBoard *board, SparseAlloc alloc, void *ctx){
+  if(!board->sparse)
+    return;
+  board->big.alloc = alloc;
+  board->big.alloc_ctx = ctx;
+}
+
+// Validate and place fleet ship ship_idx. Returns 1 if it was placed.
+int game_board_place(GameBoard *board, int ship_idx, int row, int col, Orientation orientation);
+
+// First ship still to be placed, -1 once the fleet is down.
+int game_board_next_unplaced(const GameBoard *board);
+
+static inline int game_board_num_ships(const GameBoard *board){
+  return board->sparse ? board->big.num_ships : NUM_SHIPS;
+}
+
+static inline const Ship *game_board_ship(const GameBoard *board, int ship_idx){
+  return board->sparse ? &board->big.ships[ship_idx] : &board->dense.ships[ship_idx];
+}
+
+// Same contract as take_shot(); sunk_ship receives the fleet index.
+static inline int game_board_shoot(GameBoard *board, int row, int col, int *is_hit, int *is_sunk, int *sunk_ship){
+  if(board->sparse)
+    return sparse_take_shot(&board->big, row, col, is_hit, is_sunk, sunk_ship);
+  ShipType sunk_type;
+  int hit = take_shot(&board->dense, row, col, is_hit, is_sunk, &sunk_type);
+  if(sunk_ship != NULL)
+    *sunk_ship = (int)sunk_type;
+  return hit;
+}
+
+// take_shots() on either engine.
+static inline int game_board_shoot_salvo(GameBoard *board, Shot *shots, int count){
+  return board->sparse ? sparse_take_shots(&board->big, shots, count) : take_shots(&board->dense, shots, count);
+}
+
+static inline int game_board_ships_afloat(const GameBoard *board){
+  return board->sparse ? board->big.ships_remaining : board->dense.ships_remaining;
+}
+
+static inline int game_board_over(const GameBoard *board){
+  return board->sparse ? board->big.ships_remaining <= 0 : check_game_over(&board->dense);
+}
+
+static inline CellState game_board_cell(const GameBoard *board, int row, int col){
+  return board->sparse ? sparse_get_cell(&board->big, row, col) : get_cell(&board->dense, row, col);
+}
+
+// Walk every cell that was shot at; start with *pos = 0.
+int game_board_next_shot(const GameBoard *board, uint32_t *pos, int *row, int *col, int *is_hit);
+
+#endif // GAME_BOARD_H
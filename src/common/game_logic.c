@@ -1,13 +1,16 @@
 #include <stdio.h>
 #include <string.h>
 #include "game_logic.h"
+#include "placement.h"
 
 void init_board(PlayerBoard *board){
   if(board == NULL)
     return;
   for(int r = 0; r < BOARD_ROWS; r++){
-    for(int c = 0; c < BOARD_COLS; c++)
+    for(int c = 0; c < BOARD_COLS; c++){
       board->grid[r][c] = WATER;
+      board->ship_at[r][c] = -1;
+    }
   }
 
   board->ships_remaining = NUM_SHIPS; // Initially all ships are unsunk
@@ -35,18 +38,12 @@ int get_ship_size(ShipType type){
 int can_place_ship(const PlayerBoard *board, const Ship *ship){
   if(board == NULL || ship == NULL)
     return 0; 
-  if(ship->orientation == HORIZONTAL){
-    if(ship->col < 0 || ship->col + ship->size > BOARD_COLS || ship->row < 0 || ship->row >= BOARD_ROWS)
-      return 0;
-  }
-  else{
-    if(ship->col < 0 || ship->col >= BOARD_COLS || ship->row < 0 || ship->row + ship->size > BOARD_ROWS)
-      return 0;
-  }
-  for(int i = 0; i < ship->size; i++){
-    int r = ship->row + (ship->orientation == HORIZONTAL ? i : 0);
-    int c = ship->col + (ship->orientation == VERTICAL ? i : 0);
-    if(board->grid[r][c] == SHIP)
+  BoardMask cells = placement_mask(ship->row, ship->col, ship->size, ship->orientation);
+  if(cells == 0)
+    return 0; // Off the board
+  for(; cells; cells &= cells - 1){
+    int index = mask_lowest_index(cells);
+    if(board->grid[index / BOARD_COLS][index % BOARD_COLS] == SHIP)
       return 0;
   }
   return 1; 
@@ -58,9 +55,11 @@ void place_ship(PlayerBoard *board, const Ship *ship_to_place) {
     // FIND the specific unplaced ship in the board->ships array that matches ship_to_place->type
     // This is the core logic that was missing.
     Ship *target_ship = NULL;
+    int target_idx = -1;
     for (int i = 0; i < NUM_SHIPS; i++) {
         if (board->ships[i].type == ship_to_place->type && !board->ships[i].is_placed) {
             target_ship = &board->ships[i];
+            target_idx = i;
             break; // Found an unplaced ship of this type
         }
     }
@@ -82,56 +81,88 @@ void place_ship(PlayerBoard *board, const Ship *ship_to_place) {
         int r = ship_to_place->row + (ship_to_place->orientation == VERTICAL ? i : 0);
         int c = ship_to_place->col + (ship_to_place->orientation == HORIZONTAL ? i : 0);
         board->grid[r][c] = SHIP;
+        board->ship_at[r][c] = (signed char)target_idx; // Lets take_shot find the ship without scanning
     }
 }
 
-int take_shot(PlayerBoard *board, int row, int col, int *is_hit, int *is_sunk){
+int take_shot(PlayerBoard *board, int row, int col, int *is_hit, int *is_sunk, ShipType *sunk_type){
+    *is_hit = 0;
+    *is_sunk = 0;
+    if (sunk_type != NULL)
+        *sunk_type = NO_SHIP;
     if (board == NULL || row < 0 || row >= BOARD_ROWS || col < 0 || col >= BOARD_COLS) {
-        *is_hit = 0;
-        *is_sunk = 0;
         return 0; // Invalid shot
     }
 
     if (board->grid[row][col] == WATER) {
         board->grid[row][col] = MISS;
-        *is_hit = 0;
-        *is_sunk = 0;
         return 0; // Miss
     } else if (board->grid[row][col] == SHIP) {
         board->grid[row][col] = HIT;
         *is_hit = 1;
 
-        // Check if any ship was hit and sunk
-        *is_sunk = 0;
-        for (int i = 0; i < NUM_SHIPS; i++) {
-            Ship *s = &board->ships[i];
-            if (s->hits < s->size) { // Only check if not already sunk
-                int hit_count = 0;
-                for (int j = 0; j < s->size; j++) {
-                    int r = s->row + (s->orientation == VERTICAL ? j : 0);
-                    int c = s->col + (s->orientation == HORIZONTAL ? j : 0);
-                    if (r == row && c == col) { // This specific part of the ship was hit
-                        s->hits++;
-                        break;
-                    }
-                }
-                if (s->hits == s->size) {
-                    *is_sunk = 1; // A ship was just sunk!
-                    board->ships_remaining--;
-                    // Optionally, you might want to return which ship was sunk
-                }
+        // The cell knows which ship covers it, so only that ship's counter moves
+        int ship_idx = board->ship_at[row][col];
+        if (ship_idx >= 0) {
+            Ship *s = &board->ships[ship_idx];
+            s->hits++;
+            if (s->hits == s->size) {
+                *is_sunk = 1; // A ship was just sunk!
+                board->ships_remaining--;
+                if (sunk_type != NULL)
+                    *sunk_type = s->type;
             }
         }
         return 1; // Hit
     }
     // If it's already HIT or MISS, treat as a miss (or inform player it's already shot)
-    *is_hit = 0;
-    *is_sunk = 0;
     return 0;
 }
 
+int take_shots(PlayerBoard *board, Shot *shots, int count){
+  int hits = 0;
+  for(int i = 0; i < count; i++){
+    Shot *shot = &shots[i];
+    shot->is_hit = 0;
+    shot->is_sunk = 0;
+    shot->sunk_ship = NO_SHIP;
+    if(shot->row >= BOARD_ROWS || shot->col >= BOARD_COLS)
+      continue; // Invalid shot
+    CellState *cell = &board->grid[shot->row][shot->col];
+    if(*cell == WATER){
+      *cell = MISS;
+      continue;
+    }
+    if(*cell != SHIP)
+      continue; // Already shot here
+    *cell = HIT;
+    shot->is_hit = 1;
+    hits++;
+    int ship_idx = board->ship_at[shot->row][shot->col];
+    Ship *s = &board->ships[ship_idx];
+    if(++s->hits == s->size){
+      shot->is_sunk = 1;
+      shot->sunk_ship = (int8_t)ship_idx;
+      board->ships_remaining--;
+    }
+  }
+  return hits;
+}
+
 int check_game_over(const PlayerBoard *board){
   if(board == NULL)
     return 0;
   return (board->ships_remaining <= 0);
 }
+
+CellState get_cell(const PlayerBoard *board, int row, int col){
+  if(board == NULL || row < 0 || row >= BOARD_ROWS || col < 0 || col >= BOARD_COLS)
+    return WATER;
+  return board->grid[row][col];
+}
+
+void set_cell(PlayerBoard *board, int row, int col, CellState state){
+  if(board == NULL || row < 0 || row >= BOARD_ROWS || col < 0 || col >= BOARD_COLS)
+    return;
+  board->grid[row][col] = state;
+}
@@ -10,10 +10,22 @@ int can_place_ship(const PlayerBoard *board, const Ship *ship);
 
 void place_ship(PlayerBoard *board, const Ship *ship);
 
-int take_shot(PlayerBoard *board, int row, int col, int *is_hit, int *is_sunk);
+// sunk_type (may be NULL) receives the type of the ship sunk by this shot,
+// or NO_SHIP if the shot did not sink one.
+int take_shot(PlayerBoard *board, int row, int col, int *is_hit, int *is_sunk, ShipType *sunk_type);
+
+// Resolve a whole salvo in one pass, in order, filling in each shot's
+// outcome. A cell fired at twice counts as a miss the second time.
+// Returns the number of hits.
+int take_shots(PlayerBoard *board, Shot *shots, int count);
 
 int check_game_over(const PlayerBoard *board);
 
 int get_ship_size(ShipType type); // Helper to get ship size based on type
 
+// Cell accessors, so callers do not depend on the board engine's layout
+CellState get_cell(const PlayerBoard *board, int row, int col);
+
+void set_cell(PlayerBoard *board, int row, int col, CellState state);
+
 #endif // GAME_LOGIC_H
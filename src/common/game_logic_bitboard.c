@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <string.h>
+#include "game_logic.h"
+#include "bitboard.h"
+#include "placement.h"
+
+_Static_assert(NUM_SHIPS <= 8, "ship indices must fit in the three ship_id_bits planes");
+
+// Bitboard implementation of game_logic.h. Selected with `make ENGINE=bitboard`,
+// which also defines BITBOARD_ENGINE so PlayerBoard holds masks instead of a grid.
+
+void init_board(PlayerBoard *board){
+  if(board == NULL)
+    return;
+  board->ship_cells = 0;
+  board->hit_cells = 0;
+  board->miss_cells = 0;
+  for(int i = 0; i < 3; i++)
+    board->ship_id_bits[i] = 0;
+
+  board->ships_remaining = NUM_SHIPS; // Initially all ships are unsunk
+  // Initialize ship details (sizes, types)
+  board->ships[0] = (Ship){CARRIER, 5, -1, -1, HORIZONTAL, 0, 0}; // -1 for not placed
+  board->ships[1] = (Ship){BATTLESHIP, 4, -1, -1, HORIZONTAL, 0, 0};
+  board->ships[2] = (Ship){CRUISER, 3, -1, -1, HORIZONTAL, 0, 0};
+  board->ships[3] = (Ship){SUBMARINE, 3, -1, -1, HORIZONTAL, 0, 0};
+  board->ships[4] = (Ship){DESTROYER, 2, -1, -1, HORIZONTAL, 0, 0};
+}
+
+int get_ship_size(ShipType type){
+  switch (type) {
+    case CARRIER: return 5;
+    case BATTLESHIP: return 4;
+    case CRUISER: return 3;
+    case SUBMARINE: return 3;
+    case DESTROYER: return 2;
+    default: return 0; // never happening
+  }
+}
+
+int can_place_ship(const PlayerBoard *board, const Ship *ship){
+  if(board == NULL || ship == NULL)
+    return 0;
+  BoardMask cells = placement_mask(ship->row, ship->col, ship->size, ship->orientation);
+  return (cells != 0) & ((cells & board->ship_cells) == 0);
+}
+
+void place_ship(PlayerBoard *board, const Ship *ship_to_place){
+  if(board == NULL || ship_to_place == NULL)
+    return;
+
+  Ship *target_ship = NULL;
+  int target_idx = -1;
+  for(int i = 0; i < NUM_SHIPS; i++){
+    if(board->ships[i].type == ship_to_place->type && !board->ships[i].is_placed){
+      target_ship = &board->ships[i];
+      target_idx = i;
+      break; // Found an unplaced ship of this type
+    }
+  }
+
+  if(target_ship == NULL){
+    fprintf(stderr, "Error: No unplaced ship of type %d available.\n", ship_to_place->type);
+    return;
+  }
+
+  target_ship->row = ship_to_place->row;
+  target_ship->col = ship_to_place->col;
+  target_ship->orientation = ship_to_place->orientation;
+  target_ship->is_placed = 1;
+
+  BoardMask cells = placement_mask(ship_to_place->row, ship_to_place->col, ship_to_place->size, ship_to_place->orientation);
+  board->ship_cells |= cells;
+  for(int plane = 0; plane < 3; plane++){
+    if(target_idx & (1 << plane))
+      board->ship_id_bits[plane] |= cells;
+  }
+}
+
+int take_shot(PlayerBoard *board, int row, int col, int *is_hit, int *is_sunk, ShipType *sunk_type){
+  *is_hit = 0;
+  *is_sunk = 0;
+  if(sunk_type != NULL)
+    *sunk_type = NO_SHIP;
+  if(board == NULL || row < 0 || row >= BOARD_ROWS || col < 0 || col >= BOARD_COLS)
+    return 0; // Invalid shot
+
+  BoardMask bit = cell_bit(row, col);
+  if((board->hit_cells | board->miss_cells) & bit)
+    return 0; // Already shot here, treated as a miss
+
+  if(!(board->ship_cells & bit)){
+    board->miss_cells |= bit;
+    return 0; // Miss
+  }
+
+  board->hit_cells |= bit;
+  *is_hit = 1;
+
+  // Read the owning ship's index straight out of the bit planes
+  int index = cell_index(row, col);
+  int ship_idx = (int)((board->ship_id_bits[0] >> index) & 1)
+               | (int)(((board->ship_id_bits[1] >> index) & 1) << 1)
+               | (int)(((board->ship_id_bits[2] >> index) & 1) << 2);
+  Ship *s = &board->ships[ship_idx];
+  s->hits++;
+  if(s->hits == s->size){
+    *is_sunk = 1;
+    board->ships_remaining--;
+    if(sunk_type != NULL)
+      *sunk_type = s->type;
+  }
+  return 1; // Hit
+}
+
+int take_shots(PlayerBoard *board, Shot *shots, int count){
+  int hits = 0;
+  for(int i = 0; i < count; i++){
+    Shot *shot = &shots[i];
+    shot->is_hit = 0;
+    shot->is_sunk = 0;
+    shot->sunk_ship = NO_SHIP;
+    if(shot->row >= BOARD_ROWS || shot->col >= BOARD_COLS)
+      continue; // Invalid shot
+    BoardMask bit = cell_bit(shot->row, shot->col);
+    if((board->hit_cells | board->miss_cells) & bit)
+      continue; // Already shot here
+    if(!(board->ship_cells & bit)){
+      board->miss_cells |= bit;
+      continue;
+    }
+    board->hit_cells |= bit;
+    shot->is_hit = 1;
+    hits++;
+    int index = cell_index(shot->row, shot->col);
+    int ship_idx = (int)((board->ship_id_bits[0] >> index) & 1)
+                 | (int)(((board->ship_id_bits[1] >> index) & 1) << 1)
+                 | (int)(((board->ship_id_bits[2] >> index) & 1) << 2);
+    Ship *s = &board->ships[ship_idx];
+    if(++s->hits == s->size){
+      shot->is_sunk = 1;
+      shot->sunk_ship = (int8_t)ship_idx;
+      board->ships_remaining--;
+    }
+  }
+  return hits;
+}
+
+int check_game_over(const PlayerBoard *board){
+  if(board == NULL)
+    return 0;
+  return board->ship_cells != 0 && (board->ship_cells & ~board->hit_cells) == 0;
+}
+
+CellState get_cell(const PlayerBoard *board, int row, int col){
+  if(board == NULL || row < 0 || row >= BOARD_ROWS || col < 0 || col >= BOARD_COLS)
+    return WATER;
+  BoardMask bit = cell_bit(row, col);
+  if(board->hit_cells & bit)
+    return HIT;
+  if(board->miss_cells & bit)
+    return MISS;
+  if(board->ship_cells & bit)
+    return SHIP;
+  return WATER;
+}
+
+void set_cell(PlayerBoard *board, int row, int col, CellState state){
+  if(board == NULL || row < 0 || row >= BOARD_ROWS || col < 0 || col >= BOARD_COLS)
+    return;
+  BoardMask bit = cell_bit(row, col);
+  board->hit_cells &= ~bit;
+  board->miss_cells &= ~bit;
+  switch(state){
+    case HIT:   board->hit_cells |= bit; board->ship_cells |= bit; break;
+    case MISS:  board->miss_cells |= bit; board->ship_cells &= ~bit; break;
+    case SHIP:  board->ship_cells |= bit; break;
+    case WATER: board->ship_cells &= ~bit; break;
+  }
+}
@@ -0,0 +1,129 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "common.h"
+
+// Game journal format (all multi-byte fields little-endian).
+//
+// File header, JOURNAL_HEADER_LEN bytes:
+//   u8  magic[4]     - "BSHJ"
+//   u16 version      - JOURNAL_VERSION
+//   u16 record_len   - JOURNAL_RECORD_LEN
+//   u64 epoch_ns     - wall clock when the file was created
+//
+// Followed by fixed-size records, JOURNAL_RECORD_LEN bytes each:
+//   u32 session_id
+//   u32 time_ms      - milliseconds since epoch_ns
+//   u8  type         - JOURNAL_*
+//   u8  player       - player index the event belongs to (see below)
+//   u16 row
+//   u16 col
+//   i8  ship_type    - fleet index of the placed ship, or of the ship sunk
+//                      by a shot (NO_SHIP otherwise)
+//   u8  flags        - JOURNAL_FLAG_*, orientation as JOURNAL_FLAG_VERTICAL
+//
+// Fixed-size records keep the file seekable and let a reader walk it
+// without parsing lengths.
+#define JOURNAL_MAGIC "BSHJ"
+#define JOURNAL_VERSION 2
+#define JOURNAL_HEADER_LEN 16
+#define JOURNAL_RECORD_LEN 16
+
+#define JOURNAL_GAME_START 1 // player: slot played by the computer, or JOURNAL_NO_PLAYER
+#define JOURNAL_PLACEMENT  2 // player: whose board the ship went on
+#define JOURNAL_SHOT       3 // player: who fired
+#define JOURNAL_GAME_END   4 // player: the winner
+#define JOURNAL_BOARD      5 // Custom games only, right after GAME_START: row x col, ship_type ships
+#define JOURNAL_FLEET      6 // One per ship after JOURNAL_BOARD: ship_type is its index, row its size
+
+#define JOURNAL_NO_PLAYER 0xff
+
+#define JOURNAL_FLAG_HIT        0x01
+#define JOURNAL_FLAG_SUNK       0x02
+#define JOURNAL_FLAG_DISCONNECT 0x04 // Game ended because a player left
+#define JOURNAL_FLAG_CANCELLED  0x08 // Undone before any move, no winner
+#define JOURNAL_FLAG_VERTICAL   0x10 // Placement orientation
+#define JOURNAL_FLAG_SALVO      0x20 // GAME_START: one shot per ship afloat each turn
+#define JOURNAL_FLAG_TIMEOUT    0x40 // GAME_END: the loser ran out of time
+
+typedef struct {
+  uint32_t session_id;
+  uint32_t time_ms;
+  uint8_t type;
+  uint8_t player;
+  uint16_t row;
+  uint16_t col;
+  int8_t ship_type;
+  uint8_t orientation;
+  uint8_t flags;
+} JournalRecord;
+
+static inline void journal_put_u32(uint8_t *p, uint32_t value){
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+  p[2] = (uint8_t)(value >> 16);
+  p[3] = (uint8_t)(value >> 24);
+}
+
+static inline void journal_put_u16(uint8_t *p, uint16_t value){
+  p[0] = (uint8_t)value;
+  p[1] = (uint8_t)(value >> 8);
+}
+
+static inline uint16_t journal_get_u16(const uint8_t *p){
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t journal_get_u32(const uint8_t *p){
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void journal_encode_header(uint8_t *out, uint64_t epoch_ns){
+  memcpy(out, JOURNAL_MAGIC, 4);
+  out[4] = JOURNAL_VERSION;
+  out[5] = 0;
+  out[6] = JOURNAL_RECORD_LEN;
+  out[7] = 0;
+  journal_put_u32(out + 8, (uint32_t)epoch_ns);
+  journal_put_u32(out + 12, (uint32_t)(epoch_ns >> 32));
+}
+
+// Returns 0 if the header is ours and of a supported version, -1 otherwise.
+static inline int journal_decode_header(const uint8_t *p, size_t len, uint64_t *epoch_ns){
+  if(len < JOURNAL_HEADER_LEN || memcmp(p, JOURNAL_MAGIC, 4) != 0)
+    return -1;
+  if(p[4] != JOURNAL_VERSION || p[5] != 0 || p[6] != JOURNAL_RECORD_LEN || p[7] != 0)
+    return -1;
+  if(epoch_ns != NULL)
+    *epoch_ns = (uint64_t)journal_get_u32(p + 8) | ((uint64_t)journal_get_u32(p + 12) << 32);
+  return 0;
+}
+
+static inline void journal_encode_record(const JournalRecord *rec, uint8_t *out){
+  journal_put_u32(out, rec->session_id);
+  journal_put_u32(out + 4, rec->time_ms);
+  out[8] = rec->type;
+  out[9] = rec->player;
+  journal_put_u16(out + 10, rec->row);
+  journal_put_u16(out + 12, rec->col);
+  out[14] = (uint8_t)rec->ship_type;
+  out[15] = (uint8_t)(rec->flags | (rec->orientation == VERTICAL ? JOURNAL_FLAG_VERTICAL : 0));
+}
+
+static inline void journal_decode_record(const uint8_t *p, JournalRecord *rec){
+  rec->session_id = journal_get_u32(p);
+  rec->time_ms = journal_get_u32(p + 4);
+  rec->type = p[8];
+  rec->player = p[9];
+  rec->row = journal_get_u16(p + 10);
+  rec->col = journal_get_u16(p + 12);
+  rec->ship_type = (int8_t)p[14];
+  rec->orientation = (p[15] & JOURNAL_FLAG_VERTICAL) ? VERTICAL : HORIZONTAL;
+  rec->flags = p[15] & (uint8_t)~JOURNAL_FLAG_VERTICAL;
+}
+
+#endif // JOURNAL_H
@@ -0,0 +1,30 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include "bitboard.h"
+#include "placement_table.h" // Generated at build time by src/tools/gen_placements.c
+
+// Cells covered by a ship of the given size whose top-left cell is (row, col),
+// or 0 if any of it would leave the board.
+static inline BoardMask placement_mask(int row, int col, int size, Orientation orientation){
+  if((unsigned)row >= BOARD_ROWS || (unsigned)col >= BOARD_COLS || (unsigned)size > PLACEMENT_MAX_SIZE || (unsigned)orientation > VERTICAL)
+    return 0;
+  return placement_at[size][orientation][cell_index(row, col)];
+}
+
+// Number of legal placements of a ship of the given size.
+static inline int placement_count(int size){
+  if((unsigned)size > PLACEMENT_MAX_SIZE)
+    return 0;
+  return placement_first[size + 1] - placement_first[size];
+}
+
+// The n-th legal placement of a ship of the given size, n < placement_count(size).
+static inline void placement_nth(int size, int n, int *row, int *col, Orientation *orientation){
+  uint16_t entry = placement_list[placement_first[size] + n];
+  *row = (entry >> 1) / BOARD_COLS;
+  *col = (entry >> 1) % BOARD_COLS;
+  *orientation = (entry & 1) ? VERTICAL : HORIZONTAL;
+}
+
+#endif // PLACEMENT_H
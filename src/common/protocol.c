@@ -0,0 +1,215 @@
+#define _GNU_SOURCE
+#include <string.h>
+#include <errno.h>
+#include <sys/socket.h>
+
+#include "protocol.h"
+
+static void put_u16(uint8_t *p, unsigned value){
+  p[0] = (uint8_t)(value & 0xff);
+  p[1] = (uint8_t)((value >> 8) & 0xff);
+}
+
+static unsigned get_u16(const uint8_t *p){
+  return (unsigned)p[0] | ((unsigned)p[1] << 8);
+}
+
+size_t encode_message(const GameMessage *msg, uint8_t *out, size_t cap){
+  if(msg == NULL || out == NULL)
+    return 0;
+
+  size_t text_len = strnlen(msg->message, MAX_MSG_LEN - 1);
+  if(text_len > 255)
+    text_len = 255;
+  if(msg->shot_count < 0 || msg->shot_count > MAX_SALVO)
+    return 0;
+  if(msg->fleet_count < 0 || msg->fleet_count > MAX_FLEET)
+    return 0;
+  size_t shot_count = (size_t)msg->shot_count;
+  size_t fleet_count = (size_t)msg->fleet_count;
+  size_t frame_len = PROTO_HEADER_LEN + PROTO_BODY_LEN + (text_len > 0 ? 1 + text_len : 0) +
+                     (shot_count > 0 ? 1 + shot_count * PROTO_SHOT_LEN : 0) +
+                     (fleet_count > 0 ? 1 + fleet_count * PROTO_PLACEMENT_LEN : 0);
+  if(frame_len > cap || frame_len > PROTO_MAX_FRAME)
+    return 0;
+
+  uint8_t flags = 0;
+  if(msg->success) flags |= PROTO_FLAG_SUCCESS;
+  if(msg->is_hit) flags |= PROTO_FLAG_HIT;
+  if(msg->is_sunk) flags |= PROTO_FLAG_SUNK;
+  if(msg->own_board) flags |= PROTO_FLAG_OWN_BOARD;
+  if(text_len > 0) flags |= PROTO_FLAG_TEXT;
+  if(shot_count > 0) flags |= PROTO_FLAG_SALVO;
+  if(fleet_count > 0) flags |= PROTO_FLAG_FLEET;
+
+  uint8_t *p = out;
+  put_u16(p, (unsigned)(frame_len - PROTO_LEN_FIELD)); p += 2;
+  *p++ = PROTO_VERSION;
+  *p++ = (uint8_t)msg->type;
+  put_u16(p, (unsigned)msg->row); p += 2;
+  put_u16(p, (unsigned)msg->col); p += 2;
+  *p++ = (uint8_t)(int8_t)msg->ship_type;
+  *p++ = (uint8_t)msg->orientation;
+  *p++ = flags;
+  if(text_len > 0){
+    *p++ = (uint8_t)text_len;
+    memcpy(p, msg->message, text_len);
+    p += text_len;
+  }
+  if(shot_count > 0){
+    *p++ = (uint8_t)shot_count;
+    for(size_t i = 0; i < shot_count; i++){
+      const Shot *shot = &msg->shots[i];
+      put_u16(p, shot->row); p += 2;
+      put_u16(p, shot->col); p += 2;
+      *p++ = (uint8_t)((shot->is_hit ? PROTO_FLAG_HIT : 0) | (shot->is_sunk ? PROTO_FLAG_SUNK : 0));
+      *p++ = (uint8_t)shot->sunk_ship;
+    }
+  }
+  if(fleet_count > 0){
+    *p++ = (uint8_t)fleet_count;
+    for(size_t i = 0; i < fleet_count; i++){
+      const ShipPlacement *ship = &msg->fleet[i];
+      put_u16(p, ship->row); p += 2;
+      put_u16(p, ship->col); p += 2;
+      *p++ = ship->orientation;
+    }
+  }
+  return frame_len;
+}
+
+int decode_message(const uint8_t *frame, size_t len, GameMessage *msg){
+  if(frame == NULL || msg == NULL || len < PROTO_HEADER_LEN + PROTO_BODY_LEN)
+    return -1;
+  if(get_u16(frame) + PROTO_LEN_FIELD != len || frame[2] != PROTO_VERSION)
+    return -1;
+
+  const uint8_t *p = frame + PROTO_HEADER_LEN;
+  const uint8_t *end = frame + len;
+  memset(msg, 0, offsetof(GameMessage, shots)); // Shots and ships past their counts are left alone
+  msg->type = frame[3];
+  msg->row = (int)get_u16(p); p += 2;
+  msg->col = (int)get_u16(p); p += 2;
+  msg->ship_type = (ShipType)(int8_t)*p++;
+  msg->orientation = (Orientation)*p++;
+  uint8_t flags = *p++;
+  msg->success = (flags & PROTO_FLAG_SUCCESS) != 0;
+  msg->is_hit = (flags & PROTO_FLAG_HIT) != 0;
+  msg->is_sunk = (flags & PROTO_FLAG_SUNK) != 0;
+  msg->own_board = (flags & PROTO_FLAG_OWN_BOARD) != 0;
+
+  if(flags & PROTO_FLAG_TEXT){
+    if(p >= end)
+      return -1;
+    size_t text_len = *p++;
+    if(p + text_len > end || text_len >= MAX_MSG_LEN)
+      return -1;
+    memcpy(msg->message, p, text_len);
+    msg->message[text_len] = '\0';
+    p += text_len;
+  }
+  if(flags & PROTO_FLAG_SALVO){
+    if(p >= end)
+      return -1;
+    size_t shot_count = *p++;
+    if(shot_count == 0 || shot_count > MAX_SALVO || p + shot_count * PROTO_SHOT_LEN > end)
+      return -1;
+    for(size_t i = 0; i < shot_count; i++){
+      Shot *shot = &msg->shots[i];
+      shot->row = (uint16_t)get_u16(p); p += 2;
+      shot->col = (uint16_t)get_u16(p); p += 2;
+      shot->is_hit = (*p & PROTO_FLAG_HIT) != 0;
+      shot->is_sunk = (*p & PROTO_FLAG_SUNK) != 0;
+      p++;
+      shot->sunk_ship = (int8_t)*p++;
+    }
+    msg->shot_count = (int)shot_count;
+  }
+  if(flags & PROTO_FLAG_FLEET){
+    if(p >= end)
+      return -1;
+    size_t fleet_count = *p++;
+    if(fleet_count == 0 || fleet_count > MAX_FLEET || p + fleet_count * PROTO_PLACEMENT_LEN > end)
+      return -1;
+    for(size_t i = 0; i < fleet_count; i++){
+      ShipPlacement *ship = &msg->fleet[i];
+      ship->row = (uint16_t)get_u16(p); p += 2;
+      ship->col = (uint16_t)get_u16(p); p += 2;
+      ship->orientation = *p++;
+    }
+    msg->fleet_count = (int)fleet_count;
+  }
+  return 0;
+}
+
+void frame_reader_init(FrameReader *reader){
+  reader->start = 0;
+  reader->len = 0;
+}
+
+// Move unconsumed bytes to the front so there is room to read more.
+static void frame_reader_compact(FrameReader *reader){
+  if(reader->start == 0)
+    return;
+  memmove(reader->buf, reader->buf + reader->start, reader->len - reader->start);
+  reader->len -= reader->start;
+  reader->start = 0;
+}
+
+ssize_t frame_reader_recv(FrameReader *reader, int fd){
+  frame_reader_compact(reader);
+  if(reader->len == sizeof(reader->buf)){
+    errno = ENOBUFS;
+    return -1;
+  }
+  ssize_t n = recv(fd, reader->buf + reader->len, sizeof(reader->buf) - reader->len, 0);
+  if(n > 0)
+    reader->len += (size_t)n;
+  return n;
+}
+
+size_t frame_reader_append(FrameReader *reader, const uint8_t *data, size_t len){
+  frame_reader_compact(reader);
+  size_t room = sizeof(reader->buf) - reader->len;
+  if(len > room)
+    len = room;
+  memcpy(reader->buf + reader->len, data, len);
+  reader->len += len;
+  return len;
+}
+
+int frame_reader_next(FrameReader *reader, GameMessage *msg){
+  size_t available = reader->len - reader->start;
+  if(available < PROTO_LEN_FIELD)
+    return 0;
+  const uint8_t *frame = reader->buf + reader->start;
+  size_t frame_len = get_u16(frame) + PROTO_LEN_FIELD;
+  if(frame_len > PROTO_MAX_FRAME || frame_len < PROTO_HEADER_LEN + PROTO_BODY_LEN)
+    return -1;
+  if(available < frame_len)
+    return 0;
+  if(decode_message(frame, frame_len, msg) < 0)
+    return -1;
+  reader->start += frame_len;
+  if(reader->start == reader->len)
+    reader->start = reader->len = 0;
+  return 1;
+}
+
+int send_framed_message(int fd, const GameMessage *msg){
+  uint8_t frame[PROTO_MAX_FRAME];
+  size_t frame_len = encode_message(msg, frame, sizeof(frame));
+  if(frame_len == 0)
+    return -1;
+  size_t sent = 0;
+  while(sent < frame_len){
+    ssize_t n = send(fd, frame + sent, frame_len - sent, MSG_NOSIGNAL);
+    if(n < 0){
+      if(errno == EINTR)
+        continue;
+      return -1;
+    }
+    sent += (size_t)n;
+  }
+  return 0;
+}
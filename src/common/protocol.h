@@ -0,0 +1,77 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "common.h"
+
+// Wire format (all multi-byte fields little-endian):
+//
+//   u16 length   - bytes following this field
+//   u8  version  - PROTO_VERSION
+//   u8  type     - MSG_TYPE_*
+//   u16 row
+//   u16 col
+//   i8  ship_type  - for shot results, the ship sunk or NO_SHIP
+//   u8  orientation
+//   u8  flags    - PROTO_FLAG_*
+//   [u8 text_len, text bytes]  - only when PROTO_FLAG_TEXT is set
+//   [u8 shot_count, shots]     - only when PROTO_FLAG_SALVO is set, each
+//                                u16 row, u16 col, u8 flags (PROTO_FLAG_HIT,
+//                                PROTO_FLAG_SUNK), i8 sunk ship
+//   [u8 fleet_count, ships]    - only when PROTO_FLAG_FLEET is set, each
+//                                u16 row, u16 col, u8 orientation
+//
+// A shot request or result is 11 bytes on the wire, a salvo 12 plus 6 per
+// shot, a classic fleet 37.
+#define PROTO_VERSION 1
+#define PROTO_LEN_FIELD 2
+#define PROTO_HEADER_LEN 4
+#define PROTO_BODY_LEN 7
+#define PROTO_MAX_FRAME 512
+#define PROTO_READ_BUF (PROTO_MAX_FRAME * 2)
+
+#define PROTO_FLAG_SUCCESS   0x01
+#define PROTO_FLAG_HIT       0x02
+#define PROTO_FLAG_SUNK      0x04
+#define PROTO_FLAG_OWN_BOARD 0x08
+#define PROTO_FLAG_FLEET     0x20
+#define PROTO_FLAG_SALVO     0x40
+#define PROTO_FLAG_TEXT      0x80
+#define PROTO_SHOT_LEN 6
+#define PROTO_PLACEMENT_LEN 5
+
+// Accumulates bytes from a stream socket and splits them into frames. Copes
+// with frames split across reads and with several frames in a single read.
+typedef struct {
+  uint8_t buf[PROTO_READ_BUF];
+  size_t start; // First byte not yet consumed
+  size_t len;   // One past the last byte received
+} FrameReader;
+
+// Encode msg into out. Returns the frame size, or 0 if cap is too small.
+size_t encode_message(const GameMessage *msg, uint8_t *out, size_t cap);
+
+// Decode one complete frame (including the length field). Returns 0 on
+// success, -1 if the frame is malformed or of another protocol version.
+int decode_message(const uint8_t *frame, size_t len, GameMessage *msg);
+
+void frame_reader_init(FrameReader *reader);
+
+// recv() as much as fits into the reader. Same return convention as recv().
+ssize_t frame_reader_recv(FrameReader *reader, int fd);
+
+// Copy bytes obtained some other way into the reader. Returns the number of
+// bytes taken, which is less than len when the buffer is full.
+size_t frame_reader_append(FrameReader *reader, const uint8_t *data, size_t len);
+
+// Pop the next complete message. Returns 1 if msg was filled, 0 if more bytes
+// are needed, -1 on a protocol error (the stream cannot be resynchronised).
+int frame_reader_next(FrameReader *reader, GameMessage *msg);
+
+// Blocking send of one message, retrying on short writes. Returns 0 or -1.
+int send_framed_message(int fd, const GameMessage *msg);
+
+#endif // PROTOCOL_H
@@ -0,0 +1,31 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// xorshift64* generator. Cheap, good enough for placements and shot order,
+// and each user keeps its own state so threads never share one.
+static inline uint64_t rng_next(uint64_t *state){
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+  return x * 0x2545F4914F6CDD1DULL;
+}
+
+// Uniform-ish value in [0, n)
+static inline uint32_t rng_below(uint64_t *state, uint32_t n){
+  return (uint32_t)(((rng_next(state) >> 32) * (uint64_t)n) >> 32);
+}
+
+// Seed must be non-zero; mix whatever the caller has into a usable state.
+static inline uint64_t rng_seed(uint64_t seed){
+  seed ^= 0x9E3779B97F4A7C15ULL;
+  seed = (seed ^ (seed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  seed = (seed ^ (seed >> 27)) * 0x94D049BB133111EBULL;
+  seed ^= seed >> 31;
+  return seed ? seed : 1;
+}
+
+#endif // RNG_H
@@ -0,0 +1,224 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+
+#include "shm_ring.h"
+
+_Static_assert((SHM_RING_SIZE & (SHM_RING_SIZE - 1)) == 0, "SHM_RING_SIZE must be a power of two");
+
+#define RING_MASK (SHM_RING_SIZE - 1)
+
+static void wake_peer(ShmEndpoint *ep){
+  uint64_t one = 1;
+  while(write(ep->peer_wake_fd, &one, sizeof(one)) < 0 && errno == EINTR)
+    ;
+  ep->wakes++;
+}
+
+static void set_ends(ShmEndpoint *ep, int server){
+  ep->tx = server ? &ep->channel->to_client : &ep->channel->to_server;
+  ep->rx = server ? &ep->channel->to_server : &ep->channel->to_client;
+  ep->wakes = 0;
+}
+
+static int map_channel(ShmEndpoint *ep, int memfd){
+  if(ftruncate(memfd, sizeof(ShmChannel)) < 0)
+    return -1;
+  ep->channel = mmap(NULL, sizeof(ShmChannel), PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+  if(ep->channel == MAP_FAILED){
+    ep->channel = NULL;
+    return -1;
+  }
+  ep->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  ep->peer_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if(ep->wake_fd < 0 || ep->peer_wake_fd < 0)
+    return -1;
+  return 0;
+}
+
+int shm_server_open(ShmEndpoint *ep, int *memfd){
+  memset(ep, 0, sizeof(*ep));
+  ep->wake_fd = ep->peer_wake_fd = -1;
+  int fd = memfd_create("battleship-shm", MFD_CLOEXEC);
+  if(fd < 0)
+    return -1;
+  if(map_channel(ep, fd) < 0){
+    int saved = errno;
+    shm_close(ep);
+    close(fd);
+    errno = saved;
+    return -1;
+  }
+  set_ends(ep, 1);
+  // Both sides start out asleep: the first frame either way wakes its reader
+  atomic_store(&ep->channel->to_server.consumer_waiting, 1);
+  atomic_store(&ep->channel->to_client.consumer_waiting, 1);
+  *memfd = fd;
+  return 0;
+}
+
+int shm_client_attach(ShmEndpoint *ep, const int fds[SHM_FDS]){
+  memset(ep, 0, sizeof(*ep));
+  ep->wake_fd = fds[1];
+  ep->peer_wake_fd = fds[2];
+  ep->channel = mmap(NULL, sizeof(ShmChannel), PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+  close(fds[0]);
+  if(ep->channel == MAP_FAILED){
+    int saved = errno;
+    ep->channel = NULL;
+    shm_close(ep);
+    errno = saved;
+    return -1;
+  }
+  set_ends(ep, 0);
+  return 0;
+}
+
+void shm_close(ShmEndpoint *ep){
+  if(ep->channel != NULL)
+    munmap(ep->channel, sizeof(ShmChannel));
+  if(ep->wake_fd >= 0)
+    close(ep->wake_fd);
+  if(ep->peer_wake_fd >= 0)
+    close(ep->peer_wake_fd);
+  ep->channel = NULL;
+  ep->tx = ep->rx = NULL;
+  ep->wake_fd = ep->peer_wake_fd = -1;
+}
+
+static size_t ring_put(ShmRing *ring, const uint8_t *data, size_t len){
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+  size_t room = SHM_RING_SIZE - (tail - head);
+  if(len > room)
+    len = room;
+  size_t at = tail & RING_MASK;
+  size_t first = (len < SHM_RING_SIZE - at) ? len : SHM_RING_SIZE - at;
+  memcpy(ring->data + at, data, first);
+  memcpy(ring->data, data + first, len - first);
+  atomic_store_explicit(&ring->tail, tail + (uint32_t)len, memory_order_release);
+  return len;
+}
+
+static size_t ring_get(ShmRing *ring, uint8_t *buf, size_t len){
+  uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+  size_t available = tail - head;
+  if(len > available)
+    len = available;
+  size_t at = head & RING_MASK;
+  size_t first = (len < SHM_RING_SIZE - at) ? len : SHM_RING_SIZE - at;
+  memcpy(buf, ring->data + at, first);
+  memcpy(buf + first, ring->data, len - first);
+  atomic_store_explicit(&ring->head, head + (uint32_t)len, memory_order_release);
+  return len;
+}
+
+// Each side stores its own flag and then loads the other's counter, with a
+// full fence in between, so of a sleeper and a writer at least one sees
+// the other: no wakeup is lost.
+size_t shm_write(ShmEndpoint *ep, const void *data, size_t len){
+  ShmRing *ring = ep->tx;
+  size_t written = 0;
+  for(;;){
+    written += ring_put(ring, (const uint8_t *)data + written, len - written);
+    if(written == len)
+      break;
+    atomic_store_explicit(&ring->producer_waiting, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    if(atomic_load_explicit(&ring->head, memory_order_relaxed) == atomic_load_explicit(&ring->tail, memory_order_relaxed) - SHM_RING_SIZE)
+      break; // Still full: the peer wakes us when it reads
+  }
+  if(written > 0){
+    atomic_thread_fence(memory_order_seq_cst);
+    if(atomic_load_explicit(&ring->consumer_waiting, memory_order_relaxed) &&
+       atomic_exchange_explicit(&ring->consumer_waiting, 0, memory_order_relaxed))
+      wake_peer(ep);
+  }
+  return written;
+}
+
+size_t shm_read(ShmEndpoint *ep, void *buf, size_t len){
+  ShmRing *ring = ep->rx;
+  size_t n = ring_get(ring, buf, len);
+  if(n > 0){
+    atomic_thread_fence(memory_order_seq_cst);
+    if(atomic_load_explicit(&ring->producer_waiting, memory_order_relaxed) &&
+       atomic_exchange_explicit(&ring->producer_waiting, 0, memory_order_relaxed))
+      wake_peer(ep);
+  }
+  return n;
+}
+
+int shm_prepare_wait(ShmEndpoint *ep){
+  ShmRing *ring = ep->rx;
+  atomic_store_explicit(&ring->consumer_waiting, 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  return atomic_load_explicit(&ring->tail, memory_order_relaxed) != atomic_load_explicit(&ring->head, memory_order_relaxed);
+}
+
+void shm_clear_wake(ShmEndpoint *ep){
+  uint64_t count;
+  while(read(ep->wake_fd, &count, sizeof(count)) < 0 && errno == EINTR)
+    ;
+}
+
+ssize_t shm_send_fds(int sock, const void *data, size_t len, const int *fds, int nfds){
+  union {
+    struct cmsghdr align;
+    char buf[CMSG_SPACE(sizeof(int) * SHM_FDS)];
+  } control;
+  struct iovec iov = {(void *)data, len};
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  memset(&control, 0, sizeof(control));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = CMSG_SPACE(sizeof(int) * (size_t)nfds);
+  struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int) * (size_t)nfds);
+  memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * (size_t)nfds);
+  ssize_t n;
+  while((n = sendmsg(sock, &msg, MSG_NOSIGNAL)) < 0 && errno == EINTR)
+    ;
+  return n;
+}
+
+ssize_t shm_recv_fds(int sock, void *buf, size_t len, int *fds, int max_fds, int *nfds){
+  union {
+    struct cmsghdr align;
+    char buf[CMSG_SPACE(sizeof(int) * SHM_FDS)];
+  } control;
+  struct iovec iov = {buf, len};
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control.buf;
+  msg.msg_controllen = sizeof(control.buf);
+  *nfds = 0;
+  ssize_t n = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+  if(n < 0)
+    return n;
+  for(struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)){
+    if(cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+      continue;
+    int count = (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+    for(int i = 0; i < count; i++){
+      int fd;
+      memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+      if(*nfds < max_fds)
+        fds[(*nfds)++] = fd;
+      else
+        close(fd);
+    }
+  }
+  return n;
+}
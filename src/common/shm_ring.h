@@ -0,0 +1,84 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/types.h>
+
+// Shared-memory transport for clients on the same host as the server. A
+// client connected over the Unix socket asks for it with MSG_TYPE_SHM_REQ
+// and gets, along with MSG_TYPE_SHM_RES, a memfd holding two
+// single-producer single-consumer byte rings, one per direction, and one
+// eventfd per side. From then on frames go through the rings in the same
+// wire format as on the socket; the socket stays open only so each side
+// notices the other going away.
+//
+// A side blocks on its eventfd only after flagging it in the ring it reads
+// from, and a producer writes the peer's eventfd only when that flag is
+// set, so while both sides are busy an exchange makes no system calls.
+
+#define SHM_RING_SIZE 65536 // Bytes per direction, a power of two
+#define SHM_CACHE_LINE 64
+#define SHM_FDS 3 // Passed with MSG_TYPE_SHM_RES: memfd, the client's eventfd, the server's
+
+typedef struct {
+  // Written by the consumer
+  _Alignas(SHM_CACHE_LINE) _Atomic uint32_t head;
+  _Atomic uint32_t consumer_waiting; // About to sleep on its eventfd
+  // Written by the producer
+  _Alignas(SHM_CACHE_LINE) _Atomic uint32_t tail;
+  _Atomic uint32_t producer_waiting; // Found the ring full
+  _Alignas(SHM_CACHE_LINE) uint8_t data[SHM_RING_SIZE];
+} ShmRing;
+
+typedef struct {
+  ShmRing to_server;
+  ShmRing to_client;
+} ShmChannel;
+
+// One side's view of a channel.
+typedef struct {
+  ShmChannel *channel; // NULL while the connection uses its socket
+  ShmRing *tx;
+  ShmRing *rx;
+  int wake_fd;      // Ours; the peer writes it
+  int peer_wake_fd;
+  uint64_t wakes;   // Writes to peer_wake_fd so far
+} ShmEndpoint;
+
+// Server side: map a fresh channel. The client gets *memfd, which the
+// server closes after sending it, and both eventfds. Returns -1 with errno
+// set on failure.
+int shm_server_open(ShmEndpoint *ep, int *memfd);
+
+// Client side: map the channel passed with MSG_TYPE_SHM_RES. Takes
+// ownership of the descriptors (memfd is closed once mapped).
+int shm_client_attach(ShmEndpoint *ep, const int fds[SHM_FDS]);
+
+void shm_close(ShmEndpoint *ep);
+
+// Copy as much of data as fits into the peer-bound ring and wake the peer
+// if it sleeps. Returns the bytes taken; when that is short of len the
+// peer wakes us once it has made room.
+size_t shm_write(ShmEndpoint *ep, const void *data, size_t len);
+
+// Take up to len bytes from our ring, waking a peer that waits for room.
+size_t shm_read(ShmEndpoint *ep, void *buf, size_t len);
+
+// Call once shm_read() returns 0, before waiting on wake_fd: flags us as
+// asleep and returns 1 if bytes slipped in meanwhile, so read again.
+int shm_prepare_wait(ShmEndpoint *ep);
+
+// Reset wake_fd after it polled readable.
+void shm_clear_wake(ShmEndpoint *ep);
+
+// Send a frame over a Unix socket with descriptors attached. Returns the
+// bytes sent or -1.
+ssize_t shm_send_fds(int sock, const void *data, size_t len, const int *fds, int nfds);
+
+// recv() that also collects descriptors sent with shm_send_fds(); *nfds is
+// how many arrived (0 most of the time).
+ssize_t shm_recv_fds(int sock, void *buf, size_t len, int *fds, int max_fds, int *nfds);
+
+#endif // SHM_RING_H
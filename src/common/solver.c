@@ -0,0 +1,462 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "solver.h"
+#include "game_logic.h"
+#include "placement.h"
+
+#define COUNT_TABLE_SIZE (1u << 16)  // Memoised layout counts, direct mapped
+#define SEARCH_TABLE_SIZE (1u << 16) // Positions scored by the shot search
+#define LEVEL_INITIAL 1024
+#define LEVEL_MAX (1u << 18) // Slots per ship in the chance pass; past that the budget is gone anyway
+#define MAX_PLACEMENTS (2 * BOARD_CELLS)
+#define MAX_DEPTH 32
+#define CLOCK_EVERY 256 // Nodes between looks at the clock
+
+typedef struct {
+  BoardMask taken;
+  double count;
+  uint32_t generation; // Entries of earlier positions read as empty
+  int ship;
+} CountEntry;
+
+typedef struct {
+  uint64_t key; // 0 for a free slot
+  double expected;
+  int depth;
+  int solved;
+} SearchEntry;
+
+typedef struct {
+  BoardMask taken;
+  double weight;  // Ways to reach taken
+  uint32_t stamp; // Slots of an earlier pass read as free
+} LevelEntry;
+
+// Partial layouts of the first few ships, merged by the cells they take.
+typedef struct {
+  LevelEntry *slots;
+  size_t mask;
+  uint32_t *filled; // Slots in use, in the order they were taken
+  size_t used;
+  uint32_t stamp;
+} Level;
+
+// The ships afloat in one position, largest first, and every placement
+// each may still have.
+typedef struct {
+  int count;
+  int type[NUM_SHIPS];
+  int slack[NUM_SHIPS + 1]; // Open hits ships k.. can still cover, one fresh cell each left over
+  int placements[NUM_SHIPS];
+  BoardMask cells[NUM_SHIPS][MAX_PLACEMENTS];
+  BoardMask hits;
+} Fleet;
+
+// How the layouts of a position split on each cell.
+typedef struct {
+  double total;
+  double hit[BOARD_CELLS];            // Layouts with a ship on an unshot cell
+  double sink[NUM_SHIPS][BOARD_CELLS]; // Of those, layouts where the shot sinks that ship type
+} Outcomes;
+
+struct Solver {
+  CountEntry *counts;
+  SearchEntry *searches;
+  Level level[2];
+  Fleet fleet;
+  Outcomes root;
+  uint32_t generation;
+  uint64_t deadline_ns;
+  uint64_t nodes;
+  int out_of_time;
+};
+
+static uint64_t now_ns(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t mix64(uint64_t x){
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ULL;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBULL;
+  x ^= x >> 31;
+  return x;
+}
+
+static uint64_t mask_hash(BoardMask mask, uint64_t salt){
+  return mix64((uint64_t)mask ^ mix64((uint64_t)(mask >> 64) ^ salt));
+}
+
+static int out_of_time(Solver *solver){
+  if(!solver->out_of_time && ++solver->nodes % CLOCK_EVERY == 0 && now_ns() >= solver->deadline_ns)
+    solver->out_of_time = 1;
+  return solver->out_of_time;
+}
+
+Solver *solver_create(void){
+  Solver *solver = calloc(1, sizeof(*solver));
+  if(solver == NULL)
+    return NULL;
+  solver->counts = calloc(COUNT_TABLE_SIZE, sizeof(*solver->counts));
+  solver->searches = calloc(SEARCH_TABLE_SIZE, sizeof(*solver->searches));
+  for(int i = 0; i < 2; i++){
+    solver->level[i].slots = calloc(LEVEL_INITIAL, sizeof(LevelEntry));
+    solver->level[i].filled = malloc(LEVEL_INITIAL / 2 * sizeof(uint32_t));
+    solver->level[i].mask = LEVEL_INITIAL - 1;
+  }
+  if(solver->counts == NULL || solver->searches == NULL || solver->level[0].slots == NULL || solver->level[1].slots == NULL ||
+     solver->level[0].filled == NULL || solver->level[1].filled == NULL){
+    solver_destroy(solver);
+    return NULL;
+  }
+  return solver;
+}
+
+void solver_destroy(Solver *solver){
+  if(solver == NULL)
+    return;
+  free(solver->counts);
+  free(solver->searches);
+  for(int i = 0; i < 2; i++){
+    free(solver->level[i].slots);
+    free(solver->level[i].filled);
+  }
+  free(solver);
+}
+
+static void level_clear(Level *level){
+  if(++level->stamp == 0){
+    memset(level->slots, 0, (level->mask + 1) * sizeof(LevelEntry));
+    level->stamp = 1;
+  }
+  level->used = 0;
+}
+
+static LevelEntry *level_slot(LevelEntry *slots, size_t mask, uint32_t stamp, BoardMask taken){
+  size_t i = (size_t)mask_hash(taken, 0) & mask;
+  while(slots[i].stamp == stamp && slots[i].taken != taken)
+    i = (i + 1) & mask;
+  return &slots[i];
+}
+
+// Kept at most half full. Returns -1 once it would outgrow LEVEL_MAX.
+static int level_add(Level *level, BoardMask taken, double weight){
+  if((level->used + 1) * 2 > level->mask + 1){
+    size_t size = (level->mask + 1) * 2;
+    if(size > LEVEL_MAX)
+      return -1;
+    LevelEntry *slots = calloc(size, sizeof(LevelEntry));
+    uint32_t *filled = malloc(size / 2 * sizeof(uint32_t));
+    if(slots == NULL || filled == NULL){
+      free(slots);
+      free(filled);
+      return -1;
+    }
+    for(size_t i = 0; i < level->used; i++){
+      LevelEntry *slot = level_slot(slots, size - 1, level->stamp, level->slots[level->filled[i]].taken);
+      *slot = level->slots[level->filled[i]];
+      filled[i] = (uint32_t)(slot - slots);
+    }
+    free(level->slots);
+    free(level->filled);
+    level->slots = slots;
+    level->filled = filled;
+    level->mask = size - 1;
+  }
+  LevelEntry *slot = level_slot(level->slots, level->mask, level->stamp, taken);
+  if(slot->stamp != level->stamp){
+    slot->taken = taken;
+    slot->weight = 0;
+    slot->stamp = level->stamp;
+    level->filled[level->used++] = (uint32_t)(slot - level->slots);
+  }
+  slot->weight += weight;
+  return 0;
+}
+
+static int ship_cells_left(const AiPlayer *view){
+  int cells = 0, ships = 0;
+  for(int type = 0; type < NUM_SHIPS; type++){
+    if(view->ship_alive[type]){
+      cells += get_ship_size((ShipType)type);
+      ships++;
+    }
+  }
+  cells -= mask_popcount(view->open_hits);
+  return cells > ships ? cells : ships; // Every ship afloat takes one more shot at least; 0 once all are sunk
+}
+
+// A ship afloat avoids misses and sunk ships and still has a cell nobody
+// fired at, or it would have been sunk. Start cells are filtered a whole
+// board at a time as in the density kernel of ai.c.
+static void build_fleet(Fleet *fleet, const AiPlayer *view){
+  BoardMask free_cells = full_board_mask() & ~(view->misses | view->sunk_cells);
+  fleet->count = 0;
+  fleet->hits = view->open_hits;
+  for(int size = PLACEMENT_MAX_SIZE; size > 0; size--){
+    for(int type = 0; type < NUM_SHIPS; type++){
+      if(!view->ship_alive[type] || get_ship_size((ShipType)type) != size)
+        continue;
+      int k = fleet->count++;
+      fleet->type[k] = type;
+      fleet->placements[k] = 0;
+      for(int orientation = HORIZONTAL; orientation <= VERTICAL; orientation++){
+        int step = (orientation == HORIZONTAL) ? 1 : BOARD_COLS;
+        BoardMask starts = placement_starts[size][orientation];
+        BoardMask all_hit = starts;
+        for(int j = 0; j < size; j++){
+          starts &= free_cells >> (j * step);
+          all_hit &= view->open_hits >> (j * step);
+        }
+        for(starts &= ~all_hit; starts; starts &= starts - 1)
+          fleet->cells[k][fleet->placements[k]++] = placement_at[size][orientation][mask_lowest_index(starts)];
+      }
+    }
+  }
+  fleet->slack[fleet->count] = 0;
+  for(int k = fleet->count - 1; k >= 0; k--)
+    fleet->slack[k] = fleet->slack[k + 1] + get_ship_size((ShipType)fleet->type[k]) - 1;
+}
+
+// Ways to place ships k.. around the cells taken so every open hit ends up
+// covered.
+static double count_layouts(Solver *solver, int k, BoardMask taken){
+  const Fleet *fleet = &solver->fleet;
+  BoardMask open = fleet->hits & ~taken;
+  if(k == fleet->count)
+    return open == 0;
+  if(mask_popcount(open) > fleet->slack[k] || out_of_time(solver))
+    return 0;
+  CountEntry *entry = &solver->counts[mask_hash(taken, (uint64_t)k) & (COUNT_TABLE_SIZE - 1)];
+  if(entry->generation == solver->generation && entry->ship == k && entry->taken == taken)
+    return entry->count;
+
+  double total = 0;
+  for(int i = 0; i < fleet->placements[k]; i++){
+    BoardMask cells = fleet->cells[k][i];
+    if(!(cells & taken))
+      total += count_layouts(solver, k + 1, taken | cells);
+  }
+  if(solver->out_of_time)
+    return 0; // Partial, must not be remembered
+  entry->taken = taken;
+  entry->ship = k;
+  entry->generation = solver->generation;
+  entry->count = total;
+  return total;
+}
+
+// Count the layouts consistent with view, then walk them ship by ship with
+// partial layouts merged on the cells they take: each placement is weighed
+// by the ways to reach it times the ways to finish from it. Returns 0 when
+// out of time or when no layout fits.
+static int count_outcomes(Solver *solver, const AiPlayer *view, Outcomes *out){
+  Fleet *fleet = &solver->fleet;
+  solver->generation++;
+  build_fleet(fleet, view);
+  memset(out, 0, sizeof(*out));
+  out->total = count_layouts(solver, 0, 0);
+  if(solver->out_of_time || out->total == 0)
+    return 0;
+
+  level_clear(&solver->level[0]);
+  level_add(&solver->level[0], 0, 1);
+  for(int k = 0; k < fleet->count; k++){
+    Level *level = &solver->level[k & 1];
+    Level *next = &solver->level[(k + 1) & 1];
+    level_clear(next);
+    for(size_t s = 0; s < level->used; s++){
+      if(out_of_time(solver))
+        return 0;
+      BoardMask taken = level->slots[level->filled[s]].taken;
+      double weight = level->slots[level->filled[s]].weight;
+      for(int i = 0; i < fleet->placements[k]; i++){
+        BoardMask cells = fleet->cells[k][i];
+        if(cells & taken)
+          continue;
+        double rest = count_layouts(solver, k + 1, taken | cells);
+        if(rest == 0)
+          continue;
+        double layouts = weight * rest;
+        BoardMask fresh = cells & ~fleet->hits;
+        if((fresh & (fresh - 1)) == 0)
+          out->sink[fleet->type[k]][mask_lowest_index(fresh)] += layouts;
+        for(; fresh; fresh &= fresh - 1)
+          out->hit[mask_lowest_index(fresh)] += layouts;
+        if(k + 1 < fleet->count && level_add(next, taken | cells, weight) < 0){
+          solver->out_of_time = 1;
+          return 0;
+        }
+      }
+    }
+    if(solver->out_of_time)
+      return 0;
+  }
+  return 1;
+}
+
+static double search(Solver *solver, const AiPlayer *view, int depth, int *solved);
+
+// Best expected shots over every cell that may hold a ship, with each
+// outcome of the shot searched depth - 1 further. Cells go likeliest first
+// and are skipped when even one shot per unhit ship cell after each
+// outcome cannot beat the best so far.
+static double score_moves(Solver *solver, const AiPlayer *view, const Outcomes *out, int depth, int *solved, int *best_cell){
+  int order[BOARD_CELLS], moves = 0;
+  for(int c = 0; c < BOARD_CELLS; c++){
+    if(out->hit[c] == 0)
+      continue;
+    int at = moves++;
+    for(; at > 0 && out->hit[order[at - 1]] < out->hit[c]; at--)
+      order[at] = order[at - 1];
+    order[at] = c;
+  }
+
+  double best = 0;
+  *best_cell = -1;
+  *solved = 0;
+  for(int m = 0; m < moves; m++){
+    int c = order[m];
+    int row = c / BOARD_COLS, col = c % BOARD_COLS;
+    // Miss, hit without a sinking, then one child per ship type it may sink
+    AiPlayer child[NUM_SHIPS + 2];
+    double chance[NUM_SHIPS + 2];
+    int children = 0;
+    double plain = out->hit[c];
+    for(int type = 0; type < NUM_SHIPS; type++)
+      plain -= out->sink[type][c];
+    for(int k = -2; k < NUM_SHIPS; k++){
+      double layouts = k == -2 ? out->total - out->hit[c] : k == -1 ? plain : out->sink[k][c];
+      if(layouts <= 0)
+        continue;
+      child[children] = *view;
+      ai_observe(&child[children], row, col, k != -2, k < 0 ? NO_SHIP : (ShipType)k);
+      chance[children++] = layouts / out->total;
+    }
+    double bound = 1;
+    for(int i = 0; i < children; i++)
+      bound += chance[i] * ship_cells_left(&child[i]);
+    if(*best_cell >= 0 && bound >= best)
+      continue;
+
+    double value = 1;
+    int all_solved = 1, sub_solved;
+    for(int i = 0; i < children; i++){
+      value += chance[i] * search(solver, &child[i], depth - 1, &sub_solved);
+      all_solved &= sub_solved;
+    }
+    if(solver->out_of_time)
+      return 0;
+    if(*best_cell < 0 || value < best){
+      best = value;
+      *best_cell = c;
+      *solved = all_solved;
+    }
+  }
+  return best;
+}
+
+static uint64_t position_key(const AiPlayer *view){
+  uint64_t alive = 0;
+  for(int type = 0; type < NUM_SHIPS; type++)
+    alive |= (uint64_t)(view->ship_alive[type] != 0) << type;
+  uint64_t key = mask_hash(view->open_hits, mask_hash(view->misses, mask_hash(view->sunk_cells, alive)));
+  return key ? key : 1;
+}
+
+// Expected shots to sink every ship left in view when playing the best
+// shot for the next depth turns, after which every unhit ship cell counts
+// as one more shot. *solved is set when no line was cut short.
+static double search(Solver *solver, const AiPlayer *view, int depth, int *solved){
+  int left = ship_cells_left(view);
+  *solved = 0;
+  if(left == 0){
+    *solved = 1;
+    return 0;
+  }
+  if(depth == 0)
+    return left;
+  uint64_t key = position_key(view);
+  SearchEntry *entry = &solver->searches[key & (SEARCH_TABLE_SIZE - 1)];
+  if(entry->key == key && (entry->solved || entry->depth >= depth)){
+    *solved = entry->solved;
+    return entry->expected;
+  }
+
+  Outcomes out;
+  if(!count_outcomes(solver, view, &out))
+    return left; // Out of time, which the caller checks, or a view no layout fits
+  int best_cell;
+  double expected = score_moves(solver, view, &out, depth, solved, &best_cell);
+  if(solver->out_of_time || best_cell < 0)
+    return left;
+  entry->key = key;
+  entry->expected = expected;
+  entry->depth = depth;
+  entry->solved = *solved;
+  return expected;
+}
+
+// Over budget: spread the ship cells still to find over the density map.
+static void estimate(const AiPlayer *view, SolverResult *result){
+  uint16_t density[BOARD_CELLS];
+  ai_heatmap(view, density);
+  BoardMask unshot = full_board_mask() & ~(view->open_hits | view->sunk_cells | view->misses);
+  double sum = 0;
+  for(BoardMask m = unshot; m; m &= m - 1)
+    sum += density[mask_lowest_index(m)];
+  double left = ship_cells_left(view);
+  for(BoardMask m = unshot; m; m &= m - 1){
+    int c = mask_lowest_index(m);
+    double chance = sum > 0 ? density[c] * left / sum : 0;
+    result->hit_chance[c] = (float)(chance < 1 ? chance : 1);
+  }
+  AiPlayer scratch = *view;
+  ai_choose_shot(&scratch, &result->row, &result->col);
+}
+
+void solver_analyze(Solver *solver, const AiPlayer *view, uint64_t budget_ns, SolverResult *result){
+  memset(result, 0, sizeof(*result));
+  solver->deadline_ns = now_ns() + budget_ns;
+  solver->nodes = 0;
+  solver->out_of_time = 0;
+
+  Outcomes *out = &solver->root;
+  if(!count_outcomes(solver, view, out)){
+    estimate(view, result);
+    return;
+  }
+  result->exact = 1;
+  result->layouts = out->total;
+  int best = -1;
+  for(int c = 0; c < BOARD_CELLS; c++){
+    result->hit_chance[c] = (float)(out->hit[c] / out->total);
+    if(out->hit[c] > 0 && (best < 0 || out->hit[c] > out->hit[best]))
+      best = c;
+  }
+  for(int depth = 1; depth <= MAX_DEPTH && best >= 0; depth++){
+    int solved, cell;
+    double expected = score_moves(solver, view, out, depth, &solved, &cell);
+    if(solver->out_of_time || cell < 0)
+      break;
+    best = cell;
+    result->depth = depth;
+    result->solved = solved;
+    result->expected_shots = expected;
+    if(solved)
+      break;
+  }
+  if(best < 0){
+    memset(result, 0, sizeof(*result));
+    estimate(view, result); // Nothing left afloat
+    return;
+  }
+  result->row = best / BOARD_COLS;
+  result->col = best % BOARD_COLS;
+}
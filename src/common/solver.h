@@ -0,0 +1,48 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdint.h>
+
+#include "common.h"
+#include "bitboard.h"
+#include "ai.h"
+
+// Endgame analysis of the classic board from a shooter's point of view: the
+// same fog-of-war state the computer player keeps (open hits, sunk cells,
+// misses and the ships still afloat).
+//
+// Once few ships and cells are left, every fleet layout consistent with that
+// state can be counted. Layouts are counted ship by ship, memoised on the
+// cells already taken, which gives exact per-cell hit chances under a
+// uniform prior over layouts. The next shot is then searched for with
+// iterative deepening: each pass looks one shot further ahead, scoring the
+// outcomes (miss, hit, hit and sunk) by their exact chances and positions
+// seen before from a transposition table, until the position is solved or
+// the time budget runs out. When even the count does not fit the budget,
+// as early in a game, the answer falls back to the density heuristic of
+// ai.h.
+
+typedef struct Solver Solver;
+
+typedef struct {
+  float hit_chance[BOARD_CELLS]; // Per cell_index(); 0 for cells already shot
+  int row;                       // Suggested shot
+  int col;
+  int exact;                     // Chances come from every consistent layout
+  double layouts;                // Consistent layouts counted, when exact
+  int depth;                     // Shots looked ahead by the last finished pass, 0 if none
+  int solved;                    // That pass reached the end of every line: the move is optimal
+  double expected_shots;         // Shots to sink the rest, the suggested one included, by that pass; a lower bound unless solved
+} SolverResult;
+
+// Tables are allocated once and reused by every analysis. NULL if memory
+// is short.
+Solver *solver_create(void);
+
+void solver_destroy(Solver *solver);
+
+// Analyse view within budget_ns. Always fills result; the suggested shot
+// is never a cell already shot while one is left.
+void solver_analyze(Solver *solver, const AiPlayer *view, uint64_t budget_ns, SolverResult *result);
+
+#endif // SOLVER_H
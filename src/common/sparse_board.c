@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sparse_board.h"
+
+static uint32_t slot_of(uint32_t cell, uint32_t mask){
+  return (uint32_t)(((uint64_t)cell * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+
+// Slot holding cell, or the empty slot where it would go.
+static uint32_t find_slot(const SparseBoard *board, uint32_t cell){
+  uint32_t mask = board->cap - 1;
+  uint32_t i = slot_of(cell, mask);
+  while(board->cells[i].cell != SPARSE_NO_CELL && board->cells[i].cell != cell)
+    i = (i + 1) & mask;
+  return i;
+}
+
+static const SparseCell *lookup(const SparseBoard *board, uint32_t cell){
+  if(board->cap == 0)
+    return NULL;
+  const SparseCell *slot = &board->cells[find_slot(board, cell)];
+  return slot->cell == cell ? slot : NULL;
+}
+
+// Make room for extra more cells, keeping the table at most half full.
+static int reserve(SparseBoard *board, uint32_t extra){
+  if((uint64_t)(board->used + extra) * 2 <= board->cap)
+    return 0;
+  uint32_t cap = board->cap ? board->cap : 64;
+  while((uint64_t)(board->used + extra) * 2 > cap)
+    cap *= 2;
+  size_t bytes = (size_t)cap * sizeof(SparseCell);
+  SparseCell *cells = board->alloc ? board->alloc(board->alloc_ctx, bytes) : malloc(bytes);
+  if(cells == NULL)
+    return -1;
+  for(uint32_t i = 0; i < cap; i++)
+    cells[i].cell = SPARSE_NO_CELL;
+
+  SparseCell *old = board->cells;
+  uint32_t old_cap = board->cap;
+  board->cells = cells;
+  board->cap = cap;
+  for(uint32_t i = 0; i < old_cap; i++)
+    if(old[i].cell != SPARSE_NO_CELL)
+      board->cells[find_slot(board, old[i].cell)] = old[i];
+  if(!board->borrowed)
+    free(old);
+  board->borrowed = (board->alloc != NULL);
+  return 0;
+}
+
+// Existing entry for cell, or a new water entry. reserve() must have made room.
+static SparseCell *upsert(SparseBoard *board, uint32_t cell){
+  SparseCell *slot = &board->cells[find_slot(board, cell)];
+  if(slot->cell == SPARSE_NO_CELL){
+    slot->cell = cell;
+    slot->ship = -1;
+    slot->shot = 0;
+    board->used++;
+  }
+  return slot;
+}
+
+static int on_board(const SparseBoard *board, int row, int col){
+  return row >= 0 && row < board->rows && col >= 0 && col < board->cols;
+}
+
+static uint32_t cell_key(const SparseBoard *board, int row, int col){
+  return (uint32_t)row * (uint32_t)board->cols + (uint32_t)col;
+}
+
+void sparse_board_init(SparseBoard *board, int rows, int cols, int num_ships, const unsigned short *ship_sizes){
+  memset(board, 0, sizeof(*board));
+  board->rows = rows;
+  board->cols = cols;
+  board->num_ships = num_ships;
+  board->ships_remaining = num_ships;
+  for(int i = 0; i < num_ships; i++)
+    board->ships[i] = (Ship){(ShipType)i, ship_sizes[i], -1, -1, HORIZONTAL, 0, 0};
+}
+
+void sparse_board_free(SparseBoard *board){
+  if(!board->borrowed)
+    free(board->cells);
+  board->borrowed = 0;
+  board->cells = NULL;
+  board->cap = board->used = 0;
+}
+
+int sparse_can_place_ship(const SparseBoard *board, const Ship *ship){
+  if(board == NULL || ship == NULL || ship->size <= 0)
+    return 0;
+  int last_row = ship->row + (ship->orientation == VERTICAL ? ship->size - 1 : 0);
+  int last_col = ship->col + (ship->orientation == HORIZONTAL ? ship->size - 1 : 0);
+  if(!on_board(board, ship->row, ship->col) || !on_board(board, last_row, last_col))
+    return 0;
+  for(int i = 0; i < ship->size; i++){
+    int r = ship->row + (ship->orientation == VERTICAL ? i : 0);
+    int c = ship->col + (ship->orientation == HORIZONTAL ? i : 0);
+    const SparseCell *slot = lookup(board, cell_key(board, r, c));
+    if(slot != NULL && slot->ship >= 0)
+      return 0;
+  }
+  return 1;
+}
+
+int sparse_place_ship(SparseBoard *board, const Ship *ship){
+  int idx = (int)ship->type;
+  if(idx < 0 || idx >= board->num_ships || board->ships[idx].is_placed){
+    fprintf(stderr, "Error: No unplaced ship %d available.\n", idx);
+    return -1;
+  }
+  Ship *target = &board->ships[idx];
+  if(reserve(board, (uint32_t)target->size) < 0)
+    return -1;
+  target->row = ship->row;
+  target->col = ship->col;
+  target->orientation = ship->orientation;
+  target->is_placed = 1;
+  for(int i = 0; i < target->size; i++){
+    int r = ship->row + (ship->orientation == VERTICAL ? i : 0);
+    int c = ship->col + (ship->orientation == HORIZONTAL ? i : 0);
+    upsert(board, cell_key(board, r, c))->ship = (int8_t)idx;
+  }
+  return 0;
+}
+
+int sparse_take_shot(SparseBoard *board, int row, int col, int *is_hit, int *is_sunk, int *sunk_ship){
+  *is_hit = 0;
+  *is_sunk = 0;
+  if(sunk_ship != NULL)
+    *sunk_ship = NO_SHIP;
+  if(board == NULL || !on_board(board, row, col) || reserve(board, 1) < 0)
+    return 0; // Invalid shot
+
+  SparseCell *slot = upsert(board, cell_key(board, row, col));
+  if(slot->shot)
+    return 0; // Already shot here, treated as a miss
+  slot->shot = 1;
+  board->shots++;
+  if(slot->ship < 0)
+    return 0; // Miss
+
+  *is_hit = 1;
+  Ship *s = &board->ships[slot->ship];
+  s->hits++;
+  if(s->hits == s->size){
+    *is_sunk = 1;
+    board->ships_remaining--;
+    if(sunk_ship != NULL)
+      *sunk_ship = slot->ship;
+  }
+  return 1; // Hit
+}
+
+int sparse_take_shots(SparseBoard *board, Shot *shots, int count){
+  int hits = 0;
+  int room = reserve(board, (uint32_t)count) == 0;
+  for(int i = 0; i < count; i++){
+    Shot *shot = &shots[i];
+    shot->is_hit = 0;
+    shot->is_sunk = 0;
+    shot->sunk_ship = NO_SHIP;
+    if(!room || !on_board(board, shot->row, shot->col))
+      continue; // Invalid shot
+    SparseCell *slot = upsert(board, cell_key(board, shot->row, shot->col));
+    if(slot->shot)
+      continue; // Already shot here
+    slot->shot = 1;
+    board->shots++;
+    if(slot->ship < 0)
+      continue;
+    shot->is_hit = 1;
+    hits++;
+    Ship *s = &board->ships[slot->ship];
+    if(++s->hits == s->size){
+      shot->is_sunk = 1;
+      shot->sunk_ship = slot->ship;
+      board->ships_remaining--;
+    }
+  }
+  return hits;
+}
+
+CellState sparse_get_cell(const SparseBoard *board, int row, int col){
+  if(board == NULL || !on_board(board, row, col))
+    return WATER;
+  const SparseCell *slot = lookup(board, cell_key(board, row, col));
+  if(slot == NULL)
+    return WATER;
+  if(slot->shot)
+    return slot->ship >= 0 ? HIT : MISS;
+  return slot->ship >= 0 ? SHIP : WATER;
+}
+
+int sparse_next_shot(const SparseBoard *board, uint32_t *pos, int *row, int *col, int *is_hit){
+  for(; *pos < board->cap; (*pos)++){
+    const SparseCell *slot = &board->cells[*pos];
+    if(slot->cell == SPARSE_NO_CELL || !slot->shot)
+      continue;
+    *row = (int)(slot->cell / (uint32_t)board->cols);
+    *col = (int)(slot->cell % (uint32_t)board->cols);
+    *is_hit = slot->ship >= 0;
+    (*pos)++;
+    return 1;
+  }
+  return 0;
+}
+
+int sparse_board_load_cells(SparseBoard *board, const SparseCell *cells, uint32_t count){
+  board->cells = NULL;
+  board->cap = board->used = 0;
+  board->alloc = NULL;
+  board->alloc_ctx = NULL;
+  board->borrowed = 0;
+  if(reserve(board, count) < 0)
+    return -1;
+  for(uint32_t i = 0; i < count; i++)
+    *upsert(board, cells[i].cell) = cells[i];
+  return 0;
+}
@@ -0,0 +1,74 @@
+#ifndef SPARSE_BOARD_H
+#define SPARSE_BOARD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common.h"
+
+// Board engine for boards too large for a grid (up to MAX_BOARD_DIM on a
+// side). Only cells that hold a ship segment or were shot at are stored, in
+// one open-addressing table keyed by row * cols + col, so memory grows with
+// the fleet and the number of shots rather than with the board's area.
+//
+// Ships are identified by their index in the fleet; Ship.type holds that
+// index, the same way the classic fleet's ShipType values are its indices.
+
+#define SPARSE_NO_CELL UINT32_MAX
+
+// Where cell tables come from when not from malloc(). Tables it hands out
+// are never freed here: its owner takes them all back at once (the
+// server's per-game arena).
+typedef void *(*SparseAlloc)(void *ctx, size_t size);
+
+typedef struct {
+  uint32_t cell;  // row * cols + col, SPARSE_NO_CELL for an empty slot
+  int8_t ship;    // Fleet index of the ship on this cell, -1 for water
+  uint8_t shot;   // Set once the cell has been fired at
+} SparseCell;
+
+typedef struct {
+  int rows;
+  int cols;
+  int num_ships;
+  Ship ships[MAX_FLEET];
+  int ships_remaining;
+  SparseCell *cells;
+  uint32_t cap;   // Power of two, 0 until the first insert
+  uint32_t used;
+  uint32_t shots; // Cells fired at
+  SparseAlloc alloc; // NULL: tables are malloc()ed
+  void *alloc_ctx;
+  int borrowed;   // cells came from alloc, not ours to free
+} SparseBoard;
+
+// Set up an empty board with the given fleet. Ship sizes are not checked
+// against the board here; see game_config_valid().
+void sparse_board_init(SparseBoard *board, int rows, int cols, int num_ships, const unsigned short *ship_sizes);
+
+void sparse_board_free(SparseBoard *board);
+
+int sparse_can_place_ship(const SparseBoard *board, const Ship *ship);
+
+// Place the unplaced ship ships[ship->type]. Returns -1 if there is no such
+// ship or the table could not grow.
+int sparse_place_ship(SparseBoard *board, const Ship *ship);
+
+// Same contract as take_shot(); sunk_ship receives the fleet index.
+int sparse_take_shot(SparseBoard *board, int row, int col, int *is_hit, int *is_sunk, int *sunk_ship);
+
+// take_shots() for sparse boards: the table grows once for the whole salvo.
+int sparse_take_shots(SparseBoard *board, Shot *shots, int count);
+
+CellState sparse_get_cell(const SparseBoard *board, int row, int col);
+
+// Walk the cells that were shot at: start with *pos = 0 and call until it
+// returns 0.
+int sparse_next_shot(const SparseBoard *board, uint32_t *pos, int *row, int *col, int *is_hit);
+
+// Rebuild the table from the stored cells of a board whose struct was
+// copied from elsewhere (a snapshot). The copied cells pointer and
+// allocator are ignored; the new table is malloc()ed.
+int sparse_board_load_cells(SparseBoard *board, const SparseCell *cells, uint32_t count);
+
+#endif // SPARSE_BOARD_H
@@ -0,0 +1,724 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "../common/common.h"
+#include "../common/game_logic.h"
+#include "../common/ai.h"
+#include "../common/protocol.h"
+#include "../common/rng.h"
+#include "../common/shm_ring.h"
+
+// Headless bots that play complete games against the real server, used to
+// measure how many games, messages and turns per second it sustains.
+
+#define MAX_EVENTS 256
+#define BOT_OUT_SIZE (PROTO_MAX_FRAME * 4) // Frames the socket has not taken yet
+
+typedef enum {
+  SHOTS_RANDOM,
+  SHOTS_SCAN
+} ShotStrategy;
+
+typedef struct {
+  int fd;
+  int connected;
+  int spectator;                // Watches the newest game instead of playing
+  FrameReader reader;
+  uint8_t out[BOT_OUT_SIZE];    // Unsent bytes, written on EPOLLOUT
+  size_t out_len;
+  int want_write;               // EPOLLOUT is armed
+  PlayerBoard my_board;
+  Ship pending_ship;            // Placement waiting for the server's answer
+  unsigned char shot_order[BOARD_ROWS * BOARD_COLS];
+  int next_shot;
+  unsigned char fired[BOARD_ROWS * BOARD_COLS]; // -H: hints may pick any cell, so shot_order skips these
+  int salvo_game;               // The server agreed to salvo mode for this game
+  int fleet_accepted;
+  uint64_t request_sent_ns;     // 0 when no request is outstanding
+  uint64_t game_start_ns;       // 0 once the bot's first turn came up
+  uint64_t rng;
+  ShmEndpoint shm;              // -M: channel is set once the server switched us over
+  int shm_fds[SHM_FDS];         // Came with SHM_RES
+  int shm_nfds;
+} Bot;
+
+typedef struct {
+  uint64_t *samples;            // Request-to-response latency, nanoseconds
+  size_t count;
+  size_t cap;
+} LatencyLog;
+
+typedef struct {
+  const char *host;
+  int connections;
+  long max_games;
+  int duration_s;
+  ShotStrategy strategy;
+  int vs_computer;              // Server runs with -a: one connection per game
+  int salvo;                    // Ask for salvo games: one request per turn
+  int whole_fleet;              // Submit the fleet in one message instead of answering prompts
+  int spectators;               // Extra connections that watch games
+  const char *unix_path;        // Connect over this Unix socket instead of TCP
+  int shm;                      // Then move to the shared-memory rings
+  int hints;                    // Ask for a hint every classic turn and fire where it points
+} Options;
+
+static int epoll_fd;
+static struct sockaddr_in server_addr;
+static struct sockaddr_un unix_addr;
+static Options opts = {"127.0.0.1", 100, 0, 10, SHOTS_RANDOM, 0, 0, 0, 0, NULL, 0, 0};
+static LatencyLog latencies;
+static LatencyLog first_turn_latencies; // Game start to the first TURN_IND
+static LatencyLog hint_latencies; // HINT_REQ to HINT_RES, solver included
+static long games_completed;
+static long connections_opened;
+static long messages_sent;
+static long messages_received;
+static long connect_failures;
+static long bot_errors;
+static long games_watched;
+static long spectator_events;     // Shots seen by spectators
+static long hints_taken;
+
+static uint64_t now_ns(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void record_sample(LatencyLog *log, uint64_t ns){
+  if(log->count == log->cap){
+    size_t new_cap = log->cap ? log->cap * 2 : 1 << 16;
+    uint64_t *grown = realloc(log->samples, new_cap * sizeof(*grown));
+    if(grown == NULL)
+      return;
+    log->samples = grown;
+    log->cap = new_cap;
+  }
+  log->samples[log->count++] = ns;
+}
+
+static void record_latency(uint64_t ns){
+  record_sample(&latencies, ns);
+}
+
+static int compare_u64(const void *a, const void *b){
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+static double percentile_us(const LatencyLog *log, double p){
+  if(log->count == 0)
+    return 0.0;
+  size_t idx = (size_t)(p * (double)(log->count - 1));
+  return (double)log->samples[idx] / 1000.0;
+}
+
+// Write what the socket takes of out; the rest waits for EPOLLOUT, so a
+// frame is never left half sent.
+static int bot_flush(Bot *bot){
+  while(bot->out_len > 0){
+    ssize_t n = send(bot->fd, bot->out, bot->out_len, MSG_NOSIGNAL);
+    if(n < 0){
+      if(errno == EINTR)
+        continue;
+      if(errno == EAGAIN || errno == EWOULDBLOCK)
+        break;
+      return -1;
+    }
+    memmove(bot->out, bot->out + n, bot->out_len - (size_t)n);
+    bot->out_len -= (size_t)n;
+  }
+  int want_write = (bot->out_len > 0);
+  if(want_write != bot->want_write){
+    struct epoll_event ev;
+    ev.events = EPOLLIN | (want_write ? EPOLLOUT : 0);
+    ev.data.ptr = bot;
+    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, bot->fd, &ev);
+    bot->want_write = want_write;
+  }
+  return 0;
+}
+
+// One frame over whichever transport the bot is on. A frame that does not
+// fit in the ring or behind the unsent bytes counts as an error: bots
+// never have much outstanding.
+static int bot_write(Bot *bot, const GameMessage *msg){
+  if(bot->shm.channel == NULL){
+    size_t len = encode_message(msg, bot->out + bot->out_len, sizeof(bot->out) - bot->out_len);
+    if(len == 0)
+      return -1;
+    bot->out_len += len;
+    return bot_flush(bot);
+  }
+  uint8_t frame[PROTO_MAX_FRAME];
+  size_t len = encode_message(msg, frame, sizeof(frame));
+  if(len == 0 || shm_write(&bot->shm, frame, len) != len)
+    return -1;
+  return 0;
+}
+
+static int bot_send(Bot *bot, const GameMessage *msg){
+  if(bot_write(bot, msg) < 0)
+    return -1;
+  messages_sent++;
+  bot->request_sent_ns = now_ns();
+  return 0;
+}
+
+static void bot_reset(Bot *bot){
+  init_board(&bot->my_board);
+  frame_reader_init(&bot->reader);
+  bot->next_shot = 0;
+  memset(bot->fired, 0, sizeof(bot->fired));
+  bot->salvo_game = 0;
+  bot->request_sent_ns = 0;
+  bot->game_start_ns = 0;
+  for(int i = 0; i < BOARD_ROWS * BOARD_COLS; i++)
+    bot->shot_order[i] = (unsigned char)i;
+  if(opts.strategy == SHOTS_RANDOM){
+    for(int i = BOARD_ROWS * BOARD_COLS - 1; i > 0; i--){
+      int j = (int)rng_below(&bot->rng, (uint32_t)i + 1);
+      unsigned char tmp = bot->shot_order[i];
+      bot->shot_order[i] = bot->shot_order[j];
+      bot->shot_order[j] = tmp;
+    }
+  }
+}
+
+static int bot_connect(Bot *bot){
+  bot_reset(bot);
+  bot->connected = 0;
+  bot->out_len = 0;
+  bot->want_write = 0;
+  bot->fd = socket(opts.unix_path ? AF_UNIX : AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if(bot->fd < 0){
+    perror("socket");
+    return -1;
+  }
+  int rc = opts.unix_path ? connect(bot->fd, (struct sockaddr *)&unix_addr, sizeof(unix_addr))
+                          : connect(bot->fd, (struct sockaddr *)&server_addr, sizeof(server_addr));
+  if(rc < 0 && errno != EINPROGRESS){
+    close(bot->fd);
+    bot->fd = -1;
+    connect_failures++;
+    return -1;
+  }
+  struct epoll_event ev;
+  ev.events = EPOLLIN | EPOLLOUT;
+  ev.data.ptr = bot;
+  epoll_ctl(epoll_fd, EPOLL_CTL_ADD, bot->fd, &ev);
+  if(!bot->spectator)
+    connections_opened++;
+  return 0;
+}
+
+static void bot_close(Bot *bot){
+  if(bot->fd >= 0){
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, bot->fd, NULL);
+    close(bot->fd);
+  }
+  bot->fd = -1;
+  if(bot->shm.channel != NULL){
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, bot->shm.wake_fd, NULL);
+    shm_close(&bot->shm);
+  }
+  for(int i = 0; i < bot->shm_nfds; i++)
+    close(bot->shm_fds[i]);
+  bot->shm_nfds = 0;
+}
+
+// SHM_RES: map the rings and wait on our eventfd from now on. The socket
+// stays registered to notice the server going away.
+static int bot_start_shm(Bot *bot, const GameMessage *msg){
+  if(!msg->success || bot->shm_nfds != SHM_FDS)
+    return -1;
+  bot->shm_nfds = 0;
+  if(shm_client_attach(&bot->shm, bot->shm_fds) < 0){
+    perror("Mapping the rings failed");
+    return -1;
+  }
+  struct epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.ptr = (void *)((uintptr_t)bot | 1);
+  if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, bot->shm.wake_fd, &ev) < 0){
+    perror("epoll_ctl failed");
+    return -1;
+  }
+  return 0;
+}
+
+static int players_per_game(void){
+  return opts.vs_computer ? 1 : 2;
+}
+
+static int want_more_games(void){
+  return opts.max_games == 0 || connections_opened < opts.max_games * players_per_game();
+}
+
+// Spectators count what they see and move on to a new game when theirs ends.
+static int spectator_handle_message(const GameMessage *msg){
+  switch(msg->type){
+    case MSG_TYPE_SPECTATE_RES:
+      return msg->success ? 0 : 1;
+    case MSG_TYPE_SHOT_RES:
+      spectator_events++;
+      return 0;
+    case MSG_TYPE_SALVO_RES:
+      spectator_events += msg->shot_count;
+      return 0;
+    case MSG_TYPE_GAME_OVER:
+      games_watched++;
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+static int bot_fire(Bot *bot, int cell){
+  GameMessage shot;
+  memset(&shot, 0, sizeof(shot));
+  shot.type = MSG_TYPE_SHOT_REQ;
+  shot.row = cell / BOARD_COLS;
+  shot.col = cell % BOARD_COLS;
+  bot->fired[cell] = 1;
+  return bot_send(bot, &shot);
+}
+
+// Next cell of the bot's own order that no hint has used up.
+static int bot_fire_next(Bot *bot){
+  while(bot->next_shot < BOARD_ROWS * BOARD_COLS && bot->fired[bot->shot_order[bot->next_shot]])
+    bot->next_shot++;
+  if(bot->next_shot >= BOARD_ROWS * BOARD_COLS)
+    return -1;
+  return bot_fire(bot, bot->shot_order[bot->next_shot++]);
+}
+
+static int bot_handle_message(Bot *bot, const GameMessage *msg){
+  GameMessage reply;
+  memset(&reply, 0, sizeof(reply));
+  if(msg->type == MSG_TYPE_SHM_RES)
+    return bot_start_shm(bot, msg);
+  if(bot->spectator)
+    return spectator_handle_message(msg);
+
+  switch(msg->type){
+    case MSG_TYPE_PLACE_SHIP_PROMPT: {
+      if(opts.whole_fleet)
+        return 0; // Our fleet is already on its way
+      Ship ship = {
+        .type = msg->ship_type,
+        .size = get_ship_size(msg->ship_type),
+        .hits = 0,
+        .is_placed = 0
+      };
+      if(ship.size <= 0)
+        return -1;
+      do{
+        ship.row = (int)rng_below(&bot->rng, BOARD_ROWS);
+        ship.col = (int)rng_below(&bot->rng, BOARD_COLS);
+        ship.orientation = rng_below(&bot->rng, 2) ? VERTICAL : HORIZONTAL;
+      } while(!can_place_ship(&bot->my_board, &ship));
+      bot->pending_ship = ship;
+      reply.type = MSG_TYPE_PLACEMENT_REQ;
+      reply.row = ship.row;
+      reply.col = ship.col;
+      reply.ship_type = ship.type;
+      reply.orientation = ship.orientation;
+      return bot_send(bot, &reply);
+    }
+    case MSG_TYPE_PLACEMENT_RES:
+      if(bot->request_sent_ns){
+        record_latency(now_ns() - bot->request_sent_ns);
+        bot->request_sent_ns = 0;
+      }
+      if(msg->success)
+        place_ship(&bot->my_board, &bot->pending_ship);
+      return 0;
+    case MSG_TYPE_FLEET_RES:
+      if(bot->request_sent_ns){
+        record_latency(now_ns() - bot->request_sent_ns);
+        bot->request_sent_ns = 0;
+      }
+      // A game cancelled and re-paired takes our first fleet and turns down the second
+      if(msg->success)
+        bot->fleet_accepted = 1;
+      return bot->fleet_accepted ? 0 : -1;
+    case MSG_TYPE_TURN_IND: {
+      if(bot->next_shot >= BOARD_ROWS * BOARD_COLS)
+        return -1;
+      if(bot->game_start_ns){
+        record_sample(&first_turn_latencies, now_ns() - bot->game_start_ns);
+        bot->game_start_ns = 0;
+      }
+      if(bot->salvo_game){
+        reply.type = MSG_TYPE_SALVO_REQ;
+        while(reply.shot_count < msg->row && reply.shot_count < MAX_SALVO && bot->next_shot < BOARD_ROWS * BOARD_COLS){
+          int cell = bot->shot_order[bot->next_shot++];
+          reply.shots[reply.shot_count].row = (uint16_t)(cell / BOARD_COLS);
+          reply.shots[reply.shot_count].col = (uint16_t)(cell % BOARD_COLS);
+          reply.shot_count++;
+        }
+        return bot_send(bot, &reply);
+      }
+      if(opts.hints){
+        reply.type = MSG_TYPE_HINT_REQ;
+        return bot_send(bot, &reply);
+      }
+      return bot_fire_next(bot);
+    }
+    case MSG_TYPE_HINT_RES: {
+      if(bot->request_sent_ns){
+        record_sample(&hint_latencies, now_ns() - bot->request_sent_ns);
+        bot->request_sent_ns = 0;
+      }
+      int cell = msg->row * BOARD_COLS + msg->col;
+      if(msg->success && msg->row >= 0 && msg->row < BOARD_ROWS && msg->col >= 0 && msg->col < BOARD_COLS && !bot->fired[cell]){
+        hints_taken++;
+        return bot_fire(bot, cell);
+      }
+      return bot_fire_next(bot);
+    }
+    case MSG_TYPE_SHOT_RES:
+      if(!msg->own_board && bot->request_sent_ns){
+        record_latency(now_ns() - bot->request_sent_ns);
+        bot->request_sent_ns = 0;
+      }
+      return 0;
+    case MSG_TYPE_SALVO_RES:
+      if(!msg->own_board && bot->request_sent_ns){
+        record_latency(now_ns() - bot->request_sent_ns);
+        bot->request_sent_ns = 0;
+      }
+      return msg->success ? 0 : -1;
+    case MSG_TYPE_CONFIG:
+      if(!msg->success)
+        return -1;
+      // A game paired before our request reached the server stays classic
+      bot->salvo_game = strncmp(msg->message, "salvo:", 6) == 0;
+      bot->game_start_ns = now_ns();
+      bot->fleet_accepted = 0;
+      if(opts.whole_fleet){
+        // Sent with CONFIG when a game starts, again if it was cancelled and re-paired
+        init_board(&bot->my_board);
+        ai_place_fleet(&bot->my_board, &bot->rng);
+        reply.type = MSG_TYPE_FLEET_REQ;
+        reply.fleet_count = NUM_SHIPS;
+        for(int i = 0; i < NUM_SHIPS; i++){
+          const Ship *ship = &bot->my_board.ships[i];
+          reply.fleet[i] = (ShipPlacement){(uint16_t)ship->row, (uint16_t)ship->col, (uint8_t)ship->orientation};
+        }
+        return bot_send(bot, &reply);
+      }
+      return 0;
+    case MSG_TYPE_GAME_OVER:
+      games_completed++;
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+// Handle every complete frame read so far. Returns 1 when the bot is done.
+static int bot_handle_frames(Bot *bot){
+  GameMessage msg;
+  int status;
+  while((status = frame_reader_next(&bot->reader, &msg)) == 1){
+    messages_received++;
+    int result = bot_handle_message(bot, &msg);
+    if(result != 0){
+      if(result < 0)
+        bot_errors++;
+      return 1;
+    }
+  }
+  if(status < 0){
+    bot_errors++;
+    return 1;
+  }
+  return 0;
+}
+
+// Until SHM_RES is in, reads go through recvmsg() to catch the ring's
+// descriptors.
+static ssize_t bot_recv(Bot *bot){
+  if(!opts.shm || bot->shm.channel != NULL)
+    return frame_reader_recv(&bot->reader, bot->fd);
+  uint8_t buf[PROTO_MAX_FRAME];
+  int fds[SHM_FDS], nfds;
+  ssize_t n = shm_recv_fds(bot->fd, buf, sizeof(buf), fds, SHM_FDS, &nfds);
+  for(int i = 0; i < nfds; i++){
+    if(bot->shm_nfds < SHM_FDS)
+      bot->shm_fds[bot->shm_nfds++] = fds[i];
+    else
+      close(fds[i]);
+  }
+  if(n > 0 && frame_reader_append(&bot->reader, buf, (size_t)n) != (size_t)n){
+    errno = ENOBUFS;
+    return -1;
+  }
+  return n;
+}
+
+// Returns 1 when the bot's game ended (or its connection broke) and the bot
+// should be recycled.
+static int bot_handle_readable(Bot *bot){
+  for(;;){
+    ssize_t n = bot_recv(bot);
+    if(n == 0)
+      return 1;
+    if(n < 0){
+      if(errno == EINTR)
+        continue;
+      if(errno == EAGAIN || errno == EWOULDBLOCK)
+        return 0;
+      return 1;
+    }
+    if(bot_handle_frames(bot))
+      return 1;
+  }
+}
+
+// The server put frames in our ring. Same return as bot_handle_readable().
+static int bot_handle_shm(Bot *bot){
+  shm_clear_wake(&bot->shm);
+  uint8_t buf[PROTO_READ_BUF];
+  for(;;){
+    size_t room = sizeof(bot->reader.buf) - (bot->reader.len - bot->reader.start);
+    size_t n = shm_read(&bot->shm, buf, room);
+    if(n == 0){
+      if(room == 0){
+        bot_errors++;
+        return 1;
+      }
+      if(!shm_prepare_wait(&bot->shm))
+        return 0;
+      continue;
+    }
+    frame_reader_append(&bot->reader, buf, n);
+    if(bot_handle_frames(bot))
+      return 1;
+  }
+}
+
+static void usage(const char *prog){
+  fprintf(stderr, "Usage: %s [-c connections] [-g games] [-d seconds] [-s random|scan] [-a] [-S] [-f] [-W spectators] [-u unix_socket [-M]] [-H] [server_ip]\n", prog);
+  fprintf(stderr, "  -a  the server pairs every connection with the computer (server -a)\n");
+  fprintf(stderr, "  -S  play salvo games, one shot per ship afloat each turn\n");
+  fprintf(stderr, "  -f  submit the whole fleet in one message instead of answering prompts\n");
+  fprintf(stderr, "  -W  extra connections that each watch the newest game\n");
+  fprintf(stderr, "  -u  connect over the server's Unix socket (server -u) instead of TCP\n");
+  fprintf(stderr, "  -M  with -u, move every connection to the shared-memory rings\n");
+  fprintf(stderr, "  -H  ask the server for a hint every classic turn and fire where it points\n");
+}
+
+int main(int argc, char *argv[]){
+  int opt;
+  while((opt = getopt(argc, argv, "c:g:d:s:aSfW:u:MHh")) != -1){
+    switch(opt){
+      case 'a': opts.vs_computer = 1; break;
+      case 'S': opts.salvo = 1; break;
+      case 'f': opts.whole_fleet = 1; break;
+      case 'W': opts.spectators = atoi(optarg); break;
+      case 'u': opts.unix_path = optarg; break;
+      case 'M': opts.shm = 1; break;
+      case 'H': opts.hints = 1; break;
+      case 'c': opts.connections = atoi(optarg); break;
+      case 'g': opts.max_games = atol(optarg); break;
+      case 'd': opts.duration_s = atoi(optarg); break;
+      case 's':
+        if(strcmp(optarg, "scan") == 0)
+          opts.strategy = SHOTS_SCAN;
+        else if(strcmp(optarg, "random") == 0)
+          opts.strategy = SHOTS_RANDOM;
+        else{
+          usage(argv[0]);
+          return EXIT_FAILURE;
+        }
+        break;
+      default:
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  if(optind < argc)
+    opts.host = argv[optind];
+  if(opts.salvo && opts.vs_computer){
+    fprintf(stderr, "The computer only plays classic games; -S and -a do not mix\n");
+    return EXIT_FAILURE;
+  }
+  if(opts.shm && opts.unix_path == NULL){
+    fprintf(stderr, "Shared memory is only offered on the Unix socket; -M needs -u\n");
+    return EXIT_FAILURE;
+  }
+  if(opts.connections < 2)
+    opts.connections = 2;
+  if(!opts.vs_computer)
+    opts.connections &= ~1; // The server pairs connections into games
+
+  memset(&server_addr, 0, sizeof(server_addr));
+  server_addr.sin_family = AF_INET;
+  server_addr.sin_port = htons(PORT);
+  if(inet_pton(AF_INET, opts.host, &server_addr.sin_addr) <= 0){
+    fprintf(stderr, "Invalid address/ Address not supported\n");
+    return EXIT_FAILURE;
+  }
+  if(opts.unix_path != NULL){
+    unix_addr.sun_family = AF_UNIX;
+    if(strlen(opts.unix_path) >= sizeof(unix_addr.sun_path)){
+      fprintf(stderr, "Unix socket path too long: %s\n", opts.unix_path);
+      return EXIT_FAILURE;
+    }
+    strcpy(unix_addr.sun_path, opts.unix_path);
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+  epoll_fd = epoll_create1(0);
+  if(epoll_fd < 0){
+    perror("epoll_create1 failed");
+    return EXIT_FAILURE;
+  }
+
+  if(opts.spectators < 0)
+    opts.spectators = 0;
+  int total_bots = opts.connections + opts.spectators;
+  Bot *bots = calloc((size_t)total_bots, sizeof(*bots));
+  if(bots == NULL){
+    perror("calloc failed");
+    return EXIT_FAILURE;
+  }
+  uint64_t seed = now_ns();
+  for(int i = 0; i < total_bots; i++){
+    bots[i].fd = -1;
+    bots[i].rng = rng_seed(seed + (uint64_t)i);
+    bots[i].spectator = (i >= opts.connections);
+    if(bots[i].spectator || want_more_games())
+      bot_connect(&bots[i]);
+  }
+
+  if(opts.unix_path != NULL)
+    printf("loadgen: %d connections to unix:%s%s, %s %s\n", opts.connections, opts.unix_path, opts.shm ? " (shared memory)" : "", opts.strategy == SHOTS_SCAN ? "scan" : "random", opts.salvo ? "salvos" : "shots");
+  else
+    printf("loadgen: %d connections to %s:%d, %s %s\n", opts.connections, opts.host, PORT, opts.strategy == SHOTS_SCAN ? "scan" : "random", opts.salvo ? "salvos" : "shots");
+
+  uint64_t start = now_ns();
+  uint64_t deadline = start + (uint64_t)opts.duration_s * 1000000000ULL;
+  int live = (int)connections_opened; // Players; spectators leave when they do
+  struct epoll_event events[MAX_EVENTS];
+
+  while(live > 0){
+    uint64_t now = now_ns();
+    if(opts.max_games == 0 && now >= deadline)
+      break;
+    int n = epoll_wait(epoll_fd, events, MAX_EVENTS, 100);
+    if(n < 0){
+      if(errno == EINTR)
+        continue;
+      perror("epoll_wait failed");
+      break;
+    }
+    for(int i = 0; i < n; i++){
+      int ring = (int)((uintptr_t)events[i].data.ptr & 1); // Tagged: the bot's eventfd
+      Bot *bot = (Bot *)((uintptr_t)events[i].data.ptr & ~(uintptr_t)1);
+      if(bot->fd < 0 || (ring && bot->shm.channel == NULL))
+        continue; // Closed earlier in this batch
+      int failed = 0;
+      if(!bot->connected && (events[i].events & EPOLLOUT)){
+        bot->connected = 1;
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = bot;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, bot->fd, &ev);
+        if(opts.shm){
+          GameMessage shm_req;
+          memset(&shm_req, 0, sizeof(shm_req));
+          shm_req.type = MSG_TYPE_SHM_REQ;
+          if(bot_write(bot, &shm_req) == 0)
+            messages_sent++;
+          else
+            failed = 1;
+        }
+        if(bot->spectator){
+          GameMessage spectate_req;
+          memset(&spectate_req, 0, sizeof(spectate_req));
+          spectate_req.type = MSG_TYPE_SPECTATE_REQ;
+          if(bot_write(bot, &spectate_req) == 0)
+            messages_sent++;
+          else
+            failed = 1;
+        }
+        else if(opts.salvo){
+          GameMessage config_req;
+          memset(&config_req, 0, sizeof(config_req));
+          config_req.type = MSG_TYPE_CONFIG_REQ;
+          config_req.row = BOARD_ROWS;
+          config_req.col = BOARD_COLS;
+          strcpy(config_req.message, "salvo:");
+          if(bot_write(bot, &config_req) == 0)
+            messages_sent++;
+          else
+            failed = 1;
+        }
+      }
+      else if(!ring && (events[i].events & EPOLLOUT) && bot_flush(bot) < 0)
+        failed = 1;
+      if(failed)
+        bot_errors++;
+      else if(!(events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)))
+        continue;
+      if(failed || (ring ? bot_handle_shm(bot) : bot_handle_readable(bot))){
+        bot_close(bot);
+        if(bot->spectator){
+          if(live > 0)
+            bot_connect(bot); // On to the newest game
+          continue;
+        }
+        live--;
+        // Keep the connection count steady by starting a fresh player
+        if(want_more_games() && (opts.max_games != 0 || now_ns() < deadline)){
+          if(bot_connect(bot) == 0)
+            live++;
+        }
+      }
+    }
+  }
+
+  double elapsed = (double)(now_ns() - start) / 1e9;
+  qsort(latencies.samples, latencies.count, sizeof(*latencies.samples), compare_u64);
+  qsort(first_turn_latencies.samples, first_turn_latencies.count, sizeof(*first_turn_latencies.samples), compare_u64);
+  qsort(hint_latencies.samples, hint_latencies.count, sizeof(*hint_latencies.samples), compare_u64);
+
+  printf("elapsed        %.3f s\n", elapsed);
+  // Every human player of a game sees GAME_OVER
+  long games = games_completed / players_per_game();
+  printf("games          %ld (%.1f games/sec)\n", games, (double)games / elapsed);
+  printf("messages       %ld sent, %ld received (%.1f msgs/sec)\n", messages_sent, messages_received, (double)(messages_sent + messages_received) / elapsed);
+  printf("turn latency   p50 %.1f us, p99 %.1f us, p999 %.1f us (%zu samples)\n", percentile_us(&latencies, 0.50), percentile_us(&latencies, 0.99), percentile_us(&latencies, 0.999), latencies.count);
+  printf("first turn     p50 %.1f us, p99 %.1f us after game start (%zu samples)\n", percentile_us(&first_turn_latencies, 0.50), percentile_us(&first_turn_latencies, 0.99), first_turn_latencies.count);
+  if(opts.hints)
+    printf("hints          %ld taken, p50 %.1f us, p99 %.1f us to answer (%zu samples)\n", hints_taken, percentile_us(&hint_latencies, 0.50), percentile_us(&hint_latencies, 0.99), hint_latencies.count);
+  if(opts.spectators > 0)
+    printf("spectators     %d watched %ld games to the end, %ld shots seen (%.1f shots/sec)\n", opts.spectators, games_watched, spectator_events, (double)spectator_events / elapsed);
+  if(connect_failures || bot_errors)
+    printf("errors         %ld connect failures, %ld bot errors\n", connect_failures, bot_errors);
+
+  for(int i = 0; i < total_bots; i++)
+    bot_close(&bots[i]);
+  free(bots);
+  free(latencies.samples);
+  free(first_turn_latencies.samples);
+  free(hint_latencies.samples);
+  close(epoll_fd);
+  return 0;
+}
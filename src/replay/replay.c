@@ -0,0 +1,373 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../common/common.h"
+#include "../common/game_logic.h"
+#include "../common/game_board.h"
+#include "../common/journal.h"
+
+// Rebuilds games from server journals (server -j). Each file is mapped
+// read-only and walked front to back once; every placement and shot is fed
+// through the game's board engine and the recorded outcome is checked
+// against what the game logic says now. Games still open at the end of a
+// file (server stopped mid-game) are reported as unfinished.
+
+#define MAX_CLIENT 2
+
+typedef struct {
+  uint32_t id;
+  int ai_slot; // -1 for two humans
+  int shots[MAX_CLIENT];
+  GameConfig config;
+  GameBoard boards[MAX_CLIENT];
+} ReplayGame;
+
+#define SLOT_EMPTY 0
+#define SLOT_USED 1
+#define SLOT_DELETED 2
+
+// Open-addressing table of games in progress, keyed by session id.
+typedef struct {
+  uint32_t id;
+  uint8_t state;
+  ReplayGame *game;
+} GameSlot;
+
+typedef struct {
+  GameSlot *slots;
+  size_t cap; // Power of two
+  size_t used;
+  size_t deleted;
+} GameTable;
+
+typedef struct {
+  uint64_t files;
+  uint64_t bytes;
+  uint64_t records;
+  uint64_t games;
+  uint64_t ai_games;
+  uint64_t custom_games; // Started on a custom board or fleet
+  uint64_t disconnects;
+  uint64_t cancelled;
+  uint64_t timeouts;
+  uint64_t unfinished;
+  uint64_t shots;
+  uint64_t hits;
+  uint64_t mismatches; // Recorded outcome differs from the replayed one
+  uint64_t orphans;    // Records for a game whose start is not in the file
+} ReplayStats;
+
+static int verbose = 0;
+static long wanted_game = -1; // -g: print the final boards of this session
+
+static uint64_t now_ns(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static size_t hash_id(uint32_t id){
+  return (size_t)(id * 2654435761u);
+}
+
+static void table_init(GameTable *table){
+  table->cap = 1024;
+  table->slots = calloc(table->cap, sizeof(GameSlot));
+  table->used = table->deleted = 0;
+  if(table->slots == NULL){
+    perror("calloc failed");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static GameSlot *table_find(GameTable *table, uint32_t id){
+  size_t mask = table->cap - 1;
+  for(size_t i = hash_id(id) & mask;; i = (i + 1) & mask){
+    GameSlot *slot = &table->slots[i];
+    if(slot->state == SLOT_EMPTY)
+      return NULL;
+    if(slot->state == SLOT_USED && slot->id == id)
+      return slot;
+  }
+}
+
+static void table_insert(GameTable *table, ReplayGame *game);
+
+// Rebuild at twice the size when live plus deleted slots pass half full.
+static void table_grow(GameTable *table){
+  GameTable old = *table;
+  table->cap = (old.used * 4 > old.cap) ? old.cap * 2 : old.cap;
+  table->slots = calloc(table->cap, sizeof(GameSlot));
+  table->used = table->deleted = 0;
+  if(table->slots == NULL){
+    perror("calloc failed");
+    exit(EXIT_FAILURE);
+  }
+  for(size_t i = 0; i < old.cap; i++)
+    if(old.slots[i].state == SLOT_USED)
+      table_insert(table, old.slots[i].game);
+  free(old.slots);
+}
+
+static void table_insert(GameTable *table, ReplayGame *game){
+  if((table->used + table->deleted + 1) * 2 > table->cap)
+    table_grow(table);
+  size_t mask = table->cap - 1;
+  size_t i = hash_id(game->id) & mask;
+  while(table->slots[i].state == SLOT_USED)
+    i = (i + 1) & mask;
+  if(table->slots[i].state == SLOT_DELETED)
+    table->deleted--;
+  table->slots[i].id = game->id;
+  table->slots[i].state = SLOT_USED;
+  table->slots[i].game = game;
+  table->used++;
+}
+
+static void free_game(ReplayGame *game){
+  game_board_free(&game->boards[0]);
+  game_board_free(&game->boards[1]);
+  free(game);
+}
+
+static void table_remove(GameTable *table, GameSlot *slot){
+  free_game(slot->game);
+  slot->game = NULL;
+  slot->state = SLOT_DELETED;
+  table->used--;
+  table->deleted++;
+}
+
+static void print_board(const GameBoard *board, const char *title){
+  if(board->sparse){
+    // Far too large to draw; list the fleet instead
+    printf("%s: %dx%d board, %u shots, %d of %d ships afloat\n", title, board->big.rows, board->big.cols,
+           board->big.shots, board->big.ships_remaining, board->big.num_ships);
+    for(int i = 0; i < board->big.num_ships; i++){
+      const Ship *ship = &board->big.ships[i];
+      printf("  ship %d size %d at (%d,%d) %s, %d hits\n", i, ship->size, ship->row, ship->col,
+             ship->orientation == VERTICAL ? "vertical" : "horizontal", ship->hits);
+    }
+    return;
+  }
+  printf("%s\n  A B C D E F G H I J\n", title);
+  for(int r = 0; r < BOARD_ROWS; r++){
+    printf("%d", r);
+    for(int c = 0; c < BOARD_COLS; c++){
+      char ch = '~';
+      switch(game_board_cell(board, r, c)){
+        case WATER: ch = '~'; break;
+        case SHIP:  ch = '#'; break;
+        case HIT:   ch = 'X'; break;
+        case MISS:  ch = 'O'; break;
+      }
+      printf(" %c", ch);
+    }
+    printf("\n");
+  }
+}
+
+static void finish_game(const ReplayGame *game, const JournalRecord *rec, ReplayStats *stats){
+  if(rec->flags & JOURNAL_FLAG_CANCELLED){
+    stats->cancelled++;
+    return;
+  }
+  stats->games++;
+  if(game->ai_slot >= 0)
+    stats->ai_games++;
+  if(rec->flags & JOURNAL_FLAG_DISCONNECT)
+    stats->disconnects++;
+  else if(rec->flags & JOURNAL_FLAG_TIMEOUT)
+    stats->timeouts++;
+  else if(rec->player >= MAX_CLIENT || !game_board_over(&game->boards[1 - rec->player]))
+    stats->mismatches++; // Recorded winner did not sink the whole fleet
+
+  if(verbose || (long)game->id == wanted_game){
+    printf("Game %u: Player %d wins%s after %d/%d shots at %u ms%s\n", game->id, rec->player + 1,
+           (rec->flags & JOURNAL_FLAG_DISCONNECT) ? " by disconnect" : (rec->flags & JOURNAL_FLAG_TIMEOUT) ? " on time" : "",
+           game->shots[0], game->shots[1], rec->time_ms, game->ai_slot >= 0 ? " (against the computer)" : "");
+  }
+  if((long)game->id == wanted_game){
+    print_board(&game->boards[0], "Player 1");
+    print_board(&game->boards[1], "Player 2");
+  }
+}
+
+static void apply_record(GameTable *table, const JournalRecord *rec, ReplayStats *stats){
+  if(rec->type == JOURNAL_GAME_START){
+    ReplayGame *game = malloc(sizeof(*game));
+    if(game == NULL){
+      perror("malloc failed");
+      exit(EXIT_FAILURE);
+    }
+    game->id = rec->session_id;
+    game->ai_slot = (rec->player == JOURNAL_NO_PLAYER) ? -1 : rec->player;
+    game->shots[0] = game->shots[1] = 0;
+    game_config_classic(&game->config);
+    game->config.salvo = (rec->flags & JOURNAL_FLAG_SALVO) != 0;
+    game_board_init(&game->boards[0], &game->config);
+    game_board_init(&game->boards[1], &game->config);
+    table_insert(table, game);
+    return;
+  }
+
+  GameSlot *slot = table_find(table, rec->session_id);
+  if(slot == NULL){
+    stats->orphans++;
+    return;
+  }
+  ReplayGame *game = slot->game;
+  if(rec->type == JOURNAL_GAME_END){
+    finish_game(game, rec, stats);
+    table_remove(table, slot);
+    return;
+  }
+
+  if(rec->type == JOURNAL_BOARD){
+    game->config.rows = rec->row;
+    game->config.cols = rec->col;
+    game->config.num_ships = rec->ship_type;
+    return;
+  }
+  if(rec->type == JOURNAL_FLEET){
+    if(rec->ship_type < 0 || rec->ship_type >= game->config.num_ships || rec->ship_type >= MAX_FLEET){
+      stats->mismatches++;
+      return;
+    }
+    game->config.ship_sizes[rec->ship_type] = rec->row;
+    if(rec->ship_type == game->config.num_ships - 1){
+      if(!game_config_valid(&game->config)){
+        stats->mismatches++;
+        return;
+      }
+      for(int i = 0; i < MAX_CLIENT; i++){
+        game_board_free(&game->boards[i]);
+        game_board_init(&game->boards[i], &game->config);
+      }
+      stats->custom_games++;
+    }
+    return;
+  }
+  if(rec->player >= MAX_CLIENT){
+    stats->orphans++;
+    return;
+  }
+
+  switch(rec->type){
+    case JOURNAL_PLACEMENT:
+      if(!game_board_place(&game->boards[rec->player], rec->ship_type, rec->row, rec->col, (Orientation)rec->orientation))
+        stats->mismatches++;
+      break;
+    case JOURNAL_SHOT: {
+      int is_hit, is_sunk, sunk_ship;
+      game_board_shoot(&game->boards[1 - rec->player], rec->row, rec->col, &is_hit, &is_sunk, &sunk_ship);
+      game->shots[rec->player]++;
+      stats->shots++;
+      stats->hits += is_hit;
+      if(is_hit != ((rec->flags & JOURNAL_FLAG_HIT) != 0) || is_sunk != ((rec->flags & JOURNAL_FLAG_SUNK) != 0) || sunk_ship != rec->ship_type)
+        stats->mismatches++;
+      break;
+    }
+    default:
+      stats->orphans++;
+      break;
+  }
+}
+
+static int replay_file(const char *path, ReplayStats *stats){
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if(fd < 0){
+    perror(path);
+    return -1;
+  }
+  struct stat st;
+  if(fstat(fd, &st) < 0){
+    perror(path);
+    close(fd);
+    return -1;
+  }
+  size_t size = (size_t)st.st_size;
+  if(size < JOURNAL_HEADER_LEN){
+    fprintf(stderr, "%s: too short for a journal\n", path);
+    close(fd);
+    return -1;
+  }
+  const uint8_t *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED){
+    perror(path);
+    return -1;
+  }
+  madvise((void *)data, size, MADV_SEQUENTIAL);
+
+  if(journal_decode_header(data, size, NULL) < 0){
+    fprintf(stderr, "%s: not a journal or unsupported version\n", path);
+    munmap((void *)data, size);
+    return -1;
+  }
+
+  // A crash can leave a torn record at the end; it is ignored
+  size_t records = (size - JOURNAL_HEADER_LEN) / JOURNAL_RECORD_LEN;
+  GameTable table;
+  table_init(&table);
+  const uint8_t *p = data + JOURNAL_HEADER_LEN;
+  for(size_t i = 0; i < records; i++, p += JOURNAL_RECORD_LEN){
+    JournalRecord rec;
+    journal_decode_record(p, &rec);
+    apply_record(&table, &rec, stats);
+  }
+
+  stats->files++;
+  stats->bytes += size;
+  stats->records += records;
+  stats->unfinished += table.used;
+  for(size_t i = 0; i < table.cap; i++)
+    if(table.slots[i].state == SLOT_USED)
+      free_game(table.slots[i].game);
+  free(table.slots);
+  munmap((void *)data, size);
+  return 0;
+}
+
+int main(int argc, char *argv[]){
+  int opt;
+  while((opt = getopt(argc, argv, "g:v")) != -1){
+    switch(opt){
+      case 'g': wanted_game = atol(optarg); break;
+      case 'v': verbose = 1; break;
+      default:
+        fprintf(stderr, "Usage: %s [-v] [-g session_id] journal_file...\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+  }
+  if(optind >= argc){
+    fprintf(stderr, "Usage: %s [-v] [-g session_id] journal_file...\n", argv[0]);
+    exit(EXIT_FAILURE);
+  }
+
+  ReplayStats stats;
+  memset(&stats, 0, sizeof(stats));
+  int failed = 0;
+  uint64_t start = now_ns();
+  for(int i = optind; i < argc; i++)
+    if(replay_file(argv[i], &stats) < 0)
+      failed = 1;
+  double elapsed = (double)(now_ns() - start) / 1e9;
+
+  printf("files          %llu (%.1f MB, %llu records)\n", (unsigned long long)stats.files, (double)stats.bytes / 1e6, (unsigned long long)stats.records);
+  printf("games          %llu finished (%llu against the computer, %llu by disconnect, %llu on time), %llu unfinished, %llu cancelled, %llu on custom boards\n",
+         (unsigned long long)stats.games, (unsigned long long)stats.ai_games, (unsigned long long)stats.disconnects, (unsigned long long)stats.timeouts,
+         (unsigned long long)stats.unfinished, (unsigned long long)stats.cancelled, (unsigned long long)stats.custom_games);
+  printf("shots          %llu (%.1f%% hits)\n", (unsigned long long)stats.shots, stats.shots ? 100.0 * (double)stats.hits / (double)stats.shots : 0.0);
+  printf("mismatches     %llu, orphan records %llu\n", (unsigned long long)stats.mismatches, (unsigned long long)stats.orphans);
+  printf("elapsed        %.3f s (%.1f MB/s, %.1f M records/s)\n", elapsed,
+         elapsed > 0 ? (double)stats.bytes / 1e6 / elapsed : 0.0, elapsed > 0 ? (double)stats.records / 1e6 / elapsed : 0.0);
+  return (failed || stats.mismatches) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
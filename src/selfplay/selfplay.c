@@ -0,0 +1,355 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#include "../common/common.h"
+#include "../common/game_logic.h"
+#include "../common/ai.h"
+#include "../common/rng.h"
+
+// In-process self-play: millions of complete games straight against
+// game_logic.c, spread over all cores by a work-stealing pool. Every worker
+// owns a Chase-Lev deque of game ranges; it splits its own ranges and idle
+// workers steal the oldest (largest) ones from others. Results live in
+// per-worker stats and are summed only after the workers are joined.
+
+#define CACHE_LINE 64
+#define DEQUE_CAPACITY 1024 // Ranges are halved, so depth stays around log2(games)
+#define MAX_SHOTS (BOARD_ROWS * BOARD_COLS)
+
+typedef enum {
+  STRATEGY_RANDOM,
+  STRATEGY_AI
+} Strategy;
+
+// A task is a range of game numbers packed as start << 32 | count, so a deque
+// slot is a single atomic word.
+typedef uint64_t Task;
+
+static inline Task make_task(uint32_t start, uint32_t count){
+  return ((uint64_t)start << 32) | count;
+}
+
+typedef struct {
+  _Atomic long top;    // Thieves take from here
+  char pad0[CACHE_LINE - sizeof(long)];
+  _Atomic long bottom; // The owner pushes and pops here
+  char pad1[CACHE_LINE - sizeof(long)];
+  _Atomic uint64_t slots[DEQUE_CAPACITY];
+} WorkDeque;
+
+typedef struct {
+  long games;
+  long wins[2];
+  long shots_to_win[2][MAX_SHOTS + 1];
+  long steals;
+  double busy_ns;
+} WorkerStats;
+
+typedef struct {
+  int id;
+  pthread_t thread;
+  uint64_t rng;
+  WorkDeque deque;
+  WorkerStats stats;
+} __attribute__((aligned(CACHE_LINE))) Worker;
+
+typedef struct {
+  Strategy kind;
+  AiPlayer ai;
+  unsigned char order[MAX_SHOTS];
+  int next;
+} Player;
+
+static Worker *workers;
+static int worker_count;
+static uint32_t chunk_size = 64;
+static Strategy strategies[2] = {STRATEGY_AI, STRATEGY_RANDOM};
+static _Atomic long games_remaining;
+static uint64_t base_seed = 1;
+
+static double now_ns(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// --- Chase-Lev work-stealing deque -------------------------------------------
+
+static void deque_push(WorkDeque *dq, Task task){
+  long b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+  atomic_store_explicit(&dq->slots[b & (DEQUE_CAPACITY - 1)], task, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+}
+
+static int deque_pop(WorkDeque *dq, Task *task){
+  long b = atomic_load_explicit(&dq->bottom, memory_order_relaxed) - 1;
+  atomic_store_explicit(&dq->bottom, b, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  long t = atomic_load_explicit(&dq->top, memory_order_relaxed);
+  if(t > b){
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+    return 0;
+  }
+  *task = atomic_load_explicit(&dq->slots[b & (DEQUE_CAPACITY - 1)], memory_order_relaxed);
+  if(t == b){
+    // Last item: race any thief for it
+    int won = atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_relaxed);
+    return won;
+  }
+  return 1;
+}
+
+static int deque_steal(WorkDeque *dq, Task *task){
+  long t = atomic_load_explicit(&dq->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  long b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+  if(t >= b)
+    return 0;
+  *task = atomic_load_explicit(&dq->slots[t & (DEQUE_CAPACITY - 1)], memory_order_relaxed);
+  return atomic_compare_exchange_strong_explicit(&dq->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+}
+
+static int steal_work(Worker *self, Task *task){
+  if(worker_count < 2)
+    return 0;
+  int start = (int)rng_below(&self->rng, (uint32_t)worker_count);
+  for(int i = 0; i < worker_count; i++){
+    Worker *victim = &workers[(start + i) % worker_count];
+    if(victim != self && deque_steal(&victim->deque, task)){
+      self->stats.steals++;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+// --- Games -------------------------------------------------------------------
+
+static void player_init(Player *player, Strategy kind, uint64_t *rng){
+  player->kind = kind;
+  player->next = 0;
+  if(kind == STRATEGY_AI){
+    ai_init(&player->ai, rng_next(rng));
+    return;
+  }
+  for(int i = 0; i < MAX_SHOTS; i++)
+    player->order[i] = (unsigned char)i;
+  for(int i = MAX_SHOTS - 1; i > 0; i--){
+    int j = (int)rng_below(rng, (uint32_t)i + 1);
+    unsigned char tmp = player->order[i];
+    player->order[i] = player->order[j];
+    player->order[j] = tmp;
+  }
+}
+
+static void player_choose(Player *player, int *row, int *col){
+  if(player->kind == STRATEGY_AI){
+    ai_choose_shot(&player->ai, row, col);
+    return;
+  }
+  int cell = player->order[player->next++];
+  *row = cell / BOARD_COLS;
+  *col = cell % BOARD_COLS;
+}
+
+// Play one game; the first move alternates with the game number so neither
+// strategy profits from always starting.
+static void play_game(Worker *self, uint32_t game_number){
+  PlayerBoard boards[2];
+  Player players[2];
+  int shots[2] = {0, 0};
+  for(int p = 0; p < 2; p++){
+    init_board(&boards[p]);
+    ai_place_fleet(&boards[p], &self->rng);
+    player_init(&players[p], strategies[p], &self->rng);
+  }
+
+  int turn = (int)(game_number & 1);
+  for(;;){
+    int target = 1 - turn;
+    int row, col, is_hit, is_sunk;
+    ShipType sunk_type;
+    player_choose(&players[turn], &row, &col);
+    take_shot(&boards[target], row, col, &is_hit, &is_sunk, &sunk_type);
+    if(players[turn].kind == STRATEGY_AI)
+      ai_observe(&players[turn].ai, row, col, is_hit, sunk_type);
+    shots[turn]++;
+    if(check_game_over(&boards[target]) || shots[turn] >= MAX_SHOTS)
+      break;
+    turn = target;
+  }
+  self->stats.games++;
+  self->stats.wins[turn]++;
+  self->stats.shots_to_win[turn][shots[turn]]++;
+}
+
+static void *worker_main(void *arg){
+  Worker *self = arg;
+  double start = now_ns();
+  while(atomic_load_explicit(&games_remaining, memory_order_relaxed) > 0){
+    Task task;
+    if(!deque_pop(&self->deque, &task) && !steal_work(self, &task)){
+      sched_yield();
+      continue;
+    }
+    uint32_t first = (uint32_t)(task >> 32);
+    uint32_t count = (uint32_t)task;
+    // Keep splitting: the upper half goes back on our deque where an idle
+    // worker can steal it, we carry on with the lower half.
+    while(count > chunk_size){
+      uint32_t half = count / 2;
+      deque_push(&self->deque, make_task(first + half, count - half));
+      count = half;
+    }
+    for(uint32_t g = 0; g < count; g++)
+      play_game(self, first + g);
+    atomic_fetch_sub_explicit(&games_remaining, (long)count, memory_order_relaxed);
+  }
+  self->stats.busy_ns = now_ns() - start;
+  return NULL;
+}
+
+// --- Reporting ---------------------------------------------------------------
+
+static const char *strategy_name(Strategy s){
+  return s == STRATEGY_AI ? "ai" : "random";
+}
+
+static int parse_strategy(const char *name, Strategy *out){
+  if(strcmp(name, "ai") == 0)
+    *out = STRATEGY_AI;
+  else if(strcmp(name, "random") == 0)
+    *out = STRATEGY_RANDOM;
+  else
+    return -1;
+  return 0;
+}
+
+static int histogram_percentile(const long *hist, long total, double p){
+  long target = (long)(p * (double)total);
+  long seen = 0;
+  for(int s = 0; s <= MAX_SHOTS; s++){
+    seen += hist[s];
+    if(seen > target)
+      return s;
+  }
+  return MAX_SHOTS;
+}
+
+static void report(const WorkerStats *total, double elapsed_ns){
+  double seconds = elapsed_ns / 1e9;
+  printf("games          %ld in %.3f s (%.0f games/sec, %.0f per worker)\n", total->games, seconds, (double)total->games / seconds, (double)total->games / seconds / worker_count);
+  for(int w = 0; w < worker_count; w++)
+    printf("  worker %-3d   %ld games, %.0f games/sec, %ld steals\n", w, workers[w].stats.games, (double)workers[w].stats.games * 1e9 / workers[w].stats.busy_ns, workers[w].stats.steals);
+
+  for(int p = 0; p < 2; p++){
+    long wins = total->wins[p];
+    double sum = 0.0;
+    for(int s = 0; s <= MAX_SHOTS; s++)
+      sum += (double)s * (double)total->shots_to_win[p][s];
+    printf("player %d (%s): %ld wins (%.2f%%)", p, strategy_name(strategies[p]), wins, total->games ? 100.0 * (double)wins / (double)total->games : 0.0);
+    if(wins > 0)
+      printf(", shots to win mean %.2f, p10 %d, p50 %d, p90 %d",
+             sum / (double)wins,
+             histogram_percentile(total->shots_to_win[p], wins, 0.10),
+             histogram_percentile(total->shots_to_win[p], wins, 0.50),
+             histogram_percentile(total->shots_to_win[p], wins, 0.90));
+    printf("\n");
+  }
+
+  printf("shots-to-win distribution (both players, buckets of 5):\n");
+  for(int lo = 0; lo <= MAX_SHOTS; lo += 5){
+    long bucket = 0;
+    for(int s = lo; s < lo + 5 && s <= MAX_SHOTS; s++)
+      bucket += total->shots_to_win[0][s] + total->shots_to_win[1][s];
+    if(bucket > 0)
+      printf("  %3d-%-3d %ld\n", lo, lo + 4, bucket);
+  }
+}
+
+int main(int argc, char *argv[]){
+  long games = 1000000;
+  worker_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+  int opt;
+  while((opt = getopt(argc, argv, "n:t:c:a:b:s:")) != -1){
+    switch(opt){
+      case 'n': games = atol(optarg); break;
+      case 't': worker_count = atoi(optarg); break;
+      case 'c': chunk_size = (uint32_t)atoi(optarg); break;
+      case 's': base_seed = strtoull(optarg, NULL, 10); break;
+      case 'a':
+      case 'b':
+        if(parse_strategy(optarg, &strategies[opt == 'a' ? 0 : 1]) == 0)
+          break;
+        // fall through
+      default:
+        fprintf(stderr, "Usage: %s [-n games] [-t threads] [-c chunk] [-a ai|random] [-b ai|random] [-s seed]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  if(worker_count < 1)
+    worker_count = 1;
+  if(chunk_size < 1)
+    chunk_size = 1;
+  if(games < 1 || games > UINT32_MAX){
+    fprintf(stderr, "Game count must be between 1 and %u\n", UINT32_MAX);
+    return EXIT_FAILURE;
+  }
+
+  workers = aligned_alloc(CACHE_LINE, sizeof(Worker) * (size_t)worker_count);
+  if(workers == NULL){
+    perror("aligned_alloc failed");
+    return EXIT_FAILURE;
+  }
+  memset(workers, 0, sizeof(Worker) * (size_t)worker_count);
+  atomic_store(&games_remaining, games);
+
+  // Seed each deque with an equal share; stealing evens out the rest
+  for(int w = 0; w < worker_count; w++){
+    workers[w].id = w;
+    workers[w].rng = rng_seed(base_seed * 0x100000001B3ULL + (uint64_t)w);
+    uint32_t first = (uint32_t)(games * w / worker_count);
+    uint32_t last = (uint32_t)(games * (w + 1) / worker_count);
+    if(last > first)
+      deque_push(&workers[w].deque, make_task(first, last - first));
+  }
+
+  printf("selfplay: %ld games, %d workers, %s vs %s\n", games, worker_count, strategy_name(strategies[0]), strategy_name(strategies[1]));
+  double start = now_ns();
+  for(int w = 0; w < worker_count; w++){
+    if(pthread_create(&workers[w].thread, NULL, worker_main, &workers[w]) != 0){
+      perror("pthread_create failed");
+      return EXIT_FAILURE;
+    }
+  }
+  for(int w = 0; w < worker_count; w++)
+    pthread_join(workers[w].thread, NULL);
+  double elapsed = now_ns() - start;
+
+  // Joined threads: their stats are now safe to read without any locking
+  WorkerStats total;
+  memset(&total, 0, sizeof(total));
+  for(int w = 0; w < worker_count; w++){
+    const WorkerStats *s = &workers[w].stats;
+    total.games += s->games;
+    for(int p = 0; p < 2; p++){
+      total.wins[p] += s->wins[p];
+      for(int k = 0; k <= MAX_SHOTS; k++)
+        total.shots_to_win[p][k] += s->shots_to_win[p][k];
+    }
+  }
+  report(&total, elapsed);
+
+  free(workers);
+  return 0;
+}
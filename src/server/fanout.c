@@ -0,0 +1,71 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+
+#include "../common/protocol.h"
+#include "fanout.h"
+
+SharedFrame *shared_frame_encode(Pool *pool, const GameMessage *msg){
+  SharedFrame *frame = pool_alloc(pool);
+  if(frame == NULL)
+    return NULL;
+  size_t len = encode_message(msg, frame->data, PROTO_MAX_FRAME);
+  if(len == 0){
+    pool_free(pool, frame);
+    return NULL;
+  }
+  frame->pool = pool;
+  frame->refs = 1;
+  frame->len = (uint16_t)len;
+  return frame;
+}
+
+void shared_frame_release(SharedFrame *frame){
+  if(frame != NULL && --frame->refs == 0)
+    pool_free(frame->pool, frame);
+}
+
+int frame_queue_push(FrameQueue *queue, SharedFrame *frame){
+  if(queue->count == FRAME_QUEUE_CAP)
+    return -1;
+  queue->frames[(queue->head + queue->count) % FRAME_QUEUE_CAP] = frame;
+  queue->count++;
+  frame->refs++;
+  return 0;
+}
+
+static void pop_head(FrameQueue *queue){
+  shared_frame_release(queue->frames[queue->head]);
+  queue->head = (queue->head + 1) % FRAME_QUEUE_CAP;
+  queue->count--;
+  queue->offset = 0;
+}
+
+int frame_queue_iov(const FrameQueue *queue, struct iovec *iov, int max){
+  int iovcnt = 0;
+  for(unsigned i = 0; i < queue->count && iovcnt < max; i++){
+    SharedFrame *frame = queue->frames[(queue->head + i) % FRAME_QUEUE_CAP];
+    size_t skip = (i == 0) ? queue->offset : 0;
+    iov[iovcnt].iov_base = frame->data + skip;
+    iov[iovcnt].iov_len = frame->len - skip;
+    iovcnt++;
+  }
+  return iovcnt;
+}
+
+void frame_queue_consume(FrameQueue *queue, size_t sent){
+  while(sent > 0 && queue->count > 0){
+    size_t left = queue->frames[queue->head]->len - queue->offset;
+    if(sent < left){
+      queue->offset += sent;
+      break;
+    }
+    sent -= left;
+    pop_head(queue);
+  }
+}
+
+void frame_queue_clear(FrameQueue *queue){
+  while(queue->count > 0)
+    pop_head(queue);
+}
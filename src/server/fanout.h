@@ -0,0 +1,56 @@
+#ifndef FANOUT_H
+#define FANOUT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include "../common/common.h"
+#include "pool.h"
+
+// Frames fanned out to spectators. An event is encoded once into a
+// SharedFrame and every watcher's FrameQueue holds a reference to it;
+// queues are written with sendmsg() straight from the shared bytes, so N
+// spectators cost N pointer pushes rather than N encodes and copies.
+//
+// Frames never leave the shard that encoded them, so references are plain
+// counters.
+typedef struct {
+  Pool *pool; // The encoding shard's frame pool, objects of PROTO_MAX_FRAME bytes of data
+  int refs;
+  uint16_t len;
+  uint8_t data[];
+} SharedFrame;
+
+// Frames a spectator may fall behind before it is dropped. Players never
+// wait on spectators: a full queue is the spectator's problem.
+#define FRAME_QUEUE_CAP 64
+
+typedef struct {
+  SharedFrame *frames[FRAME_QUEUE_CAP];
+  unsigned head;
+  unsigned count;
+  size_t offset; // Bytes of the head frame already sent
+} FrameQueue;
+
+// Encode msg into a new frame from pool, holding one reference. NULL if it
+// does not encode or memory is short.
+SharedFrame *shared_frame_encode(Pool *pool, const GameMessage *msg);
+
+void shared_frame_release(SharedFrame *frame);
+
+// Queue a reference to frame. Returns -1, taking no reference, when the
+// queue is full.
+int frame_queue_push(FrameQueue *queue, SharedFrame *frame);
+
+// Describe the unsent bytes, oldest first, in up to max iovecs for
+// writev()/sendmsg(). Returns the number filled.
+int frame_queue_iov(const FrameQueue *queue, struct iovec *iov, int max);
+
+// Drop the frames covered by sent bytes of a write of frame_queue_iov().
+void frame_queue_consume(FrameQueue *queue, size_t sent);
+
+// Drop every queued reference.
+void frame_queue_clear(FrameQueue *queue);
+
+#endif // FANOUT_H
@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "hint_worker.h"
+
+struct HintWorker {
+  Solver *solver; // The worker thread's alone
+  int wake_fd;
+
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  HintJob *head; // Waiting for the worker, oldest first
+  HintJob *tail;
+  int stop;
+  pthread_t thread;
+
+  _Atomic(HintJob *) done; // Lock-free stack of answers, newest first
+};
+
+static void post_answer(HintWorker *worker, HintJob *job){
+  HintJob *head = atomic_load_explicit(&worker->done, memory_order_relaxed);
+  do{
+    job->next = head;
+  } while(!atomic_compare_exchange_weak_explicit(&worker->done, &head, job, memory_order_release, memory_order_relaxed));
+
+  uint64_t one = 1;
+  if(write(worker->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+    perror("eventfd write failed");
+}
+
+static void *worker_thread(void *arg){
+  HintWorker *worker = arg;
+  for(;;){
+    pthread_mutex_lock(&worker->lock);
+    while(worker->head == NULL && !worker->stop)
+      pthread_cond_wait(&worker->wake, &worker->lock);
+    if(worker->stop){
+      pthread_mutex_unlock(&worker->lock);
+      break;
+    }
+    HintJob *job = worker->head;
+    worker->head = job->next;
+    if(worker->head == NULL)
+      worker->tail = NULL;
+    pthread_mutex_unlock(&worker->lock);
+
+    solver_analyze(worker->solver, &job->view, job->budget_ns, &job->result);
+    post_answer(worker, job);
+  }
+  return NULL;
+}
+
+HintWorker *hint_worker_start(int wake_fd){
+  HintWorker *worker = calloc(1, sizeof(*worker));
+  if(worker == NULL)
+    return NULL;
+  worker->solver = solver_create();
+  if(worker->solver == NULL){
+    free(worker);
+    return NULL;
+  }
+  worker->wake_fd = wake_fd;
+  atomic_init(&worker->done, NULL);
+  pthread_mutex_init(&worker->lock, NULL);
+  pthread_cond_init(&worker->wake, NULL);
+  if(pthread_create(&worker->thread, NULL, worker_thread, worker) != 0){
+    pthread_mutex_destroy(&worker->lock);
+    pthread_cond_destroy(&worker->wake);
+    solver_destroy(worker->solver);
+    free(worker);
+    return NULL;
+  }
+  return worker;
+}
+
+void hint_worker_submit(HintWorker *worker, HintJob *job){
+  job->next = NULL;
+  pthread_mutex_lock(&worker->lock);
+  if(worker->tail != NULL)
+    worker->tail->next = job;
+  else
+    worker->head = job;
+  worker->tail = job;
+  pthread_cond_signal(&worker->wake);
+  pthread_mutex_unlock(&worker->lock);
+}
+
+HintJob *hint_worker_take(HintWorker *worker){
+  if(atomic_load_explicit(&worker->done, memory_order_relaxed) == NULL)
+    return NULL;
+  HintJob *list = atomic_exchange_explicit(&worker->done, NULL, memory_order_acquire);
+  HintJob *ordered = NULL;
+  while(list != NULL){
+    HintJob *next = list->next;
+    list->next = ordered;
+    ordered = list;
+    list = next;
+  }
+  return ordered;
+}
+
+void hint_worker_stop(HintWorker *worker){
+  if(worker == NULL)
+    return;
+  pthread_mutex_lock(&worker->lock);
+  worker->stop = 1;
+  pthread_cond_signal(&worker->wake);
+  pthread_mutex_unlock(&worker->lock);
+  pthread_join(worker->thread, NULL);
+
+  while(worker->head != NULL){
+    HintJob *next = worker->head->next;
+    free(worker->head);
+    worker->head = next;
+  }
+  HintJob *answered = hint_worker_take(worker);
+  while(answered != NULL){
+    HintJob *next = answered->next;
+    free(answered);
+    answered = next;
+  }
+  pthread_mutex_destroy(&worker->lock);
+  pthread_cond_destroy(&worker->wake);
+  solver_destroy(worker->solver);
+  free(worker);
+}
@@ -0,0 +1,44 @@
+#ifndef HINT_WORKER_H
+#define HINT_WORKER_H
+
+#include <stdint.h>
+
+#include "../common/ai.h"
+#include "../common/solver.h"
+
+// Runs the endgame solver for hint requests off the event loop. A shard
+// hands each request to its own worker thread, which analyses the view
+// within the request's budget and posts the answer back; the shard picks
+// answers up after its next wakeup and sends the ones whose turn is still
+// being played.
+//
+// One worker per event loop: submit and take must come from one thread.
+typedef struct HintWorker HintWorker;
+
+typedef struct HintJob HintJob;
+struct HintJob {
+  HintJob *next;
+  int session_id;
+  int player;
+  uint32_t turn;       // Session's turn count when asked; a later turn drops the answer
+  AiPlayer view;       // What the player has been told of the other fleet
+  uint64_t budget_ns;
+  uint64_t asked_ns;
+  SolverResult result; // Filled in by the worker
+};
+
+// Start the thread; wake_fd (an eventfd) is written after every answer.
+// Returns NULL on failure.
+HintWorker *hint_worker_start(int wake_fd);
+
+// Queue job, which the worker owns until it comes back from take.
+void hint_worker_submit(HintWorker *worker, HintJob *job);
+
+// Answered jobs, oldest first, for the caller to free. NULL if none.
+HintJob *hint_worker_take(HintWorker *worker);
+
+// Wait for the job in progress, then free the worker and every job it
+// still holds.
+void hint_worker_stop(HintWorker *worker);
+
+#endif // HINT_WORKER_H
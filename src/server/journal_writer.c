@@ -0,0 +1,210 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "journal_writer.h"
+
+typedef struct {
+  uint8_t *data;
+  size_t len;
+  size_t cap;
+} ByteBuf;
+
+struct JournalWriter {
+  int fd;
+  char *path;
+  uint64_t epoch_ns;
+  uint64_t records; // Handed to the writer thread over its lifetime; dropped batches don't count
+  ByteBuf local; // Filled by the event loop, no locking
+
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  ByteBuf pending; // Handed over, waiting for the writer thread
+  int stop;
+  uint64_t dropped; // Records lost because the disk fell too far behind
+  pthread_t thread;
+};
+
+static uint64_t clock_ns(clockid_t clock){
+  struct timespec ts;
+  clock_gettime(clock, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int buf_reserve(ByteBuf *buf, size_t extra){
+  if(buf->len + extra <= buf->cap)
+    return 0;
+  size_t cap = buf->cap ? buf->cap : 4096;
+  while(cap < buf->len + extra)
+    cap *= 2;
+  uint8_t *data = realloc(buf->data, cap);
+  if(data == NULL)
+    return -1;
+  buf->data = data;
+  buf->cap = cap;
+  return 0;
+}
+
+static int write_all(int fd, const uint8_t *data, size_t len){
+  while(len > 0){
+    ssize_t n = write(fd, data, len);
+    if(n < 0){
+      if(errno == EINTR)
+        continue;
+      return -1;
+    }
+    data += n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+// Swap the pending buffer out under the lock, then write it with the lock
+// released so the event loop can keep handing over batches meanwhile.
+static void *writer_thread(void *arg){
+  JournalWriter *writer = arg;
+  ByteBuf out = {0};
+  int dirty = 0; // Written but not yet synced
+  uint64_t last_sync = clock_ns(CLOCK_MONOTONIC);
+
+  for(;;){
+    pthread_mutex_lock(&writer->lock);
+    while(writer->pending.len == 0 && !writer->stop){
+      if(!dirty){
+        pthread_cond_wait(&writer->wake, &writer->lock);
+        continue;
+      }
+      uint64_t due = last_sync + (uint64_t)JOURNAL_SYNC_MS * 1000000ull;
+      if(clock_ns(CLOCK_MONOTONIC) >= due)
+        break;
+      struct timespec deadline;
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_nsec += JOURNAL_SYNC_MS * 1000000L;
+      if(deadline.tv_nsec >= 1000000000L){
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+      }
+      pthread_cond_timedwait(&writer->wake, &writer->lock, &deadline);
+    }
+    ByteBuf swap = writer->pending;
+    writer->pending = out;
+    out = swap;
+    int stop = writer->stop;
+    pthread_mutex_unlock(&writer->lock);
+
+    if(out.len > 0){
+      if(write_all(writer->fd, out.data, out.len) < 0)
+        perror("journal write failed");
+      out.len = 0;
+      dirty = 1;
+    }
+    uint64_t now = clock_ns(CLOCK_MONOTONIC);
+    if(dirty && (stop || now - last_sync >= (uint64_t)JOURNAL_SYNC_MS * 1000000ull)){
+      fdatasync(writer->fd);
+      last_sync = now;
+      dirty = 0;
+    }
+    if(stop)
+      break;
+  }
+  free(out.data);
+  return NULL;
+}
+
+JournalWriter *journal_writer_open(const char *path){
+  JournalWriter *writer = calloc(1, sizeof(*writer));
+  if(writer == NULL)
+    return NULL;
+  writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if(writer->fd < 0){
+    free(writer);
+    return NULL;
+  }
+  writer->path = strdup(path);
+  writer->epoch_ns = clock_ns(CLOCK_REALTIME);
+
+  uint8_t header[JOURNAL_HEADER_LEN];
+  journal_encode_header(header, writer->epoch_ns);
+  if(writer->path == NULL || write_all(writer->fd, header, sizeof(header)) < 0){
+    close(writer->fd);
+    free(writer->path);
+    free(writer);
+    return NULL;
+  }
+
+  pthread_mutex_init(&writer->lock, NULL);
+  pthread_cond_init(&writer->wake, NULL);
+  if(pthread_create(&writer->thread, NULL, writer_thread, writer) != 0){
+    pthread_mutex_destroy(&writer->lock);
+    pthread_cond_destroy(&writer->wake);
+    close(writer->fd);
+    free(writer->path);
+    free(writer);
+    return NULL;
+  }
+  return writer;
+}
+
+void journal_writer_append(JournalWriter *writer, JournalRecord *rec){
+  rec->time_ms = (uint32_t)((clock_ns(CLOCK_REALTIME) - writer->epoch_ns) / 1000000);
+  if(buf_reserve(&writer->local, JOURNAL_RECORD_LEN) < 0){
+    writer->dropped++;
+    return;
+  }
+  journal_encode_record(rec, writer->local.data + writer->local.len);
+  writer->local.len += JOURNAL_RECORD_LEN;
+}
+
+uint64_t journal_writer_records(const JournalWriter *writer){
+  return writer->records;
+}
+
+const char *journal_writer_path(const JournalWriter *writer){
+  return writer->path;
+}
+
+void journal_writer_flush(JournalWriter *writer){
+  if(writer->local.len == 0)
+    return;
+  pthread_mutex_lock(&writer->lock);
+  if(writer->pending.len + writer->local.len > JOURNAL_MAX_PENDING || buf_reserve(&writer->pending, writer->local.len) < 0){
+    if(writer->dropped == 0)
+      fprintf(stderr, "journal: disk is falling behind, dropping records\n");
+    writer->dropped += writer->local.len / JOURNAL_RECORD_LEN;
+  }
+  else{
+    memcpy(writer->pending.data + writer->pending.len, writer->local.data, writer->local.len);
+    writer->pending.len += writer->local.len;
+    writer->records += writer->local.len / JOURNAL_RECORD_LEN;
+  }
+  pthread_cond_signal(&writer->wake);
+  pthread_mutex_unlock(&writer->lock);
+  writer->local.len = 0;
+}
+
+void journal_writer_close(JournalWriter *writer){
+  if(writer == NULL)
+    return;
+  journal_writer_flush(writer);
+  pthread_mutex_lock(&writer->lock);
+  writer->stop = 1;
+  pthread_cond_signal(&writer->wake);
+  pthread_mutex_unlock(&writer->lock);
+  pthread_join(writer->thread, NULL);
+
+  if(writer->dropped > 0)
+    fprintf(stderr, "journal: %llu records dropped\n", (unsigned long long)writer->dropped);
+  close(writer->fd);
+  pthread_mutex_destroy(&writer->lock);
+  pthread_cond_destroy(&writer->wake);
+  free(writer->local.data);
+  free(writer->pending.data);
+  free(writer->path);
+  free(writer);
+}
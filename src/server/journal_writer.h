@@ -0,0 +1,36 @@
+#ifndef JOURNAL_WRITER_H
+#define JOURNAL_WRITER_H
+
+#include "../common/journal.h"
+
+// Appends journal records to a file without the event loop ever touching
+// the disk. Records collect in a buffer owned by the loop; a flush at the
+// end of each event batch hands them to a background thread which writes
+// them out and fsyncs at most every JOURNAL_SYNC_MS.
+//
+// One writer per event loop: append and flush must come from one thread.
+typedef struct JournalWriter JournalWriter;
+
+#define JOURNAL_SYNC_MS 50
+#define JOURNAL_MAX_PENDING (64 * 1024 * 1024) // Bytes queued before records are dropped
+
+// Create path and write the file header. Returns NULL on failure.
+JournalWriter *journal_writer_open(const char *path);
+
+// Queue one record. time_ms is filled in here.
+void journal_writer_append(JournalWriter *writer, JournalRecord *rec);
+
+// Records handed to the writer thread so far, skipping any batch that was
+// dropped; with a flush first, the journal position a snapshot taken now
+// corresponds to.
+uint64_t journal_writer_records(const JournalWriter *writer);
+
+const char *journal_writer_path(const JournalWriter *writer);
+
+// Hand everything appended so far to the writer thread.
+void journal_writer_flush(JournalWriter *writer);
+
+// Flush, wait for the data to reach the disk and free the writer.
+void journal_writer_close(JournalWriter *writer);
+
+#endif // JOURNAL_WRITER_H
@@ -0,0 +1,215 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <stddef.h>
+
+#include "../common/common.h"
+#include "metrics.h"
+
+typedef struct {
+  int listen_fd;
+  Metrics *const *sources;
+  int count;
+} MetricsEndpoint;
+
+static const char *msg_type_names[] = {
+  [MSG_TYPE_TEST] = "test",
+  [MSG_TYPE_PLACEMENT_REQ] = "placement_req",
+  [MSG_TYPE_PLACEMENT_RES] = "placement_res",
+  [MSG_TYPE_SHOT_REQ] = "shot_req",
+  [MSG_TYPE_SHOT_RES] = "shot_res",
+  [MSG_TYPE_TURN_IND] = "turn_ind",
+  [MSG_TYPE_GAME_OVER] = "game_over",
+  [MSG_TYPE_PLACE_SHIP_PROMPT] = "place_ship_prompt",
+  [MSG_TYPE_AI_GAME_REQ] = "ai_game_req",
+  [MSG_TYPE_RESUME_TOKEN] = "resume_token",
+  [MSG_TYPE_RESUME_REQ] = "resume_req",
+  [MSG_TYPE_RESUME_RES] = "resume_res",
+  [MSG_TYPE_CONFIG_REQ] = "config_req",
+  [MSG_TYPE_CONFIG] = "config",
+  [MSG_TYPE_SALVO_REQ] = "salvo_req",
+  [MSG_TYPE_SALVO_RES] = "salvo_res",
+  [MSG_TYPE_FLEET_REQ] = "fleet_req",
+  [MSG_TYPE_FLEET_RES] = "fleet_res",
+  [MSG_TYPE_SPECTATE_REQ] = "spectate_req",
+  [MSG_TYPE_SPECTATE_RES] = "spectate_res",
+  [MSG_TYPE_SHM_REQ] = "shm_req",
+  [MSG_TYPE_SHM_RES] = "shm_res",
+  [MSG_TYPE_HINT_REQ] = "hint_req",
+  [MSG_TYPE_HINT_RES] = "hint_res",
+};
+
+static const char *pool_names[METRICS_POOLS] = {
+  [POOL_SESSIONS] = "session",
+  [POOL_CONNECTIONS] = "connection",
+  [POOL_FRAMES] = "frame",
+  [POOL_ARENA_CHUNKS] = "arena_chunk",
+  [POOL_OUT_BUFS] = "out_buf",
+};
+
+static uint64_t load(const _Atomic uint64_t *value){
+  return atomic_load_explicit(value, memory_order_relaxed);
+}
+
+static uint64_t sum_counter(const MetricsEndpoint *ep, size_t offset){
+  uint64_t total = 0;
+  for(int i = 0; i < ep->count; i++)
+    total += load((const _Atomic uint64_t *)((const char *)ep->sources[i] + offset));
+  return total;
+}
+
+static int64_t sum_gauge(const MetricsEndpoint *ep, size_t offset){
+  int64_t total = 0;
+  for(int i = 0; i < ep->count; i++)
+    total += atomic_load_explicit((const _Atomic int64_t *)((const char *)ep->sources[i] + offset), memory_order_relaxed);
+  return total;
+}
+
+static void print_messages(FILE *out, const MetricsEndpoint *ep, const char *name, size_t offset){
+  fprintf(out, "# TYPE %s counter\n", name);
+  for(int type = 0; type < METRICS_MSG_TYPES; type++){
+    uint64_t total = sum_counter(ep, offset + (size_t)type * sizeof(_Atomic uint64_t));
+    if(total == 0)
+      continue;
+    int named = type < (int)(sizeof(msg_type_names) / sizeof(msg_type_names[0])) && msg_type_names[type] != NULL;
+    if(named)
+      fprintf(out, "%s{type=\"%s\"} %llu\n", name, msg_type_names[type], (unsigned long long)total);
+    else
+      fprintf(out, "%s{type=\"%d\"} %llu\n", name, type, (unsigned long long)total);
+  }
+}
+
+// Pools are per shard but objects move between them, so only the sums mean
+// anything.
+static void print_pools(FILE *out, const MetricsEndpoint *ep, const char *name, size_t offset){
+  fprintf(out, "# TYPE %s gauge\n", name);
+  for(int pool = 0; pool < METRICS_POOLS; pool++)
+    fprintf(out, "%s{pool=\"%s\"} %lld\n", name, pool_names[pool], (long long)sum_gauge(ep, offset + (size_t)pool * sizeof(_Atomic int64_t)));
+}
+
+// Merge one histogram across shards and print it as a summary.
+static void print_histogram(FILE *out, const MetricsEndpoint *ep, const char *name, size_t offset){
+  static const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+  uint64_t counts[HIST_BUCKETS];
+  uint64_t total = 0, sum = 0, max = 0;
+  memset(counts, 0, sizeof(counts));
+  for(int i = 0; i < ep->count; i++){
+    const Histogram *hist = (const Histogram *)((const char *)ep->sources[i] + offset);
+    for(unsigned b = 0; b < HIST_BUCKETS; b++){
+      uint64_t n = load(&hist->counts[b]);
+      counts[b] += n;
+      total += n; // Summing buckets keeps the quantiles self-consistent under concurrent updates
+    }
+    sum += load(&hist->sum);
+    uint64_t hist_max = load(&hist->max);
+    if(hist_max > max)
+      max = hist_max;
+  }
+
+  fprintf(out, "# TYPE %s summary\n", name);
+  size_t q = 0;
+  uint64_t seen = 0;
+  for(unsigned b = 0; b < HIST_BUCKETS && q < sizeof(quantiles) / sizeof(quantiles[0]); b++){
+    seen += counts[b];
+    while(q < sizeof(quantiles) / sizeof(quantiles[0]) && total > 0 && (double)seen >= quantiles[q] * (double)total){
+      uint64_t limit = hist_bucket_limit(b);
+      fprintf(out, "%s{quantile=\"%g\"} %llu\n", name, quantiles[q], (unsigned long long)(limit < max ? limit : max));
+      q++;
+    }
+  }
+  fprintf(out, "%s_max %llu\n", name, (unsigned long long)max);
+  fprintf(out, "%s_sum %llu\n", name, (unsigned long long)sum);
+  fprintf(out, "%s_count %llu\n", name, (unsigned long long)total);
+}
+
+static void write_metrics(FILE *out, const MetricsEndpoint *ep){
+#define COUNTER(name, field) \
+  fprintf(out, "# TYPE " name " counter\n" name " %llu\n", (unsigned long long)sum_counter(ep, offsetof(Metrics, field)))
+#define GAUGE(name, field) \
+  fprintf(out, "# TYPE " name " gauge\n" name " %lld\n", (long long)sum_gauge(ep, offsetof(Metrics, field)))
+  COUNTER("battleship_connections_accepted_total", connections_accepted);
+  COUNTER("battleship_connections_closed_total", connections_closed);
+  COUNTER("battleship_disconnects_total", disconnects);
+  COUNTER("battleship_invalid_placements_total", invalid_placements);
+  COUNTER("battleship_games_started_total", games_started);
+  COUNTER("battleship_games_finished_total", games_finished);
+  COUNTER("battleship_spectators_dropped_total", spectators_dropped);
+  COUNTER("battleship_timeouts_total", timeouts);
+  COUNTER("battleship_idle_reaped_total", idle_reaped);
+  COUNTER("battleship_io_syscalls_total", io_syscalls);
+  GAUGE("battleship_active_games", active_games);
+  GAUGE("battleship_lobby_waiting", lobby_waiting);
+  GAUGE("battleship_spectators", spectators);
+#undef COUNTER
+#undef GAUGE
+  print_messages(out, ep, "battleship_messages_received_total", offsetof(Metrics, messages_in));
+  print_messages(out, ep, "battleship_messages_sent_total", offsetof(Metrics, messages_out));
+  print_pools(out, ep, "battleship_pool_objects_in_use", offsetof(Metrics, pool_in_use));
+  print_pools(out, ep, "battleship_pool_objects_capacity", offsetof(Metrics, pool_capacity));
+  print_histogram(out, ep, "battleship_turn_latency_ns", offsetof(Metrics, turn_ns));
+  print_histogram(out, ep, "battleship_take_shot_ns", offsetof(Metrics, take_shot_ns));
+  print_histogram(out, ep, "battleship_hint_ns", offsetof(Metrics, hint_ns));
+}
+
+static void *metrics_thread(void *arg){
+  MetricsEndpoint *ep = arg;
+  for(;;){
+    int fd = accept(ep->listen_fd, NULL, NULL);
+    if(fd < 0){
+      if(errno == EINTR || errno == ECONNABORTED)
+        continue;
+      perror("metrics accept failed");
+      return NULL;
+    }
+    FILE *out = fdopen(fd, "w");
+    if(out == NULL){
+      close(fd);
+      continue;
+    }
+    write_metrics(out, ep);
+    fclose(out);
+  }
+}
+
+int metrics_serve(const char *path, Metrics *const *sources, int count){
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if(strlen(path) >= sizeof(addr.sun_path)){
+    fprintf(stderr, "metrics socket path too long: %s\n", path);
+    return -1;
+  }
+  strcpy(addr.sun_path, path);
+
+  MetricsEndpoint *ep = calloc(1, sizeof(*ep));
+  if(ep == NULL)
+    return -1;
+  ep->sources = sources;
+  ep->count = count;
+  ep->listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if(ep->listen_fd < 0){
+    free(ep);
+    return -1;
+  }
+  unlink(path); // Left over from a previous run
+  if(bind(ep->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(ep->listen_fd, 16) < 0){
+    close(ep->listen_fd);
+    free(ep);
+    return -1;
+  }
+
+  pthread_t thread;
+  if(pthread_create(&thread, NULL, metrics_thread, ep) != 0){
+    close(ep->listen_fd);
+    free(ep);
+    return -1;
+  }
+  pthread_detach(thread);
+  return 0;
+}
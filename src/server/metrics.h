@@ -0,0 +1,104 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Server telemetry. Every event loop owns one Metrics and is its only
+// writer, so updates are plain relaxed loads and stores with no locked
+// instructions; the metrics thread sums all shards when a scraper connects.
+
+// Log-linear (HDR-style) histogram: values below HIST_SUB are exact, above
+// that every power of two is split into HIST_SUB buckets, so any recorded
+// value is off by at most 1/HIST_SUB (about 6%).
+#define HIST_SUB_BITS 4
+#define HIST_SUB (1u << HIST_SUB_BITS)
+#define HIST_BUCKETS (64 * HIST_SUB)
+
+typedef struct {
+  _Atomic uint64_t counts[HIST_BUCKETS];
+  _Atomic uint64_t total;
+  _Atomic uint64_t sum;
+  _Atomic uint64_t max;
+} Histogram;
+
+#define METRICS_MSG_TYPES 32 // Counted per MSG_TYPE_*, larger types share the last slot
+
+// Object pools reported per kind, see pool.h
+#define POOL_SESSIONS 0
+#define POOL_CONNECTIONS 1
+#define POOL_FRAMES 2
+#define POOL_ARENA_CHUNKS 3
+#define POOL_OUT_BUFS 4
+#define METRICS_POOLS 5
+
+typedef struct {
+  _Atomic uint64_t connections_accepted;
+  _Atomic uint64_t connections_closed;
+  _Atomic uint64_t disconnects; // Players who left a running game
+  _Atomic uint64_t invalid_placements;
+  _Atomic uint64_t games_started;
+  _Atomic uint64_t games_finished;
+  _Atomic int64_t active_games;
+  _Atomic int64_t lobby_waiting;
+  _Atomic int64_t spectators;
+  _Atomic uint64_t spectators_dropped; // Fell FRAME_QUEUE_CAP frames behind
+  _Atomic uint64_t timeouts; // Games forfeited on a turn or placement deadline
+  _Atomic uint64_t idle_reaped; // Unpaired connections closed for silence
+  _Atomic uint64_t io_syscalls; // epoll and socket calls, or io_uring_enter calls with -U
+  _Atomic uint64_t messages_in[METRICS_MSG_TYPES];
+  _Atomic uint64_t messages_out[METRICS_MSG_TYPES];
+  _Atomic int64_t pool_in_use[METRICS_POOLS];
+  _Atomic int64_t pool_capacity[METRICS_POOLS];
+  Histogram turn_ns;      // Shot request decoded to all replies queued, for shots actually fired
+  Histogram take_shot_ns; // take_shot() alone
+  Histogram hint_ns;      // Hint request to answer, queueing and solver included
+} Metrics;
+
+// Single-writer updates: no read-modify-write on the bus.
+static inline void metric_add(_Atomic uint64_t *counter, uint64_t n){
+  atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+static inline void metric_set(_Atomic int64_t *gauge, int64_t value){
+  atomic_store_explicit(gauge, value, memory_order_relaxed);
+}
+
+static inline void metric_count_message(_Atomic uint64_t *by_type, int type){
+  if(type < 0 || type >= METRICS_MSG_TYPES)
+    type = METRICS_MSG_TYPES - 1;
+  metric_add(&by_type[type], 1);
+}
+
+static inline unsigned hist_bucket(uint64_t value){
+  if(value < HIST_SUB)
+    return (unsigned)value;
+  unsigned shift = (unsigned)(63 - __builtin_clzll(value)) - HIST_SUB_BITS;
+  return ((shift + 1) << HIST_SUB_BITS) + (unsigned)((value >> shift) & (HIST_SUB - 1));
+}
+
+// Largest value that lands in bucket.
+static inline uint64_t hist_bucket_limit(unsigned bucket){
+  if(bucket < HIST_SUB)
+    return bucket;
+  unsigned shift = (bucket >> HIST_SUB_BITS) - 1;
+  uint64_t mantissa = HIST_SUB + (bucket & (HIST_SUB - 1));
+  return ((mantissa + 1) << shift) - 1;
+}
+
+static inline void histogram_record(Histogram *hist, uint64_t value){
+  metric_add(&hist->counts[hist_bucket(value)], 1);
+  metric_add(&hist->total, 1);
+  metric_add(&hist->sum, value);
+  if(value > atomic_load_explicit(&hist->max, memory_order_relaxed))
+    atomic_store_explicit(&hist->max, value, memory_order_relaxed);
+}
+
+// Serve a text dump of the summed metrics on a Unix socket at path, from a
+// background thread. Each connection gets one dump and is closed, so
+// `nc -U path` or `socat - UNIX-CONNECT:path` is a complete scraper.
+// sources must stay valid for the life of the process. Returns -1 if the
+// socket cannot be set up.
+int metrics_serve(const char *path, Metrics *const *sources, int count);
+
+#endif // METRICS_H
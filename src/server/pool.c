@@ -0,0 +1,155 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdalign.h>
+
+#include "pool.h"
+
+struct PoolSlab {
+  PoolSlab *next;
+};
+
+struct PoolFree {
+  PoolFree *next;
+};
+
+// The slab header takes one line so objects stay aligned
+#define SLAB_HEADER POOL_ALIGN
+
+void pool_init(Pool *pool, size_t obj_size, size_t per_slab){
+  memset(pool, 0, sizeof(*pool));
+  pool->obj_size = (obj_size + POOL_ALIGN - 1) & ~(size_t)(POOL_ALIGN - 1);
+  pool->per_slab = per_slab ? per_slab : 1;
+  atomic_init(&pool->remote_free, NULL);
+}
+
+static int grow(Pool *pool){
+  PoolSlab *slab = aligned_alloc(POOL_ALIGN, SLAB_HEADER + pool->per_slab * pool->obj_size);
+  if(slab == NULL)
+    return -1;
+  slab->next = pool->slabs;
+  pool->slabs = slab;
+  // Thread the new objects in address order
+  unsigned char *objs = (unsigned char *)slab + SLAB_HEADER;
+  for(size_t i = pool->per_slab; i-- > 0;){
+    PoolFree *obj = (PoolFree *)(objs + i * pool->obj_size);
+    obj->next = pool->free_list;
+    pool->free_list = obj;
+  }
+  pool->capacity += (int64_t)pool->per_slab;
+  return 0;
+}
+
+void *pool_alloc(Pool *pool){
+  if(pool->free_list == NULL)
+    pool_reclaim(pool);
+  if(pool->free_list == NULL && grow(pool) < 0)
+    return NULL;
+  PoolFree *obj = pool->free_list;
+  pool->free_list = obj->next;
+  pool->in_use++;
+  memset(obj, 0, pool->obj_size);
+  return obj;
+}
+
+void pool_free(Pool *pool, void *obj){
+  if(obj == NULL)
+    return;
+  PoolFree *node = obj;
+  node->next = pool->free_list;
+  pool->free_list = node;
+  pool->in_use--;
+}
+
+void pool_free_remote(Pool *pool, void *obj){
+  if(obj == NULL)
+    return;
+  PoolFree *node = obj;
+  PoolFree *head = atomic_load_explicit(&pool->remote_free, memory_order_relaxed);
+  do{
+    node->next = head;
+  } while(!atomic_compare_exchange_weak_explicit(&pool->remote_free, &head, node, memory_order_release, memory_order_relaxed));
+}
+
+void pool_reclaim(Pool *pool){
+  if(atomic_load_explicit(&pool->remote_free, memory_order_relaxed) == NULL)
+    return;
+  // The owner takes the whole list at once, so there is no ABA to guard against
+  PoolFree *list = atomic_exchange_explicit(&pool->remote_free, NULL, memory_order_acquire);
+  while(list != NULL){
+    PoolFree *next = list->next;
+    list->next = pool->free_list;
+    pool->free_list = list;
+    pool->in_use--;
+    list = next;
+  }
+}
+
+void pool_destroy(Pool *pool){
+  while(pool->slabs != NULL){
+    PoolSlab *next = pool->slabs->next;
+    free(pool->slabs);
+    pool->slabs = next;
+  }
+  pool->free_list = NULL;
+  atomic_store_explicit(&pool->remote_free, NULL, memory_order_relaxed);
+  pool->capacity = pool->in_use = 0;
+}
+
+struct ArenaChunk {
+  ArenaChunk *next;
+  int pooled; // 0 for an oversized chunk from malloc()
+  alignas(max_align_t) unsigned char data[];
+};
+
+#define CHUNK_DATA (ARENA_CHUNK - offsetof(ArenaChunk, data))
+
+void arena_init(Arena *arena, Pool *chunks){
+  arena->chunks = chunks;
+  arena->head = NULL;
+  arena->used = 0;
+}
+
+void *arena_alloc(Arena *arena, size_t size){
+  size = (size + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+  if(arena->head != NULL && arena->head->pooled && size <= CHUNK_DATA - arena->used){
+    void *ptr = arena->head->data + arena->used;
+    arena->used += size;
+    return ptr;
+  }
+  if(size > CHUNK_DATA){
+    ArenaChunk *chunk = malloc(offsetof(ArenaChunk, data) + size);
+    if(chunk == NULL)
+      return NULL;
+    chunk->pooled = 0;
+    if(arena->head != NULL && arena->head->pooled){
+      // Behind the head, which keeps filling
+      chunk->next = arena->head->next;
+      arena->head->next = chunk;
+    }
+    else{
+      chunk->next = arena->head;
+      arena->head = chunk;
+    }
+    return chunk->data;
+  }
+  ArenaChunk *chunk = pool_alloc(arena->chunks);
+  if(chunk == NULL)
+    return NULL;
+  chunk->pooled = 1;
+  chunk->next = arena->head;
+  arena->head = chunk;
+  arena->used = size;
+  return chunk->data;
+}
+
+void arena_reset(Arena *arena){
+  while(arena->head != NULL){
+    ArenaChunk *next = arena->head->next;
+    if(arena->head->pooled)
+      pool_free(arena->chunks, arena->head);
+    else
+      free(arena->head);
+    arena->head = next;
+  }
+  arena->used = 0;
+}
@@ -0,0 +1,75 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Allocation for a busy shard without going back to malloc for every game.
+// Sessions, connections and spectator frames come from fixed-size pools:
+// objects are carved from slabs, start on their own cache line and are
+// recycled through a free list. Buffers that only live as long as a game
+// come from its arena and are all dropped together when the game ends.
+//
+// Pools are single threaded like the rest of a shard. A connection handed
+// over between shards is last served far from the pool it came from, so
+// its owner gives it back with pool_free_remote(): a lock-free list the
+// owning shard takes over whole, before growing or publishing its stats.
+// Slabs are never given back while the server runs, and pool_destroy()
+// waits until every shard has stopped.
+
+#define POOL_ALIGN 64
+
+typedef struct PoolSlab PoolSlab;
+typedef struct PoolFree PoolFree;
+
+typedef struct {
+  size_t obj_size;   // Rounded up to POOL_ALIGN
+  size_t per_slab;
+  PoolFree *free_list;
+  _Atomic(PoolFree *) remote_free; // Given back by other shards, not yet reclaimed
+  PoolSlab *slabs;
+  int64_t in_use;    // Objects out, counting those on remote_free until reclaimed
+  int64_t capacity;  // Objects in this pool's slabs
+} Pool;
+
+void pool_init(Pool *pool, size_t obj_size, size_t per_slab);
+
+// Zeroed object, NULL if a new slab was needed and memory is short.
+void *pool_alloc(Pool *pool);
+
+void pool_free(Pool *pool, void *obj);
+
+// Give obj back to the pool it came from when that pool belongs to another
+// thread. Safe from any number of threads at once.
+void pool_free_remote(Pool *pool, void *obj);
+
+// Move what other threads gave back onto the free list. Owner only.
+void pool_reclaim(Pool *pool);
+
+// Release every slab. Objects still out, whichever pool they were freed
+// to, are gone with them.
+void pool_destroy(Pool *pool);
+
+// Chunks handed to arenas by a shard's chunk pool. Requests larger than a
+// chunk get one of their own from malloc().
+#define ARENA_CHUNK 16384
+
+typedef struct ArenaChunk ArenaChunk;
+
+typedef struct {
+  Pool *chunks;     // Pool of ARENA_CHUNK objects, the shard's
+  ArenaChunk *head; // Chunk being filled, earlier ones behind it
+  size_t used;      // Bytes of head handed out
+} Arena;
+
+void arena_init(Arena *arena, Pool *chunks);
+
+// size bytes, aligned for any type. NULL if memory is short. There is no
+// per-allocation free.
+void *arena_alloc(Arena *arena, size_t size);
+
+// Give every chunk back at once.
+void arena_reset(Arena *arena);
+
+#endif // POOL_H
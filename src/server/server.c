@@ -1,30 +1,2560 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <sys/socket.h>
+#include <sys/epoll.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <unistd.h>
 #include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/random.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/un.h>
+#include <fcntl.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 
 #include "../common/game_logic.h"
+#include "../common/game_board.h"
 #include "../common/common.h"
+#include "../common/protocol.h"
+#include "../common/ai.h"
+#include "../common/shm_ring.h"
+#include "journal_writer.h"
+#include "snapshot.h"
+#include "metrics.h"
+#include "fanout.h"
+#include "timer_wheel.h"
+#include "uring.h"
+#include "pool.h"
+#include "hint_worker.h"
 
 #define MAX_CLIENT 2
+#define MAX_EVENTS 256
+#define ACCEPT_BATCH 64 // Accepts per wakeup, so a connect storm can't starve running games
+#define HANDOFF_MS 20 // A lone waiter older than this moves to shard 0 to find an opponent
+#define URING_ENTRIES 1024
+#define URING_BUFS 2048 // Provided receive buffers per shard, a power of two
+#define URING_BUF_SIZE PROTO_MAX_FRAME
+#define POOL_SLAB_OBJECTS 64 // Objects per slab, for every pool but the frames
+#define FRAME_SLAB_OBJECTS 256
+#define OUT_BUF_SIZE (PROTO_MAX_FRAME * 2) // Pooled output buffers; larger ones are malloc()ed
+#define SESSION_BUCKETS 256 // Initial size of a shard's session index, a power of two
 
-int main(){
-  int listen_sock, client_sock[MAX_CLIENT];
-  struct sockaddr_in server_addr, client_addr;
-  socklen_t client_len = sizeof(client_addr);
+static int quiet = 0; // -q: skip per-event logging, e.g. under load tests
+static int ai_opponents = 0; // -a: every connection plays the computer
+static int stats_interval = 10; // -r: seconds between lobby reports, 0 disables
+static int num_shards = 1; // -t: event-loop threads, each with its own listener
+static const char *journal_dir = NULL; // -j: write a game journal per shard into this directory
+static int snapshot_interval = 10; // -S: seconds between snapshots of live games (needs -j), 0 disables
+static uint64_t resume_secret; // Keys resume tokens; carried across restarts by snapshots
+static const char *metrics_path = NULL; // -m: Unix socket serving metrics
+static int turn_timeout = 60; // -T: seconds a player has for a shot, 0 disables
+static int placement_timeout = 60; // -P: seconds a player has for each ship, 0 disables
+static int idle_timeout = 300; // -I: seconds an unpaired connection may stay silent, 0 disables
+static int use_uring = 0; // -U: run the shards on io_uring where the kernel supports it
+static const char *unix_path = NULL; // -u: also listen on this Unix socket, for clients on this host
+static int hint_budget_ms = 10; // -H: milliseconds the solver may take for a hint, 0 disables hints
 
-  PlayerBoard player_boards[MAX_CLIENT];
+// Timer kinds, see expire_timers()
+#define TIMER_IDLE 0
+#define TIMER_DEADLINE 1
 
-  GamePhase current_game_phase = GAME_PHASE_PLACEMENT; // Players place ships initially
-  int current_player_turn = 0; // Player 0 starts placement/shooting
-  int players_ready_for_shooting = 0; // Count players who finished placement
+// io_uring requests carry their connection pointer with the kind in the
+// low bits, see handle_completion()
+#define URING_ACCEPT 0
+#define URING_INBOX 1
+#define URING_RECV 2
+#define URING_SEND 3
+#define URING_SENDMSG 4
+#define URING_CANCEL 5
+#define URING_ACCEPT_LOCAL 6
+#define URING_SHM 7
+#define URING_KIND_MASK 7ull
 
-  // Create socket
-  listen_sock = socket(AF_INET, SOCK_STREAM, 0);
-  if(listen_sock == 0){
+#define LOG(...) do { if(!quiet) printf(__VA_ARGS__); } while(0)
+
+typedef struct Session Session;
+typedef struct Server Server;
+
+// One connected socket. Incoming bytes are split into frames by reader.
+// Outgoing frames collect in out_buf while events are handled and go out
+// together once per loop iteration; whatever the kernel does not take
+// stays there until the socket becomes writable again.
+typedef struct Connection Connection;
+struct Connection {
+  Pool *pool; // Accepting shard's conn_pool; the struct goes back there
+  int fd;
+  Session *session;
+  int player_idx;
+  FrameReader reader;
+  unsigned char *out_buf;
+  size_t out_len;
+  size_t out_cap;
+  Pool *out_pool; // Shard pool out_buf came from, while out_cap is OUT_BUF_SIZE
+  int want_write;
+  int close_after_flush;
+  int closed;
+  Connection *next_closed;
+  // Matchmaking queue links, valid while queued is set
+  int queued;
+  Connection *queue_prev;
+  Connection *queue_next;
+  uint64_t queued_at_ns;
+  Connection *next_handoff; // Link in the receiving shard's inbox
+  // Resume request being carried to the shard that owns the game
+  uint32_t resume_session_id;
+  int resume_player;
+  uint64_t resume_mac;
+  // Board asked for with MSG_TYPE_CONFIG_REQ; players who never ask only
+  // ever get the classic game
+  int custom_config;
+  GameConfig config;
+  // Spectators: the game watched, links in its spectator list and the
+  // shared frames not yet written
+  Session *watching;
+  Connection *spectator_prev;
+  Connection *spectator_next;
+  FrameQueue *frames;
+  uint32_t watch_session_id; // Carried to the shard that owns the game
+  // Idle reaping. Re-armed lazily: reads only bump last_heard_ms and the
+  // timer checks it when it fires
+  Timer idle_timer;
+  uint64_t last_heard_ms;
+  // io_uring only. A send in flight owns send_buf (swapped with out_buf, so
+  // replies keep queueing meanwhile) or, for spectator frames, send_msg.
+  // The struct outlives close_connection() until uring_ops drops to zero
+  int uring_ops; // Requests in flight
+  int recv_armed;
+  int sending;
+  unsigned char *send_buf;
+  size_t send_len;
+  size_t send_off;
+  size_t send_cap;
+  Pool *send_pool;
+  struct iovec *send_iov;
+  struct msghdr send_msg;
+  int dirty; // Has output to write at the end of the loop iteration
+  Connection *next_dirty;
+  Server *handoff_target; // Published to this shard once the ring lets go
+  // Clients on this host may move their frames to shared-memory rings
+  int local; // Came in over the Unix socket
+  int shm_requested; // Switch once the socket's output is flushed
+  ShmEndpoint shm; // channel is NULL until the switch
+  int shm_armed; // io_uring: wake_fd is polled
+};
+
+// State of a single game. Everything that used to live on main()'s stack.
+struct Session {
+  int id;
+  Connection *players[MAX_CLIENT];
+  GameConfig config;
+  GameBoard player_boards[MAX_CLIENT];
+  GamePhase current_game_phase;
+  int current_player_turn;
+  int players_ready_for_shooting;
+  int ai_slot; // Player index driven by the computer, -1 for a two-human game
+  AiPlayer ai;
+  Connection *spectators;
+  Timer deadline; // Runs while the game waits on a human's placement or shot
+  int hinted; // The player on turn already asked for this turn's hint
+  uint32_t turns; // Turns passed; hints answered after the turn moved on are dropped
+  AiPlayer seen[MAX_CLIENT]; // Classic boards: each player's view of the other fleet, as told by SHOT_RES/SALVO_RES
+  Arena arena; // Custom boards' cell tables; dropped in one go when the game ends
+  Session *prev; // Server's list of live games, walked by snapshots
+  Session *next;
+  Session *id_next; // Chain in the server's index by id
+};
+
+// FIFO of connected players without an opponent yet. Doubly linked so a
+// player who leaves or asks for the computer is unlinked in O(1).
+typedef struct {
+  Connection *head;
+  Connection *tail;
+  int depth;
+  // Counters for the current reporting interval
+  int peak_depth;
+  uint64_t matched;
+  uint64_t wait_total_ns;
+  uint64_t wait_max_ns;
+  uint64_t handed_off;
+} Lobby;
+
+// One event loop. With -t every thread owns a Server: its own listener,
+// epoll set, lobby and games, so nothing on the turn path is shared. The
+// only cross-thread traffic is inbox, where other shards hand over waiting
+// players that found no opponent locally.
+struct Server {
+  int shard_idx;
+  int epoll_fd;
+  int listen_sock;
+  int unix_sock; // -u listener, shard 0 only; -1 elsewhere
+  int event_fd; // Signalled after a push to inbox
+  _Atomic(Connection *) inbox; // Lock-free stack of handed-over connections
+  Lobby lobby;
+  JournalWriter *journal; // NULL unless -j was given
+  Connection *closed_list; // Freed once the current batch of events is done
+  Session *sessions;
+  Session **by_id; // Live games hashed by id, for resumes, spectators and hint answers
+  uint32_t by_id_mask; // Buckets - 1
+  int next_session_id;
+  int active_sessions;
+  int spectators;
+  pid_t snapshot_pid; // Child writing a snapshot, 0 if none
+  Metrics metrics; // Written only by this shard's thread
+  int shot_resolved; // The message being dispatched fired a shot; times turn_ns
+  TimerWheel timers; // Deadlines of this shard's games and connections
+  Uring *uring; // -U: the shard's ring, NULL when it runs on epoll
+  Connection *dirty_list; // Connections with output to write this iteration
+  Connection *moved; // Handed off while its frames were being dispatched
+  // Where sessions, connections, spectator frames and arena chunks come
+  // from; see pool.h
+  Pool session_pool;
+  Pool conn_pool;
+  Pool frame_pool;
+  Pool chunk_pool;
+  Pool buf_pool;
+  HintWorker *hints; // Runs the solver off the loop; started for the first hint
+  pthread_t thread;
+};
+
+static Server *shards;
+
+static const char *ship_name(ShipType type){
+  return (type == CARRIER) ? "Carrier" : (type == BATTLESHIP) ? "Battleship" : (type == CRUISER) ? "Cruiser" : (type == SUBMARINE) ? "Submarine" : "Destroyer";
+}
+
+// Custom fleets have no ship names, only indices.
+static const char *ship_label(const Session *session, int ship_idx){
+  return session->player_boards[0].sparse ? "ship" : ship_name((ShipType)ship_idx);
+}
+
+// Feed a shot result to a player's view of the other fleet. A repeat shot
+// reports a miss even on a hit cell, so cells already known are left alone.
+static void observe_shot(AiPlayer *view, int row, int col, int is_hit, ShipType sunk_type){
+  if((view->open_hits | view->sunk_cells | view->misses) & cell_bit(row, col))
+    return;
+  ai_observe(view, row, col, is_hit, sunk_type);
+}
+
+static uint64_t now_ns(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t now_ms(void){
+  return now_ns() / 1000000ull;
+}
+
+static void lobby_push(Lobby *lobby, Connection *conn, uint64_t queued_at_ns){
+  conn->queued = 1;
+  conn->queued_at_ns = queued_at_ns;
+  conn->queue_next = NULL;
+  conn->queue_prev = lobby->tail;
+  if(lobby->tail != NULL)
+    lobby->tail->queue_next = conn;
+  else
+    lobby->head = conn;
+  lobby->tail = conn;
+  lobby->depth++;
+  if(lobby->depth > lobby->peak_depth)
+    lobby->peak_depth = lobby->depth;
+}
+
+static void lobby_remove(Lobby *lobby, Connection *conn){
+  if(!conn->queued)
+    return;
+  if(conn->queue_prev != NULL)
+    conn->queue_prev->queue_next = conn->queue_next;
+  else
+    lobby->head = conn->queue_next;
+  if(conn->queue_next != NULL)
+    conn->queue_next->queue_prev = conn->queue_prev;
+  else
+    lobby->tail = conn->queue_prev;
+  conn->queued = 0;
+  conn->queue_prev = conn->queue_next = NULL;
+  lobby->depth--;
+}
+
+// Take the longest-waiting player off the queue and account for their wait.
+static Connection *lobby_pop(Lobby *lobby, uint64_t now){
+  Connection *conn = lobby->head;
+  lobby_remove(lobby, conn);
+  uint64_t waited = now - conn->queued_at_ns;
+  lobby->wait_total_ns += waited;
+  if(waited > lobby->wait_max_ns)
+    lobby->wait_max_ns = waited;
+  return conn;
+}
+
+// Append one event to the shard's journal, if journaling is enabled.
+static void journal_event(Server *server, const Session *session, int type, int player, int row, int col, ShipType ship_type, int orientation, int flags){
+  if(server->journal == NULL)
+    return;
+  JournalRecord rec = {
+    .session_id = (uint32_t)session->id,
+    .type = (uint8_t)type,
+    .player = (uint8_t)player,
+    .row = (uint16_t)row,
+    .col = (uint16_t)col,
+    .ship_type = (int8_t)ship_type,
+    .orientation = (uint8_t)orientation,
+    .flags = (uint8_t)flags
+  };
+  journal_writer_append(server->journal, &rec);
+}
+
+static int has_pending_output(const Connection *conn){
+  return conn->out_len > 0 || conn->sending || (conn->frames != NULL && conn->frames->count > 0);
+}
+
+static void update_events(Server *server, Connection *conn){
+  if(server->uring != NULL || conn->shm.channel != NULL)
+    return; // Sends are submitted or go to the ring, never waited for
+  metric_add(&server->metrics.io_syscalls, 1);
+  struct epoll_event ev;
+  ev.events = EPOLLIN | (has_pending_output(conn) ? EPOLLOUT : 0);
+  ev.data.ptr = conn;
+  epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, conn->fd, &ev);
+  conn->want_write = has_pending_output(conn);
+}
+
+static uint64_t uring_tag(const Connection *conn, int kind){
+  return (uint64_t)(uintptr_t)conn | (uint64_t)kind;
+}
+
+static struct io_uring_sqe *get_sqe(Server *server){
+  struct io_uring_sqe *sqe = uring_get_sqe(server->uring);
+  if(sqe == NULL)
+    perror("io_uring_enter failed");
+  return sqe;
+}
+
+static void cancel_request(Server *server, uint64_t user_data){
+  struct io_uring_sqe *sqe = get_sqe(server);
+  if(sqe == NULL)
+    return;
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->addr = user_data;
+  sqe->user_data = uring_tag(NULL, URING_CANCEL);
+}
+
+// Closing only releases the socket; the struct itself stays alive until the
+// end of the event batch since later events in the same batch may point at it.
+static void close_connection(Server *server, Connection *conn){
+  if(conn->closed)
+    return;
+  if(conn->shm.channel != NULL){
+    // The ring itself stays mapped until the struct is freed
+    if(server->uring != NULL){
+      if(conn->shm_armed)
+        cancel_request(server, uring_tag(conn, URING_SHM));
+    }
+    else{
+      metric_add(&server->metrics.io_syscalls, 1);
+      epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, conn->shm.wake_fd, NULL);
+    }
+    close(conn->shm.wake_fd);
+    close(conn->shm.peer_wake_fd);
+    conn->shm.wake_fd = conn->shm.peer_wake_fd = -1;
+  }
+  if(server->uring != NULL){
+    shutdown(conn->fd, SHUT_RDWR); // Completes whatever the ring has in flight on it
+  }
+  else{
+    metric_add(&server->metrics.io_syscalls, 1);
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+  }
+  close(conn->fd);
+  lobby_remove(&server->lobby, conn);
+  timer_cancel(&server->timers, &conn->idle_timer);
+  metric_add(&server->metrics.connections_closed, 1);
+  conn->closed = 1;
+  conn->next_closed = server->closed_list;
+  server->closed_list = conn;
+}
+
+// Reap the connection if it stays silent for idle_timeout; see handle_idle_timer().
+static void arm_idle_timer(Server *server, Connection *conn){
+  if(idle_timeout <= 0)
+    return;
+  conn->idle_timer.kind = TIMER_IDLE;
+  timer_arm(&server->timers, &conn->idle_timer, conn->last_heard_ms + (uint64_t)idle_timeout * 1000ull);
+}
+
+// Back to the pool obj came from: straight onto local's free list, or
+// through its remote list when another shard owns it.
+static void give_back(Pool *local, Pool *home, void *obj){
+  if(home == local)
+    pool_free(local, obj);
+  else
+    pool_free_remote(home, obj);
+}
+
+static void free_out_buf(Server *server, unsigned char *buf, size_t cap, Pool *pool){
+  if(cap == OUT_BUF_SIZE)
+    give_back(&server->buf_pool, pool, buf);
+  else
+    free(buf);
+}
+
+// The struct and its pooled buffers go back to the shards they came from,
+// wherever the connection was last served.
+static void free_connection(Server *server, Connection *conn){
+  if(conn->frames != NULL)
+    frame_queue_clear(conn->frames);
+  free(conn->frames);
+  free_out_buf(server, conn->out_buf, conn->out_cap, conn->out_pool);
+  free_out_buf(server, conn->send_buf, conn->send_cap, conn->send_pool);
+  free(conn->send_iov);
+  if(conn->shm.channel != NULL)
+    shm_close(&conn->shm);
+  give_back(&server->conn_pool, conn->pool, conn);
+}
+
+// Connections the ring still has requests on stay listed until those complete.
+static void release_closed_connections(Server *server){
+  Connection *busy = NULL;
+  while(server->closed_list != NULL){
+    Connection *conn = server->closed_list;
+    server->closed_list = conn->next_closed;
+    if(conn->uring_ops > 0 || conn->dirty){
+      conn->next_closed = busy;
+      busy = conn;
+      continue;
+    }
+    free_connection(server, conn);
+  }
+  server->closed_list = busy;
+}
+
+// One multishot receive per connection, filled from the shard's provided
+// buffers; it keeps posting completions until the socket ends or the
+// kernel runs out of buffers.
+static int arm_recv(Server *server, Connection *conn){
+  struct io_uring_sqe *sqe = get_sqe(server);
+  if(sqe == NULL)
+    return -1;
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = conn->fd;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = URING_BUF_GROUP;
+  sqe->user_data = uring_tag(conn, URING_RECV);
+  conn->recv_armed = 1;
+  conn->uring_ops++;
+  return 0;
+}
+
+// kind is URING_ACCEPT for the TCP listener, URING_ACCEPT_LOCAL for the Unix one.
+static void arm_accept(Server *server, int kind){
+  struct io_uring_sqe *sqe = get_sqe(server);
+  if(sqe == NULL)
+    return;
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = (kind == URING_ACCEPT_LOCAL) ? server->unix_sock : server->listen_sock;
+  sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+  sqe->accept_flags = SOCK_NONBLOCK;
+  sqe->user_data = uring_tag(NULL, kind);
+}
+
+static int arm_shm_poll(Server *server, Connection *conn){
+  struct io_uring_sqe *sqe = get_sqe(server);
+  if(sqe == NULL)
+    return -1;
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = conn->shm.wake_fd;
+  sqe->len = IORING_POLL_ADD_MULTI;
+  sqe->poll32_events = EPOLLIN;
+  sqe->user_data = uring_tag(conn, URING_SHM);
+  conn->shm_armed = 1;
+  conn->uring_ops++;
+  return 0;
+}
+
+static void arm_inbox_poll(Server *server){
+  struct io_uring_sqe *sqe = get_sqe(server);
+  if(sqe == NULL)
+    return;
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = server->event_fd;
+  sqe->len = IORING_POLL_ADD_MULTI;
+  sqe->poll32_events = EPOLLIN;
+  sqe->user_data = uring_tag(NULL, URING_INBOX);
+}
+
+// Output goes out once per loop iteration: everything queued for the
+// connection in one write, see flush_dirty().
+static void mark_dirty(Server *server, Connection *conn){
+  if(conn->dirty)
+    return;
+  conn->dirty = 1;
+  conn->next_dirty = server->dirty_list;
+  server->dirty_list = conn;
+}
+
+static int submit_send(Server *server, Connection *conn){
+  struct io_uring_sqe *sqe = get_sqe(server);
+  if(sqe == NULL)
+    return -1;
+  sqe->opcode = IORING_OP_SEND;
+  sqe->fd = conn->fd;
+  sqe->addr = (uint64_t)(uintptr_t)(conn->send_buf + conn->send_off);
+  sqe->len = (unsigned)(conn->send_len - conn->send_off);
+  sqe->msg_flags = MSG_NOSIGNAL;
+  sqe->user_data = uring_tag(conn, URING_SEND);
+  conn->sending = 1;
+  conn->uring_ops++;
+  return 0;
+}
+
+// Start the connection's next send, if nothing is in flight yet: out_buf
+// first, then spectator frames straight from the shared buffers.
+static void start_send(Server *server, Connection *conn){
+  if(conn->sending || conn->closed || conn->handoff_target != NULL)
+    return;
+  if(conn->out_len > 0){
+    unsigned char *buf = conn->send_buf;
+    size_t cap = conn->send_cap;
+    Pool *pool = conn->send_pool;
+    conn->send_buf = conn->out_buf;
+    conn->send_cap = conn->out_cap;
+    conn->send_pool = conn->out_pool;
+    conn->send_len = conn->out_len;
+    conn->send_off = 0;
+    conn->out_buf = buf;
+    conn->out_cap = cap;
+    conn->out_pool = pool;
+    conn->out_len = 0;
+    if(submit_send(server, conn) < 0)
+      close_connection(server, conn);
+    return;
+  }
+  if(conn->frames == NULL || conn->frames->count == 0)
+    return;
+  if(conn->send_iov == NULL && (conn->send_iov = malloc(FRAME_QUEUE_CAP * sizeof(*conn->send_iov))) == NULL){
+    perror("malloc failed");
+    close_connection(server, conn);
+    return;
+  }
+  struct io_uring_sqe *sqe = get_sqe(server);
+  if(sqe == NULL){
+    close_connection(server, conn);
+    return;
+  }
+  memset(&conn->send_msg, 0, sizeof(conn->send_msg));
+  conn->send_msg.msg_iov = conn->send_iov;
+  conn->send_msg.msg_iovlen = (size_t)frame_queue_iov(conn->frames, conn->send_iov, FRAME_QUEUE_CAP);
+  sqe->opcode = IORING_OP_SENDMSG;
+  sqe->fd = conn->fd;
+  sqe->addr = (uint64_t)(uintptr_t)&conn->send_msg;
+  sqe->len = 1;
+  sqe->msg_flags = MSG_NOSIGNAL;
+  sqe->user_data = uring_tag(conn, URING_SENDMSG);
+  conn->sending = 1;
+  conn->uring_ops++;
+}
+
+// Connections on shared memory write straight into the ring. Whatever does
+// not fit waits until the client makes room and wakes us.
+static void flush_shm(Server *server, Connection *conn){
+  uint64_t wakes = conn->shm.wakes;
+  size_t sent = shm_write(&conn->shm, conn->out_buf, conn->out_len);
+  memmove(conn->out_buf, conn->out_buf + sent, conn->out_len - sent);
+  conn->out_len -= sent;
+  while(conn->out_len == 0 && conn->frames != NULL && conn->frames->count > 0){
+    struct iovec iov;
+    frame_queue_iov(conn->frames, &iov, 1);
+    size_t n = shm_write(&conn->shm, iov.iov_base, iov.iov_len);
+    frame_queue_consume(conn->frames, n);
+    if(n < iov.iov_len)
+      break;
+  }
+  metric_add(&server->metrics.io_syscalls, conn->shm.wakes - wakes);
+}
+
+// Push out_buf and then the spectator frames, as much as the socket
+// accepts, in one gathered write each round. Returns -1 on a hard error.
+static int write_socket(Server *server, Connection *conn){
+  struct iovec iov[1 + FRAME_QUEUE_CAP];
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  while(has_pending_output(conn)){
+    int iovcnt = 0;
+    if(conn->out_len > 0)
+      iov[iovcnt++] = (struct iovec){conn->out_buf, conn->out_len};
+    if(conn->frames != NULL)
+      iovcnt += frame_queue_iov(conn->frames, iov + iovcnt, FRAME_QUEUE_CAP);
+    msg.msg_iovlen = (size_t)iovcnt;
+    // sendmsg() rather than writev(): a peer that went away must not raise SIGPIPE
+    ssize_t n = sendmsg(conn->fd, &msg, MSG_NOSIGNAL);
+    metric_add(&server->metrics.io_syscalls, 1);
+    if(n < 0){
+      if(errno == EINTR)
+        continue;
+      if(errno == EAGAIN || errno == EWOULDBLOCK)
+        return 0;
+      return -1;
+    }
+    size_t sent = (size_t)n;
+    size_t from_buf = sent < conn->out_len ? sent : conn->out_len;
+    memmove(conn->out_buf, conn->out_buf + from_buf, conn->out_len - from_buf);
+    conn->out_len -= from_buf;
+    if(sent > from_buf)
+      frame_queue_consume(conn->frames, sent - from_buf);
+  }
+  return 0;
+}
+
+// Schedule the connection's output for the end of the loop iteration, so
+// every message produced meanwhile leaves in the same write. Connections
+// on shared memory write straight into the ring instead.
+static void flush_connection(Server *server, Connection *conn){
+  if(conn->shm.channel != NULL)
+    flush_shm(server, conn);
+  else
+    mark_dirty(server, conn);
+}
+
+// Room for one more frame in out_buf. The first OUT_BUF_SIZE bytes come
+// from the shard's pool; only a connection that falls further behind moves
+// onto the heap.
+static int reserve_out_buf(Server *server, Connection *conn){
+  if(conn->out_len + PROTO_MAX_FRAME <= conn->out_cap)
+    return 0;
+  if(conn->out_cap == 0){
+    if((conn->out_buf = pool_alloc(&server->buf_pool)) == NULL){
+      fprintf(stderr, "Shard %d: buffer pool exhausted\n", server->shard_idx);
+      return -1;
+    }
+    conn->out_cap = OUT_BUF_SIZE;
+    conn->out_pool = &server->buf_pool;
+    return 0;
+  }
+  size_t new_cap = conn->out_cap * 2;
+  while(new_cap < conn->out_len + PROTO_MAX_FRAME)
+    new_cap *= 2;
+  int pooled = (conn->out_cap == OUT_BUF_SIZE);
+  unsigned char *grown = pooled ? malloc(new_cap) : realloc(conn->out_buf, new_cap);
+  if(grown == NULL){
+    perror("realloc failed");
+    return -1;
+  }
+  if(pooled){
+    memcpy(grown, conn->out_buf, conn->out_len);
+    give_back(&server->buf_pool, conn->out_pool, conn->out_buf);
+    conn->out_pool = NULL;
+  }
+  conn->out_buf = grown;
+  conn->out_cap = new_cap;
+  return 0;
+}
+
+// Queue a message for the connection. Never blocks: whatever cannot be written
+// now is sent from the event loop when the socket reports EPOLLOUT.
+static void send_message(Server *server, Connection *conn, const GameMessage *msg){
+  if(conn == NULL || conn->closed)
+    return;
+  metric_count_message(server->metrics.messages_out, msg->type);
+  if(reserve_out_buf(server, conn) < 0)
+    return;
+  conn->out_len += encode_message(msg, conn->out_buf + conn->out_len, conn->out_cap - conn->out_len);
+  flush_connection(server, conn);
+}
+
+static void detach_spectator(Server *server, Connection *conn){
+  Session *session = conn->watching;
+  if(session == NULL)
+    return;
+  if(conn->spectator_prev != NULL)
+    conn->spectator_prev->spectator_next = conn->spectator_next;
+  else
+    session->spectators = conn->spectator_next;
+  if(conn->spectator_next != NULL)
+    conn->spectator_next->spectator_prev = conn->spectator_prev;
+  conn->spectator_prev = conn->spectator_next = NULL;
+  conn->watching = NULL;
+  server->spectators--;
+}
+
+// Fan one event out to everyone watching the game: encoded once, queued by
+// reference. A spectator whose queue is full is dropped on the spot rather
+// than slowing the game down.
+static void send_to_spectators(Server *server, Session *session, const GameMessage *msg){
+  if(session->spectators == NULL)
+    return;
+  SharedFrame *frame = shared_frame_encode(&server->frame_pool, msg);
+  if(frame == NULL)
+    return;
+  Connection *next;
+  for(Connection *conn = session->spectators; conn != NULL; conn = next){
+    next = conn->spectator_next;
+    if(frame_queue_push(conn->frames, frame) < 0){
+      LOG("Game %d: dropping a spectator %d frames behind.\n", session->id, FRAME_QUEUE_CAP);
+      metric_add(&server->metrics.spectators_dropped, 1);
+      detach_spectator(server, conn);
+      close_connection(server, conn);
+      continue;
+    }
+    metric_count_message(server->metrics.messages_out, msg->type);
+    flush_connection(server, conn);
+  }
+  shared_frame_release(frame);
+}
+
+static uint32_t session_bucket(const Server *server, int id){
+  return (uint32_t)(((uint64_t)(uint32_t)id * 0x9E3779B97F4A7C15ull) >> 32) & server->by_id_mask;
+}
+
+// Double the index, or create it, and rehash every live game from the
+// server's list. Returns -1, keeping the old index, if memory is short.
+static int session_index_grow(Server *server){
+  uint32_t buckets = server->by_id != NULL ? (server->by_id_mask + 1) * 2 : SESSION_BUCKETS;
+  Session **by_id = calloc(buckets, sizeof(*by_id));
+  if(by_id == NULL)
+    return -1;
+  free(server->by_id);
+  server->by_id = by_id;
+  server->by_id_mask = buckets - 1;
+  for(Session *session = server->sessions; session != NULL; session = session->next){
+    uint32_t b = session_bucket(server, session->id);
+    session->id_next = by_id[b];
+    by_id[b] = session;
+  }
+  return 0;
+}
+
+static void session_index_remove(Server *server, Session *session){
+  Session **link = &server->by_id[session_bucket(server, session->id)];
+  while(*link != session)
+    link = &(*link)->id_next;
+  *link = session->id_next;
+}
+
+static Session *find_session(const Server *server, int id){
+  Session *session = server->by_id[session_bucket(server, id)];
+  while(session != NULL && session->id != id)
+    session = session->id_next;
+  return session;
+}
+
+// Final word to the spectators. winner is -1 when nobody won.
+static void send_game_over_to_spectators(Server *server, Session *session, int winner, const char *text){
+  GameMessage msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.type = MSG_TYPE_GAME_OVER;
+  msg.success = winner >= 0;
+  msg.row = winner >= 0 ? winner : 0;
+  snprintf(msg.message, sizeof(msg.message), "%s", text);
+  send_to_spectators(server, session, &msg);
+}
+
+static void end_session(Server *server, Session *session){
+  timer_cancel(&server->timers, &session->deadline);
+  for(int i = 0; i < MAX_CLIENT; i++){
+    Connection *conn = session->players[i];
+    if(conn == NULL)
+      continue;
+    conn->session = NULL;
+    if(has_pending_output(conn))
+      conn->close_after_flush = 1;
+    else
+      close_connection(server, conn);
+  }
+  while(session->spectators != NULL){
+    Connection *conn = session->spectators;
+    detach_spectator(server, conn);
+    if(has_pending_output(conn))
+      conn->close_after_flush = 1;
+    else
+      close_connection(server, conn);
+  }
+  if(session->prev != NULL)
+    session->prev->next = session->next;
+  else
+    server->sessions = session->next;
+  if(session->next != NULL)
+    session->next->prev = session->prev;
+  session_index_remove(server, session);
+  for(int i = 0; i < MAX_CLIENT; i++)
+    game_board_free(&session->player_boards[i]); // Only boards restored from a snapshot own their tables
+  arena_reset(&session->arena);
+  server->active_sessions--;
+  metric_add(&server->metrics.games_finished, 1);
+  LOG("Game %d closed. Active games: %d\n", session->id, server->active_sessions);
+  pool_free(&server->session_pool, session);
+}
+
+static void *session_alloc(void *ctx, size_t size){
+  return arena_alloc(ctx, size);
+}
+
+// Custom boards grow their cell tables as shots land; keep those in the
+// game's arena rather than on the heap.
+static void use_session_arena(Session *session, GameBoard *board){
+  game_board_set_alloc(board, session_alloc, &session->arena);
+}
+
+// Allocate a game in placement phase and link it into the server's list.
+static Session *new_session(Server *server, int id, const GameConfig *config){
+  Session *session = pool_alloc(&server->session_pool);
+  if(session == NULL)
+    return NULL;
+  session->id = id;
+  session->config = *config;
+  session->current_game_phase = GAME_PHASE_PLACEMENT; // Players place ships initially
+  session->current_player_turn = 0; // Player 0 starts placement/shooting
+  session->players_ready_for_shooting = 0; // Count players who finished placement
+  session->ai_slot = -1;
+  for(int i = 0; i < MAX_CLIENT; i++)
+    ai_init(&session->seen[i], 1);
+  arena_init(&session->arena, &server->chunk_pool);
+  for(int i = 0; i < MAX_CLIENT; i++){
+    game_board_init(&session->player_boards[i], config);
+    use_session_arena(session, &session->player_boards[i]);
+  }
+  session->next = server->sessions;
+  if(server->sessions != NULL)
+    server->sessions->prev = session;
+  server->sessions = session;
+  server->active_sessions++;
+  // Keep chains short: grow once there are more games than buckets
+  if(server->active_sessions > (int)server->by_id_mask + 1 && session_index_grow(server) == 0)
+    return session;
+  uint32_t b = session_bucket(server, id);
+  session->id_next = server->by_id[b];
+  server->by_id[b] = session;
+  return session;
+}
+
+static uint64_t resume_mac(int session_id, int player){
+  uint64_t x = resume_secret ^ ((uint64_t)(uint32_t)session_id << 8) ^ (uint64_t)player;
+  // splitmix64 finaliser
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+// Start the clock on the player the game waits for. Resent prompts and
+// rejected moves leave a running clock alone; only a move that counts
+// cancels it, so a client cannot stall a game by answering badly.
+static void arm_deadline(Server *server, Session *session){
+  int seconds = (session->current_game_phase == GAME_PHASE_PLACEMENT) ? placement_timeout : turn_timeout;
+  if(seconds <= 0 || session->current_player_turn == session->ai_slot || timer_armed(&session->deadline))
+    return;
+  session->deadline.kind = TIMER_DEADLINE;
+  timer_arm(&server->timers, &session->deadline, now_ms() + (uint64_t)seconds * 1000ull);
+}
+
+static void send_placement_prompt(Server *server, Session *session){
+  if(session->current_player_turn == session->ai_slot)
+    return; // The computer's fleet is placed when the game starts
+  const GameBoard *current_player_board = &session->player_boards[session->current_player_turn];
+
+  // Find the first ship to be placed
+  int ship_to_place = game_board_next_unplaced(current_player_board);
+  if(ship_to_place < 0)
+    return;
+
+  GameMessage placement_prompt_msg;
+  memset(&placement_prompt_msg, 0, sizeof(placement_prompt_msg));
+  placement_prompt_msg.type = MSG_TYPE_PLACE_SHIP_PROMPT;
+  placement_prompt_msg.ship_type = (ShipType)ship_to_place;
+  send_message(server, session->players[session->current_player_turn], &placement_prompt_msg);
+  arm_deadline(server, session);
+  LOG("Game %d: sent placement prompt for %s (size %d) (Player %d).\n", session->id, ship_label(session, ship_to_place), game_board_ship(current_player_board, ship_to_place)->size, session->current_player_turn + 1);
+}
+
+static void resolve_shot(Server *server, Session *session, int row, int col);
+
+// The computer moves as soon as its turn comes up; the resulting shot goes
+// through the same path as a human's so both players see the usual results.
+static void play_ai_turn(Server *server, Session *session){
+  int row, col;
+  ai_choose_shot(&session->ai, &row, &col);
+  LOG("Game %d: computer fires at (%d,%d)\n", session->id, row, col);
+  resolve_shot(server, session, row, col);
+}
+
+// Hand the shot to the other player; a hint asked for before now is stale.
+static void pass_turn(Session *session){
+  session->current_player_turn = 1 - session->current_player_turn;
+  session->turns++;
+  session->hinted = 0;
+}
+
+static void send_turn_indication(Server *server, Session *session){
+  if(session->current_player_turn == session->ai_slot){
+    play_ai_turn(server, session);
+    return;
+  }
+  GameMessage turn_msg;
+  memset(&turn_msg, 0, sizeof(turn_msg));
+  turn_msg.type = MSG_TYPE_TURN_IND;
+  if(session->config.salvo)
+    turn_msg.row = game_board_ships_afloat(&session->player_boards[session->current_player_turn]);
+  send_message(server, session->players[session->current_player_turn], &turn_msg);
+  arm_deadline(server, session);
+  LOG("Game %d: sent turn message to Player %d\n", session->id, session->current_player_turn + 1);
+}
+
+// Prompted placement serves the first player whose fleet is not down yet;
+// a whole-fleet submission may land for either player at any time. Once
+// both fleets are down the game moves on to shooting, player 0 first.
+static void sync_placement_progress(Session *session){
+  int ready = 0, first_unfinished = -1;
+  for(int p = 0; p < MAX_CLIENT; p++){
+    if(game_board_next_unplaced(&session->player_boards[p]) < 0)
+      ready++;
+    else if(first_unfinished < 0)
+      first_unfinished = p;
+  }
+  session->players_ready_for_shooting = ready;
+  if(ready == MAX_CLIENT){
+    session->current_game_phase = GAME_PHASE_SHOOTING;
+    session->current_player_turn = 0;
+  }
+  else{
+    session->current_player_turn = first_unfinished;
+  }
+}
+
+// Drive placement forward after the current player's board changed: either
+// prompt for their next ship, hand placement to the other player, or start
+// the shooting phase once both fleets are down.
+static void advance_placement(Server *server, Session *session){
+  int placing = session->current_player_turn;
+  if(game_board_next_unplaced(&session->player_boards[placing]) >= 0){
+    send_placement_prompt(server, session);
+    return;
+  }
+
+  sync_placement_progress(session);
+  LOG("Game %d: Player %d finished placing ships. Total Ready : %d\n", session->id, placing + 1, session->players_ready_for_shooting);
+
+  if(session->current_game_phase == GAME_PHASE_SHOOTING){
+    LOG("Game %d: all players placed ships. Transitioning to shooting phase.\n", session->id);
+
+    GameMessage game_start_msg;
+    memset(&game_start_msg, 0, sizeof(game_start_msg));
+    game_start_msg.type = MSG_TYPE_TEST;
+    sprintf(game_start_msg.message, "All ships placed! Game starting!");
+    send_message(server, session->players[0], &game_start_msg);
+    send_message(server, session->players[1], &game_start_msg);
+    send_to_spectators(server, session, &game_start_msg);
+
+    send_turn_indication(server, session);
+  }
+  else{
+    LOG("Game %d: switching to Player %d for placement.\n", session->id, session->current_player_turn + 1);
+    send_placement_prompt(server, session);
+  }
+}
+
+static void handle_placement(Server *server, Session *session, const GameMessage *recieved_msg){
+  Connection *current_conn = session->players[session->current_player_turn];
+  GameBoard *current_player_board = &session->player_boards[session->current_player_turn];
+
+  if(recieved_msg->type != MSG_TYPE_PLACEMENT_REQ){
+    LOG("Game %d: Player %d sent unexpected message type %d during placement.\n", session->id, session->current_player_turn + 1, recieved_msg->type);
+    return;
+  }
+
+  GameMessage placement_response_msg;
+  memset(&placement_response_msg, 0, sizeof(placement_response_msg));
+  placement_response_msg.type = MSG_TYPE_PLACEMENT_RES;
+  placement_response_msg.row = recieved_msg->row;
+  placement_response_msg.col = recieved_msg->col;
+  placement_response_msg.ship_type = recieved_msg->ship_type;
+  placement_response_msg.orientation = recieved_msg->orientation;
+
+  // Validate and place the ship on the server's board
+  if(game_board_place(current_player_board, recieved_msg->ship_type, recieved_msg->row, recieved_msg->col, recieved_msg->orientation)){
+    placement_response_msg.success = 1; // Success
+    timer_cancel(&server->timers, &session->deadline);
+    journal_event(server, session, JOURNAL_PLACEMENT, session->current_player_turn, recieved_msg->row, recieved_msg->col, recieved_msg->ship_type, recieved_msg->orientation, 0);
+    LOG("Game %d: Player %d placed %s at (%d,%d) %s.\n", session->id, session->current_player_turn + 1, ship_label(session, recieved_msg->ship_type), recieved_msg->row, recieved_msg->col, (recieved_msg->orientation == HORIZONTAL) ? "Horizontal" : "Vertical");
+  }
+  else{
+    placement_response_msg.success = 0; // Failure
+    metric_add(&server->metrics.invalid_placements, 1);
+    LOG("Game %d: Player %d tried invalid placement for %s.\n", session->id, session->current_player_turn + 1, ship_label(session, recieved_msg->ship_type));
+  }
+  send_message(server, current_conn, &placement_response_msg);
+
+  // If placement failed, stay on the same player and prompt for the same ship again.
+  // If successful, move to the next unplaced ship for this player, or switch players/phase.
+  advance_placement(server, session);
+}
+
+// A whole fleet in one message. It is placed on a scratch board first so
+// either every ship goes down or none does, and it is accepted from either
+// player at any time during placement, so both fleets can arrive at once.
+static void handle_fleet(Server *server, Session *session, int player_idx, const GameMessage *recieved_msg){
+  GameBoard *board = &session->player_boards[player_idx];
+  GameMessage fleet_response_msg;
+  memset(&fleet_response_msg, 0, sizeof(fleet_response_msg));
+  fleet_response_msg.type = MSG_TYPE_FLEET_RES;
+  fleet_response_msg.ship_type = NO_SHIP;
+
+  int any_placed = 0;
+  for(int i = 0; i < game_board_num_ships(board); i++)
+    any_placed |= game_board_ship(board, i)->is_placed;
+  if(any_placed || recieved_msg->fleet_count != game_board_num_ships(board)){
+    snprintf(fleet_response_msg.message, sizeof(fleet_response_msg.message), "Fleet must list all %d ships before any is placed.", game_board_num_ships(board));
+    metric_add(&server->metrics.invalid_placements, 1);
+    LOG("Game %d: Player %d sent a fleet of %d ships, rejected.\n", session->id, player_idx + 1, recieved_msg->fleet_count);
+    send_message(server, session->players[player_idx], &fleet_response_msg);
+    if(player_idx == session->current_player_turn)
+      send_placement_prompt(server, session);
+    return;
+  }
+
+  GameBoard fleet;
+  game_board_init(&fleet, &session->config);
+  for(int i = 0; i < recieved_msg->fleet_count; i++){
+    const ShipPlacement *ship = &recieved_msg->fleet[i];
+    if(!game_board_place(&fleet, i, ship->row, ship->col, (Orientation)ship->orientation)){
+      game_board_free(&fleet);
+      fleet_response_msg.ship_type = (ShipType)i;
+      metric_add(&server->metrics.invalid_placements, 1);
+      LOG("Game %d: Player %d sent a fleet where %s does not fit.\n", session->id, player_idx + 1, ship_label(session, i));
+      send_message(server, session->players[player_idx], &fleet_response_msg);
+      if(player_idx == session->current_player_turn)
+        send_placement_prompt(server, session);
+      return;
+    }
+  }
+  game_board_free(board);
+  *board = fleet; // Checked on the heap: rejected fleets must not pile up in the arena
+  use_session_arena(session, board);
+  for(int i = 0; i < recieved_msg->fleet_count; i++){
+    const Ship *ship = game_board_ship(board, i);
+    journal_event(server, session, JOURNAL_PLACEMENT, player_idx, ship->row, ship->col, (ShipType)i, ship->orientation, 0);
+  }
+  fleet_response_msg.success = 1;
+  send_message(server, session->players[player_idx], &fleet_response_msg);
+  LOG("Game %d: Player %d placed their whole fleet.\n", session->id, player_idx + 1);
+
+  if(player_idx == session->current_player_turn){
+    timer_cancel(&server->timers, &session->deadline);
+    advance_placement(server, session);
+    return;
+  }
+  sync_placement_progress(session); // The player being prompted is still placing
+  LOG("Game %d: Player %d finished placing ships. Total Ready : %d\n", session->id, player_idx + 1, session->players_ready_for_shooting);
+}
+
+static void resolve_salvo(Server *server, Session *session, const GameMessage *recieved_msg);
+
+static void handle_shot(Server *server, Session *session, const GameMessage *recieved_msg){
+  int current_player_turn = session->current_player_turn;
+
+  LOG("Game %d: Player %d sent message (Type: %d, Row: %d, Col: %d)\n", session->id, current_player_turn + 1, recieved_msg->type, recieved_msg->row, recieved_msg->col);
+  if(session->config.salvo && recieved_msg->type == MSG_TYPE_SALVO_REQ){
+    resolve_salvo(server, session, recieved_msg);
+    return;
+  }
+  if(session->config.salvo || recieved_msg->type != MSG_TYPE_SHOT_REQ){
+    LOG("Game %d: Player %d sent unexpected message type %d during shooting phase.\n", session->id, current_player_turn + 1, recieved_msg->type);
+    return;
+  }
+  resolve_shot(server, session, recieved_msg->row, recieved_msg->col);
+}
+
+// Apply the current player's shot, report it to both sides and either end
+// the game or pass the turn.
+static void resolve_shot(Server *server, Session *session, int row, int col){
+  int current_player_turn = session->current_player_turn;
+  Connection *current_conn = session->players[current_player_turn];
+  int target_player_idx = (current_player_turn == 0) ? 1 : 0; // Other player
+  Connection *opponent_conn = session->players[target_player_idx];
+  int is_hit_flag, is_sunk_flag, sunk_ship;
+  timer_cancel(&server->timers, &session->deadline);
+  server->shot_resolved = 1;
+  uint64_t shot_start = now_ns();
+  game_board_shoot(&session->player_boards[target_player_idx], row, col, &is_hit_flag, &is_sunk_flag, &sunk_ship);
+  histogram_record(&server->metrics.take_shot_ns, now_ns() - shot_start);
+  ShipType sunk_ship_type = (ShipType)sunk_ship;
+  if(current_player_turn == session->ai_slot)
+    ai_observe(&session->ai, row, col, is_hit_flag, sunk_ship_type);
+  else if(!session->player_boards[target_player_idx].sparse)
+    observe_shot(&session->seen[current_player_turn], row, col, is_hit_flag, sunk_ship_type);
+  journal_event(server, session, JOURNAL_SHOT, current_player_turn, row, col, sunk_ship_type, 0,
+                (is_hit_flag ? JOURNAL_FLAG_HIT : 0) | (is_sunk_flag ? JOURNAL_FLAG_SUNK : 0));
+
+  GameMessage shot_result_msg_to_shooter;
+  memset(&shot_result_msg_to_shooter, 0, sizeof(shot_result_msg_to_shooter));
+  shot_result_msg_to_shooter.type = MSG_TYPE_SHOT_RES;
+  shot_result_msg_to_shooter.row = row;
+  shot_result_msg_to_shooter.col = col;
+  shot_result_msg_to_shooter.is_hit = is_hit_flag;
+  shot_result_msg_to_shooter.is_sunk = is_sunk_flag;
+  shot_result_msg_to_shooter.ship_type = sunk_ship_type;
+
+  GameMessage shot_result_msg_to_target = shot_result_msg_to_shooter; // To inform the target player
+  shot_result_msg_to_target.own_board = 1;
+
+  if (is_hit_flag) {
+    if (is_sunk_flag)
+      LOG("Game %d: Player %d hit and sunk the %s on Player %d's board at (%d,%d)\n", session->id, current_player_turn + 1, ship_label(session, sunk_ship), target_player_idx + 1, row, col);
+    else
+      LOG("Game %d: Player %d hit Player %d's board at (%d,%d)\n", session->id, current_player_turn + 1, target_player_idx + 1, row, col);
+  }
+  else{
+    LOG("Game %d: Player %d missed Player %d's board at (%d,%d)\n", session->id, current_player_turn + 1, target_player_idx + 1, row, col);
+  }
+  send_message(server, current_conn, &shot_result_msg_to_shooter);
+  send_message(server, opponent_conn, &shot_result_msg_to_target);
+  GameMessage shot_result_msg_to_spectators = shot_result_msg_to_shooter;
+  shot_result_msg_to_spectators.orientation = current_player_turn;
+  send_to_spectators(server, session, &shot_result_msg_to_spectators);
+
+  if(game_board_over(&session->player_boards[target_player_idx])){
+    GameMessage game_over_msg;
+    memset(&game_over_msg, 0, sizeof(game_over_msg));
+    game_over_msg.type = MSG_TYPE_GAME_OVER;
+    game_over_msg.success = 1;
+    send_message(server, current_conn, &game_over_msg); // Winner
+    game_over_msg.success = 0;
+    send_message(server, opponent_conn, &game_over_msg); // Loser
+    LOG("Game %d: Game Over! Player %d wins.\n", session->id, current_player_turn + 1);
+    char result[MAX_MSG_LEN];
+    snprintf(result, sizeof(result), "Player %d wins.", current_player_turn + 1);
+    send_game_over_to_spectators(server, session, current_player_turn, result);
+    journal_event(server, session, JOURNAL_GAME_END, current_player_turn, 0, 0, NO_SHIP, 0, 0);
+    session->current_game_phase = GAME_PHASE_GAMEOVER;
+    end_session(server, session);
+    return;
+  }
+
+  pass_turn(session);
+  send_turn_indication(server, session);
+}
+
+// Salvo games: fire every shot of the request in one pass over the target
+// board and report them all in a single message to each player.
+static void resolve_salvo(Server *server, Session *session, const GameMessage *recieved_msg){
+  int current_player_turn = session->current_player_turn;
+  Connection *current_conn = session->players[current_player_turn];
+  int target_player_idx = (current_player_turn == 0) ? 1 : 0; // Other player
+  Connection *opponent_conn = session->players[target_player_idx];
+  int allowed = game_board_ships_afloat(&session->player_boards[current_player_turn]);
+
+  GameMessage salvo_result_msg_to_shooter;
+  memset(&salvo_result_msg_to_shooter, 0, sizeof(salvo_result_msg_to_shooter));
+  salvo_result_msg_to_shooter.type = MSG_TYPE_SALVO_RES;
+  if(recieved_msg->shot_count < 1 || recieved_msg->shot_count > allowed){
+    snprintf(salvo_result_msg_to_shooter.message, sizeof(salvo_result_msg_to_shooter.message), "Salvo must be 1 to %d shots.", allowed);
+    send_message(server, current_conn, &salvo_result_msg_to_shooter);
+    LOG("Game %d: Player %d fired a salvo of %d shots, %d allowed.\n", session->id, current_player_turn + 1, recieved_msg->shot_count, allowed);
+    send_turn_indication(server, session);
+    return;
+  }
+
+  salvo_result_msg_to_shooter.success = 1;
+  salvo_result_msg_to_shooter.shot_count = recieved_msg->shot_count;
+  memcpy(salvo_result_msg_to_shooter.shots, recieved_msg->shots, (size_t)recieved_msg->shot_count * sizeof(Shot));
+  timer_cancel(&server->timers, &session->deadline);
+  server->shot_resolved = 1;
+  uint64_t shot_start = now_ns();
+  int hits = game_board_shoot_salvo(&session->player_boards[target_player_idx], salvo_result_msg_to_shooter.shots, salvo_result_msg_to_shooter.shot_count);
+  histogram_record(&server->metrics.take_shot_ns, now_ns() - shot_start);
+  for(int i = 0; i < salvo_result_msg_to_shooter.shot_count; i++){
+    const Shot *shot = &salvo_result_msg_to_shooter.shots[i];
+    if(!session->player_boards[target_player_idx].sparse){
+      ShipType sunk_type = shot->sunk_ship != NO_SHIP ? game_board_ship(&session->player_boards[target_player_idx], shot->sunk_ship)->type : NO_SHIP;
+      observe_shot(&session->seen[current_player_turn], shot->row, shot->col, shot->is_hit, sunk_type);
+    }
+    journal_event(server, session, JOURNAL_SHOT, current_player_turn, shot->row, shot->col, (ShipType)shot->sunk_ship, 0, // Fleet index, as resolve_shot journals it
+                  (shot->is_hit ? JOURNAL_FLAG_HIT : 0) | (shot->is_sunk ? JOURNAL_FLAG_SUNK : 0));
+    if(shot->is_sunk)
+      LOG("Game %d: Player %d sunk the %s on Player %d's board at (%d,%d)\n", session->id, current_player_turn + 1, ship_label(session, shot->sunk_ship), target_player_idx + 1, shot->row, shot->col);
+  }
+  LOG("Game %d: Player %d fired a salvo of %d at Player %d's board, %d hit.\n", session->id, current_player_turn + 1, salvo_result_msg_to_shooter.shot_count, target_player_idx + 1, hits);
+
+  GameMessage salvo_result_msg_to_target = salvo_result_msg_to_shooter; // To inform the target player
+  salvo_result_msg_to_target.own_board = 1;
+  send_message(server, current_conn, &salvo_result_msg_to_shooter);
+  send_message(server, opponent_conn, &salvo_result_msg_to_target);
+  GameMessage salvo_result_msg_to_spectators = salvo_result_msg_to_shooter;
+  salvo_result_msg_to_spectators.orientation = current_player_turn;
+  send_to_spectators(server, session, &salvo_result_msg_to_spectators);
+
+  if(game_board_over(&session->player_boards[target_player_idx])){
+    GameMessage game_over_msg;
+    memset(&game_over_msg, 0, sizeof(game_over_msg));
+    game_over_msg.type = MSG_TYPE_GAME_OVER;
+    game_over_msg.success = 1;
+    send_message(server, current_conn, &game_over_msg); // Winner
+    game_over_msg.success = 0;
+    send_message(server, opponent_conn, &game_over_msg); // Loser
+    LOG("Game %d: Game Over! Player %d wins.\n", session->id, current_player_turn + 1);
+    char result[MAX_MSG_LEN];
+    snprintf(result, sizeof(result), "Player %d wins.", current_player_turn + 1);
+    send_game_over_to_spectators(server, session, current_player_turn, result);
+    journal_event(server, session, JOURNAL_GAME_END, current_player_turn, 0, 0, NO_SHIP, 0, 0);
+    session->current_game_phase = GAME_PHASE_GAMEOVER;
+    end_session(server, session);
+    return;
+  }
+
+  pass_turn(session);
+  send_turn_indication(server, session);
+}
+
+static void send_config(Server *server, const Session *session, Connection *conn){
+  GameMessage msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.type = MSG_TYPE_CONFIG;
+  msg.success = 1;
+  msg.row = session->config.rows;
+  msg.col = session->config.cols;
+  game_config_format(&session->config, msg.message, sizeof(msg.message));
+  send_message(server, conn, &msg);
+}
+
+// Pair two players into a new game. A NULL second player means the
+// computer takes that slot.
+static void start_session(Server *server, Connection *first, Connection *second){
+  // Custom boards need both players to ask for one; the computer only
+  // plays the classic game
+  GameConfig config;
+  if(second != NULL && first->custom_config && second->custom_config)
+    game_config_negotiate(&first->config, &second->config, &config);
+  else
+    game_config_classic(&config);
+  Session *session = new_session(server, server->next_session_id++ * num_shards + server->shard_idx + 1, &config); // Unique across shards
+  if(session == NULL){
+    fprintf(stderr, "Shard %d: session pool exhausted\n", server->shard_idx);
+    close_connection(server, first);
+    if(second != NULL)
+      close_connection(server, second);
+    return;
+  }
+  session->players[0] = first;
+  session->players[1] = second;
+  metric_add(&server->metrics.games_started, 1);
+  journal_event(server, session, JOURNAL_GAME_START, (second == NULL) ? 1 : JOURNAL_NO_PLAYER, 0, 0, NO_SHIP, 0, config.salvo ? JOURNAL_FLAG_SALVO : 0);
+  if(!game_config_is_classic(&config)){
+    journal_event(server, session, JOURNAL_BOARD, JOURNAL_NO_PLAYER, config.rows, config.cols, (ShipType)config.num_ships, 0, 0);
+    for(int s = 0; s < config.num_ships; s++)
+      journal_event(server, session, JOURNAL_FLEET, JOURNAL_NO_PLAYER, config.ship_sizes[s], 0, (ShipType)s, 0, 0);
+  }
+
+  for(int i = 0; i < MAX_CLIENT; i++){
+    if(session->players[i] == NULL){
+      session->ai_slot = i;
+      ai_init(&session->ai, (uint64_t)time(NULL) ^ ((uint64_t)session->id << 32));
+      ai_place_fleet(&session->player_boards[i].dense, &session->ai.rng);
+      for(int s = 0; s < NUM_SHIPS; s++){
+        const Ship *ship = &session->player_boards[i].dense.ships[s];
+        journal_event(server, session, JOURNAL_PLACEMENT, i, ship->row, ship->col, ship->type, ship->orientation, 0);
+      }
+      continue;
+    }
+    session->players[i]->session = session;
+    session->players[i]->player_idx = i;
+
+    GameMessage msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = MSG_TYPE_TEST;
+    sprintf(msg.message, "Welcome Player %d", i + 1);
+    send_message(server, session->players[i], &msg);
+    send_config(server, session, session->players[i]);
+
+    if(server->journal != NULL){
+      // Lets the player pick the game up again after a server restart
+      msg.type = MSG_TYPE_RESUME_TOKEN;
+      snprintf(msg.message, sizeof(msg.message), "%d.%d.%016llx", session->id, i, (unsigned long long)resume_mac(session->id, i));
+      send_message(server, session->players[i], &msg);
+    }
+  }
+  LOG("Game %d started%s. Active games: %d\n", session->id, session->ai_slot >= 0 ? " against the computer" : "", server->active_sessions);
+
+  send_placement_prompt(server, session);
+}
+
+// A player dropped: the game cannot continue, tell the opponent and tear it down.
+static void handle_disconnect(Server *server, Connection *conn){
+  Session *session = conn->session;
+  if(session == NULL){
+    detach_spectator(server, conn);
+    close_connection(server, conn);
+    return;
+  }
+  LOG("Game %d: Player %d disconnected or error.\n", session->id, conn->player_idx + 1);
+  metric_add(&server->metrics.disconnects, 1);
+  int opponent_idx = (conn->player_idx == 0) ? 1 : 0;
+  session->players[conn->player_idx] = NULL;
+  close_connection(server, conn);
+
+  GameMessage game_over_msg;
+  memset(&game_over_msg, 0, sizeof(game_over_msg));
+  game_over_msg.type = MSG_TYPE_GAME_OVER;
+  game_over_msg.success = 1;
+  sprintf(game_over_msg.message, "Opponent disconnected.");
+  send_message(server, session->players[opponent_idx], &game_over_msg);
+  char result[MAX_MSG_LEN];
+  snprintf(result, sizeof(result), "Player %d disconnected.", conn->player_idx + 1);
+  send_game_over_to_spectators(server, session, opponent_idx, result);
+  journal_event(server, session, JOURNAL_GAME_END, opponent_idx, 0, 0, NO_SHIP, 0, JOURNAL_FLAG_DISCONNECT);
+  session->current_game_phase = GAME_PHASE_GAMEOVER;
+  end_session(server, session);
+}
+
+static void publish_handoff(Connection *conn, Server *target){
+  Connection *head = atomic_load_explicit(&target->inbox, memory_order_relaxed);
+  do{
+    conn->next_handoff = head;
+  } while(!atomic_compare_exchange_weak_explicit(&target->inbox, &head, conn, memory_order_release, memory_order_relaxed));
+
+  uint64_t one = 1;
+  if(write(target->event_fd, &one, sizeof(one)) < 0 && errno != EAGAIN)
+    perror("eventfd write failed");
+}
+
+// Publish a connection handed off on io_uring once the ring has nothing
+// left in flight on it and nothing left to submit.
+static void finish_handoff(Connection *conn){
+  if(conn->handoff_target == NULL || conn->uring_ops > 0 || conn->dirty)
+    return;
+  Server *target = conn->handoff_target;
+  conn->handoff_target = NULL;
+  publish_handoff(conn, target);
+}
+
+// Move a connection to another shard's event loop. It leaves this epoll set,
+// or on io_uring has its receive cancelled and its last send completed,
+// and its queued output is written, before it is published, so only one
+// thread ever touches it at a time.
+static void hand_off_connection(Server *server, Connection *conn, Server *target){
+  timer_cancel(&server->timers, &conn->idle_timer); // Timers never cross shards
+  server->moved = conn;
+  conn->handoff_target = target;
+  if(server->uring == NULL){
+    metric_add(&server->metrics.io_syscalls, 1);
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    if(conn->shm.channel != NULL){
+      metric_add(&server->metrics.io_syscalls, 1);
+      epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, conn->shm.wake_fd, NULL);
+    }
+    finish_handoff(conn);
+    return;
+  }
+  if(conn->recv_armed)
+    cancel_request(server, uring_tag(conn, URING_RECV));
+  if(conn->shm_armed)
+    cancel_request(server, uring_tag(conn, URING_SHM));
+  finish_handoff(conn);
+}
+
+// Bring a reconnecting player up to date: their fleet, every shot on both
+// boards, then whatever the game is waiting for from them.
+static void send_game_state(Server *server, Session *session, int player){
+  Connection *conn = session->players[player];
+  const GameBoard *own = &session->player_boards[player];
+  GameMessage msg;
+  send_config(server, session, conn);
+  for(int i = 0; i < game_board_num_ships(own); i++){
+    const Ship *ship = game_board_ship(own, i);
+    if(!ship->is_placed)
+      continue;
+    memset(&msg, 0, sizeof(msg));
+    msg.type = MSG_TYPE_PLACEMENT_RES;
+    msg.success = 1;
+    msg.row = ship->row;
+    msg.col = ship->col;
+    msg.ship_type = ship->type;
+    msg.orientation = ship->orientation;
+    send_message(server, conn, &msg);
+  }
+  for(int side = 0; side < MAX_CLIENT; side++){
+    const GameBoard *board = &session->player_boards[side];
+    uint32_t pos = 0;
+    int r, c, is_hit;
+    while(game_board_next_shot(board, &pos, &r, &c, &is_hit)){
+      memset(&msg, 0, sizeof(msg));
+      msg.type = MSG_TYPE_SHOT_RES;
+      msg.row = r;
+      msg.col = c;
+      msg.ship_type = NO_SHIP;
+      msg.is_hit = is_hit;
+      msg.own_board = (side == player);
+      send_message(server, conn, &msg);
+    }
+  }
+  if(session->current_player_turn != player)
+    return;
+  if(session->current_game_phase == GAME_PHASE_PLACEMENT)
+    send_placement_prompt(server, session);
+  else if(session->current_game_phase == GAME_PHASE_SHOOTING)
+    send_turn_indication(server, session);
+}
+
+// Seat a connection carrying a resume request in its game on this shard.
+static void attach_resumed(Server *server, Connection *conn){
+  Session *session = find_session(server, (int)conn->resume_session_id);
+  int player = conn->resume_player;
+  int ok = session != NULL && player >= 0 && player < MAX_CLIENT && player != session->ai_slot &&
+           session->players[player] == NULL && conn->resume_mac == resume_mac(session->id, player);
+  conn->resume_session_id = 0;
+
+  GameMessage res;
+  memset(&res, 0, sizeof(res));
+  res.type = MSG_TYPE_RESUME_RES;
+  res.success = ok;
+  if(!ok){
+    sprintf(res.message, "No game to resume.");
+    send_message(server, conn, &res);
+    if(has_pending_output(conn))
+      conn->close_after_flush = 1;
+    else
+      close_connection(server, conn);
+    return;
+  }
+  session->players[player] = conn;
+  conn->session = session;
+  conn->player_idx = player;
+  send_message(server, conn, &res);
+  LOG("Game %d: Player %d resumed.\n", session->id, player + 1);
+  send_game_state(server, session, player);
+}
+
+// Tokens look like "<session id>.<player>.<mac>". The session id tells
+// which shard owns the game.
+static void handle_resume_request(Server *server, Connection *conn, const GameMessage *msg){
+  unsigned session_id;
+  int player;
+  unsigned long long mac;
+  lobby_remove(&server->lobby, conn);
+  if(sscanf(msg->message, "%u.%d.%16llx", &session_id, &player, &mac) != 3 || session_id == 0){
+    conn->resume_session_id = 0;
+    attach_resumed(server, conn); // Rejects
+    return;
+  }
+  conn->resume_session_id = session_id;
+  conn->resume_player = player;
+  conn->resume_mac = mac;
+  int owner = (int)((session_id - 1) % (unsigned)num_shards);
+  if(owner == server->shard_idx)
+    attach_resumed(server, conn);
+  else
+    hand_off_connection(server, conn, &shards[owner]);
+}
+
+// Pairing happens as soon as players connect, usually before their first
+// message is read, so a reconnecting player may already sit in a new game.
+// That is harmless as long as no ship has been placed in it.
+static int session_is_fresh(const Session *session){
+  if(session->current_game_phase != GAME_PHASE_PLACEMENT)
+    return 0;
+  for(int p = 0; p < MAX_CLIENT; p++){
+    if(p == session->ai_slot)
+      continue;
+    const GameBoard *board = &session->player_boards[p];
+    for(int i = 0; i < game_board_num_ships(board); i++)
+      if(game_board_ship(board, i)->is_placed)
+        return 0;
+  }
+  return 1;
+}
+
+// Undo a fresh game: its players go back to being unpaired and the human
+// partner, if any, rejoins the queue.
+static void cancel_fresh_session(Server *server, Session *session){
+  send_game_over_to_spectators(server, session, -1, "Game cancelled.");
+  journal_event(server, session, JOURNAL_GAME_END, JOURNAL_NO_PLAYER, 0, 0, NO_SHIP, 0, JOURNAL_FLAG_CANCELLED);
+  for(int i = 0; i < MAX_CLIENT; i++){
+    Connection *conn = session->players[i];
+    if(conn == NULL)
+      continue;
+    session->players[i] = NULL;
+    conn->session = NULL;
+    conn->player_idx = -1;
+    lobby_push(&server->lobby, conn, now_ns());
+  }
+  end_session(server, session);
+}
+
+// Add a connection carrying a spectate request to its game's watchers on
+// this shard and catch it up on the shots fired so far.
+static void attach_spectator(Server *server, Connection *conn){
+  Session *session = find_session(server, (int)conn->watch_session_id);
+  conn->watch_session_id = 0;
+
+  GameMessage msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.type = MSG_TYPE_SPECTATE_RES;
+  if(session == NULL || (conn->frames == NULL && (conn->frames = calloc(1, sizeof(FrameQueue))) == NULL)){
+    sprintf(msg.message, "No game to watch.");
+    send_message(server, conn, &msg);
+    if(has_pending_output(conn))
+      conn->close_after_flush = 1;
+    else
+      close_connection(server, conn);
+    return;
+  }
+  msg.success = 1;
+  snprintf(msg.message, sizeof(msg.message), "Watching game %d.", session->id);
+  send_message(server, conn, &msg);
+  send_config(server, session, conn);
+  for(int side = 0; side < MAX_CLIENT; side++){
+    const GameBoard *board = &session->player_boards[side];
+    uint32_t pos = 0;
+    int r, c, is_hit;
+    while(game_board_next_shot(board, &pos, &r, &c, &is_hit)){
+      memset(&msg, 0, sizeof(msg));
+      msg.type = MSG_TYPE_SHOT_RES;
+      msg.row = r;
+      msg.col = c;
+      msg.ship_type = NO_SHIP;
+      msg.is_hit = is_hit;
+      msg.orientation = 1 - side; // Shooter
+      send_message(server, conn, &msg);
+    }
+  }
+
+  conn->watching = session;
+  conn->spectator_prev = NULL;
+  conn->spectator_next = session->spectators;
+  if(session->spectators != NULL)
+    session->spectators->spectator_prev = conn;
+  session->spectators = conn;
+  server->spectators++;
+  LOG("Game %d: spectator joined.\n", session->id);
+}
+
+// The game id tells which shard owns the game; no id means the newest game
+// under way on the shard the spectator connected to.
+static void handle_spectate_request(Server *server, Connection *conn, const GameMessage *msg){
+  lobby_remove(&server->lobby, conn);
+  char *end;
+  unsigned long session_id = strtoul(msg->message, &end, 10);
+  if(msg->message[0] == '\0'){
+    Session *newest = server->sessions;
+    while(newest != NULL && session_is_fresh(newest))
+      newest = newest->next; // Skip games that may still be cancelled
+    session_id = (newest != NULL) ? (unsigned long)newest->id : 0;
+  }
+  else if(*end != '\0')
+    session_id = 0;
+  conn->watch_session_id = (uint32_t)session_id;
+  if(session_id == 0){
+    attach_spectator(server, conn); // Rejects
+    return;
+  }
+  int owner = (int)((session_id - 1) % (unsigned)num_shards);
+  if(owner == server->shard_idx)
+    attach_spectator(server, conn);
+  else
+    hand_off_connection(server, conn, &shards[owner]);
+}
+
+// Remember the board a player wants for their next pairing. Like a resume
+// request it may arrive after the lobby already paired them; a fresh game
+// is then cancelled so both players are paired again with the request.
+static void handle_config_request(Server *server, Connection *conn, const GameMessage *msg){
+  GameConfig config;
+  config.rows = msg->row;
+  config.cols = msg->col;
+  if(game_config_parse(&config, msg->message) < 0 || !game_config_valid(&config)){
+    LOG("Rejected board request %dx%d with fleet \"%s\".\n", msg->row, msg->col, msg->message);
+    GameMessage res;
+    memset(&res, 0, sizeof(res));
+    res.type = MSG_TYPE_CONFIG;
+    res.success = 0;
+    sprintf(res.message, "Unsupported board.");
+    send_message(server, conn, &res);
+    return;
+  }
+  conn->config = config;
+  conn->custom_config = 1;
+  Session *session = conn->session;
+  if(session != NULL && session->ai_slot < 0 && session_is_fresh(session))
+    cancel_fresh_session(server, session);
+}
+
+static int watch_shm(Server *server, Connection *conn){
+  if(server->uring != NULL)
+    return arm_shm_poll(server, conn);
+  // Tagged in the low bit: the same connection as its socket, but the ring woke up
+  metric_add(&server->metrics.io_syscalls, 1);
+  struct epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.ptr = (void *)((uintptr_t)conn | 1);
+  if(epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, conn->shm.wake_fd, &ev) < 0){
+    perror("epoll_ctl failed");
+    return -1;
+  }
+  return 0;
+}
+
+// Move a connection that asked for the rings over to them, once everything
+// queued for its socket has gone out: SHM_RES is the last frame the socket
+// carries, and it carries the ring's descriptors with it.
+static void start_shm(Server *server, Connection *conn){
+  if(!conn->shm_requested || conn->closed || has_pending_output(conn))
+    return;
+  conn->shm_requested = 0;
+  GameMessage res;
+  memset(&res, 0, sizeof(res));
+  res.type = MSG_TYPE_SHM_RES;
+  int memfd;
+  if(shm_server_open(&conn->shm, &memfd) < 0){
+    perror("Shared memory setup failed");
+    sprintf(res.message, "No shared memory.");
+    send_message(server, conn, &res);
+    return;
+  }
+  res.success = 1;
+  uint8_t frame[PROTO_MAX_FRAME];
+  size_t len = encode_message(&res, frame, sizeof(frame));
+  int fds[SHM_FDS] = {memfd, conn->shm.peer_wake_fd, conn->shm.wake_fd};
+  ssize_t n = shm_send_fds(conn->fd, frame, len, fds, SHM_FDS);
+  metric_add(&server->metrics.io_syscalls, 1);
+  close(memfd);
+  if(n != (ssize_t)len){
+    // Nothing else was queued, so only a peer that is gone refuses one small frame
+    shm_close(&conn->shm);
+    handle_disconnect(server, conn);
+    return;
+  }
+  metric_count_message(server->metrics.messages_out, MSG_TYPE_SHM_RES);
+  if(watch_shm(server, conn) < 0){
+    handle_disconnect(server, conn);
+    return;
+  }
+  LOG("Client switched to shared memory.\n");
+}
+
+static void handle_shm_request(Server *server, Connection *conn){
+  if(!conn->local || conn->shm.channel != NULL){
+    GameMessage res;
+    memset(&res, 0, sizeof(res));
+    res.type = MSG_TYPE_SHM_RES;
+    sprintf(res.message, "Shared memory is for Unix socket clients.");
+    send_message(server, conn, &res);
+    return;
+  }
+  conn->shm_requested = 1;
+  start_shm(server, conn);
+}
+
+static void send_hint_refusal(Server *server, Connection *conn, const char *text){
+  GameMessage res;
+  memset(&res, 0, sizeof(res));
+  res.type = MSG_TYPE_HINT_RES;
+  res.ship_type = NO_SHIP;
+  snprintf(res.message, sizeof(res.message), "%s", text);
+  send_message(server, conn, &res);
+}
+
+// The solver runs on the shard's hint worker for at most hint_budget_ms,
+// on what the player has been told, so a player gets one hint per turn and
+// the other games on the shard never wait for it.
+static void handle_hint_request(Server *server, Session *session, Connection *conn){
+  if(hint_budget_ms <= 0 || session->player_boards[1 - conn->player_idx].sparse){
+    send_hint_refusal(server, conn, "Hints are only given on the classic board.");
+    return;
+  }
+  if(session->current_game_phase != GAME_PHASE_SHOOTING || conn->player_idx != session->current_player_turn || session->hinted){
+    send_hint_refusal(server, conn, "One hint per turn, on your turn.");
+    return;
+  }
+  HintJob *job = malloc(sizeof(*job));
+  if(job == NULL || (server->hints == NULL && (server->hints = hint_worker_start(server->event_fd)) == NULL)){
+    free(job);
+    send_hint_refusal(server, conn, "No hint right now.");
+    return;
+  }
+  session->hinted = 1;
+  job->session_id = session->id;
+  job->player = conn->player_idx;
+  job->turn = session->turns;
+  job->view = session->seen[conn->player_idx];
+  job->budget_ns = (uint64_t)hint_budget_ms * 1000000ULL;
+  job->asked_ns = now_ns();
+  hint_worker_submit(server->hints, job);
+}
+
+// Send the hint worker's answers whose turn is still on; the rest are
+// dropped, the player having fired, left or lost meanwhile.
+static void deliver_hints(Server *server){
+  if(server->hints == NULL)
+    return;
+  HintJob *job = hint_worker_take(server->hints);
+  while(job != NULL){
+    HintJob *next = job->next;
+    Session *session = find_session(server, job->session_id);
+    if(session != NULL && session->current_game_phase == GAME_PHASE_SHOOTING && session->current_player_turn == job->player &&
+       session->turns == job->turn && session->players[job->player] != NULL){
+      const SolverResult *result = &job->result;
+      GameMessage res;
+      memset(&res, 0, sizeof(res));
+      res.type = MSG_TYPE_HINT_RES;
+      res.ship_type = NO_SHIP;
+      res.success = 1;
+      res.row = result->row;
+      res.col = result->col;
+      int chance = (int)(result->hit_chance[cell_index(result->row, result->col)] * 100.0f + 0.5f);
+      if(!result->exact)
+        snprintf(res.message, sizeof(res.message), "Fire at (%d,%d): about %d%% to hit (estimate).", result->row, result->col, chance);
+      else if(result->solved)
+        snprintf(res.message, sizeof(res.message), "Fire at (%d,%d): %d%% to hit over %.0f layouts, best play sinks the rest in %.2f shots.", result->row, result->col, chance, result->layouts, result->expected_shots);
+      else
+        snprintf(res.message, sizeof(res.message), "Fire at (%d,%d): %d%% to hit over %.0f layouts, searched %d shots ahead.", result->row, result->col, chance, result->layouts, result->depth);
+      send_message(server, session->players[job->player], &res);
+      histogram_record(&server->metrics.hint_ns, now_ns() - job->asked_ns);
+      LOG("Game %d: Player %d got a hint for (%d,%d).\n", session->id, job->player + 1, result->row, result->col);
+    }
+    free(job);
+    job = next;
+  }
+}
+
+static void dispatch_message(Server *server, Connection *conn, const GameMessage *msg){
+  Session *session = conn->session;
+  if(msg->type == MSG_TYPE_SHM_REQ){
+    handle_shm_request(server, conn);
+    return;
+  }
+  if(msg->type == MSG_TYPE_RESUME_REQ && (session == NULL ? conn->queued : session_is_fresh(session))){
+    if(session != NULL)
+      cancel_fresh_session(server, session);
+    handle_resume_request(server, conn, msg);
+    return;
+  }
+  if(msg->type == MSG_TYPE_SPECTATE_REQ && conn->watching == NULL && (session == NULL ? conn->queued : session_is_fresh(session))){
+    if(session != NULL)
+      cancel_fresh_session(server, session);
+    handle_spectate_request(server, conn, msg);
+    return;
+  }
+  if(conn->watching != NULL)
+    return; // Spectators only listen
+  if(msg->type == MSG_TYPE_CONFIG_REQ){
+    handle_config_request(server, conn, msg);
+    return;
+  }
+  if(session == NULL){
+    if(msg->type == MSG_TYPE_AI_GAME_REQ && conn->queued){
+      lobby_remove(&server->lobby, conn);
+      start_session(server, conn, NULL);
+      return;
+    }
+    LOG("Unpaired connection sent message type %d, ignoring.\n", msg->type);
+    return;
+  }
+  if(msg->type == MSG_TYPE_HINT_REQ){
+    handle_hint_request(server, session, conn);
+    return;
+  }
+  if(msg->type == MSG_TYPE_FLEET_REQ && session->current_game_phase == GAME_PHASE_PLACEMENT){
+    handle_fleet(server, session, conn->player_idx, msg);
+    return;
+  }
+  if(conn->player_idx != session->current_player_turn){
+    LOG("Game %d: Player %d sent message type %d out of turn, ignoring.\n", session->id, conn->player_idx + 1, msg->type);
+    return;
+  }
+  if(session->current_game_phase == GAME_PHASE_PLACEMENT)
+    handle_placement(server, session, msg);
+  else if(session->current_game_phase == GAME_PHASE_SHOOTING)
+    handle_shot(server, session, msg);
+}
+
+// Handle every complete frame buffered for the connection. Returns -1 on
+// a malformed frame, 1 once the connection is no longer this loop's to
+// read from, 0 when more input is wanted.
+static int dispatch_frames(Server *server, Connection *conn, uint64_t received_at){
+  GameMessage msg;
+  int status;
+  while((status = frame_reader_next(&conn->reader, &msg)) == 1){
+    metric_count_message(server->metrics.messages_in, msg.type);
+    server->shot_resolved = 0;
+    dispatch_message(server, conn, &msg);
+    if(server->shot_resolved) // Out-of-turn and rejected requests don't count
+      histogram_record(&server->metrics.turn_ns, now_ns() - received_at);
+    // The handler may have ended the game and closed or scheduled closing
+    // this socket, or handed it to another shard.
+    if(server->moved == conn || conn->closed || conn->close_after_flush)
+      return 1;
+  }
+  if(status < 0){
+    LOG("Malformed frame from client, dropping connection.\n");
+    return -1;
+  }
+  return 0;
+}
+
+// Read whatever is available. Returns -1 if the peer is gone or broke the protocol.
+static int handle_readable(Server *server, Connection *conn){
+  server->moved = NULL;
+  for(;;){
+    size_t room = sizeof(conn->reader.buf) - (conn->reader.len - conn->reader.start);
+    ssize_t n = frame_reader_recv(&conn->reader, conn->fd);
+    metric_add(&server->metrics.io_syscalls, 1);
+    if(n == 0)
+      return -1;
+    if(n < 0){
+      if(errno == EINTR)
+        continue;
+      if(errno == EAGAIN || errno == EWOULDBLOCK)
+        return 0;
+      return -1;
+    }
+    uint64_t received_at = now_ns();
+    conn->last_heard_ms = received_at / 1000000ull;
+    int status = dispatch_frames(server, conn, received_at);
+    if(status != 0)
+      return (status < 0) ? -1 : 0;
+    if((size_t)n < room)
+      return 0; // Drained: epoll is level triggered, so skip the recv() that would say EAGAIN
+  }
+}
+
+// Bytes that came in other than by recv(): an io_uring completion or the
+// shared-memory ring. Returns -1 if the peer broke the protocol.
+static int handle_received(Server *server, Connection *conn, const unsigned char *data, size_t len){
+  server->moved = NULL;
+  uint64_t received_at = now_ns();
+  conn->last_heard_ms = received_at / 1000000ull;
+  while(len > 0){
+    size_t taken = frame_reader_append(&conn->reader, data, len);
+    data += taken;
+    len -= taken;
+    int status = dispatch_frames(server, conn, received_at);
+    if(status < 0)
+      return -1;
+    if(status > 0){
+      if(server->moved == conn && len > 0)
+        frame_reader_append(&conn->reader, data, len); // The rest travels with it
+      return 0;
+    }
+    if(taken == 0)
+      return -1; // A full reader without a whole frame in it
+  }
+  return 0;
+}
+
+// Dispatch what the client put in the ring, until it is empty and we are
+// flagged as asleep. Returns -1 if the client broke the protocol.
+static int drain_shm(Server *server, Connection *conn){
+  unsigned char buf[PROTO_READ_BUF];
+  for(;;){
+    // No more than the reader takes: if a frame hands the connection to
+    // another shard, no bytes are left over in buf
+    size_t room = sizeof(conn->reader.buf) - (conn->reader.len - conn->reader.start);
+    size_t n = shm_read(&conn->shm, buf, room);
+    if(n == 0){
+      if(room == 0)
+        return -1; // A full reader without a whole frame in it
+      if(!shm_prepare_wait(&conn->shm))
+        return 0;
+      continue;
+    }
+    if(handle_received(server, conn, buf, n) < 0)
+      return -1;
+    if(server->moved == conn || conn->closed || conn->close_after_flush)
+      return 0;
+  }
+}
+
+// The client put frames in the ring or made room in ours.
+static void handle_shm_wakeup(Server *server, Connection *conn){
+  shm_clear_wake(&conn->shm);
+  metric_add(&server->metrics.io_syscalls, 1);
+  if(has_pending_output(conn))
+    flush_connection(server, conn);
+  if(conn->close_after_flush){
+    if(!has_pending_output(conn))
+      close_connection(server, conn);
+    return;
+  }
+  if(drain_shm(server, conn) < 0)
+    handle_disconnect(server, conn);
+}
+
+// Pair queued players first-come first-served, two at a time.
+static void match_waiting(Server *server){
+  Lobby *lobby = &server->lobby;
+  if(lobby->depth < MAX_CLIENT)
+    return;
+  uint64_t now = now_ns();
+  while(lobby->depth >= MAX_CLIENT){
+    Connection *first = lobby_pop(lobby, now);
+    Connection *second = lobby_pop(lobby, now);
+    lobby->matched += 2;
+    start_session(server, first, second);
+  }
+}
+
+// Start reading from a connection new to this shard.
+static int watch_connection(Server *server, Connection *conn){
+  if(server->uring != NULL){
+    if(arm_recv(server, conn) < 0)
+      return -1;
+    return (conn->shm.channel != NULL) ? watch_shm(server, conn) : 0;
+  }
+  metric_add(&server->metrics.io_syscalls, 1);
+  struct epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.ptr = conn;
+  if(epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, conn->fd, &ev) < 0){
+    perror("epoll_ctl failed");
+    return -1;
+  }
+  conn->want_write = 0;
+  return (conn->shm.channel != NULL) ? watch_shm(server, conn) : 0;
+}
+
+// Adopt connections other shards handed over. The whole stack is taken at
+// once and reversed so players keep their arrival order.
+static void drain_inbox(Server *server){
+  uint64_t count;
+  while(read(server->event_fd, &count, sizeof(count)) < 0 && errno == EINTR)
+    ;
+  Connection *list = atomic_exchange_explicit(&server->inbox, NULL, memory_order_acquire);
+  Connection *ordered = NULL;
+  while(list != NULL){
+    Connection *next = list->next_handoff;
+    list->next_handoff = ordered;
+    ordered = list;
+    list = next;
+  }
+  while(ordered != NULL){
+    Connection *conn = ordered;
+    ordered = conn->next_handoff;
+    conn->next_handoff = NULL;
+
+    if(watch_connection(server, conn) < 0){
+      close(conn->fd);
+      free_connection(server, conn);
+      continue;
+    }
+    if(has_pending_output(conn))
+      flush_connection(server, conn); // Replies queued on the shard it came from
+    arm_idle_timer(server, conn);
+    if(conn->resume_session_id != 0)
+      attach_resumed(server, conn);
+    else if(conn->watch_session_id != 0)
+      attach_spectator(server, conn);
+    else
+      lobby_push(&server->lobby, conn, conn->queued_at_ns); // Keep the original wait
+    start_shm(server, conn); // Asked for before the hand-off, still waiting for output to drain
+  }
+}
+
+// Milliseconds until the lobby's head should be handed over, -1 if never.
+static int handoff_timeout_ms(Server *server, uint64_t now){
+  Connection *head = server->lobby.head;
+  if(server->shard_idx == 0 || head == NULL)
+    return -1;
+  uint64_t due = head->queued_at_ns + (uint64_t)HANDOFF_MS * 1000000ull;
+  return (due > now) ? (int)((due - now + 999999) / 1000000) : 0;
+}
+
+static void hand_off_stale_waiters(Server *server){
+  if(server->shard_idx == 0)
+    return;
+  uint64_t now = now_ns();
+  while(server->lobby.head != NULL && now - server->lobby.head->queued_at_ns >= (uint64_t)HANDOFF_MS * 1000000ull){
+    // The lone waiter goes to shard 0, where every shard's leftovers meet
+    Connection *conn = server->lobby.head;
+    lobby_remove(&server->lobby, conn);
+    server->lobby.handed_off++;
+    hand_off_connection(server, conn, &shards[0]);
+  }
+}
+
+// The player the game was waiting on let their clock run out: they forfeit.
+static void handle_deadline(Server *server, Session *session){
+  int late = session->current_player_turn;
+  int winner = (late == 0) ? 1 : 0;
+  LOG("Game %d: Player %d ran out of time.\n", session->id, late + 1);
+  metric_add(&server->metrics.timeouts, 1);
+
+  GameMessage game_over_msg;
+  memset(&game_over_msg, 0, sizeof(game_over_msg));
+  game_over_msg.type = MSG_TYPE_GAME_OVER;
+  game_over_msg.success = 1;
+  sprintf(game_over_msg.message, "Opponent ran out of time.");
+  send_message(server, session->players[winner], &game_over_msg);
+  game_over_msg.success = 0;
+  sprintf(game_over_msg.message, "Out of time.");
+  send_message(server, session->players[late], &game_over_msg);
+  char result[MAX_MSG_LEN];
+  snprintf(result, sizeof(result), "Player %d ran out of time.", late + 1);
+  send_game_over_to_spectators(server, session, winner, result);
+  journal_event(server, session, JOURNAL_GAME_END, winner, 0, 0, NO_SHIP, 0, JOURNAL_FLAG_TIMEOUT);
+  session->current_game_phase = GAME_PHASE_GAMEOVER;
+  end_session(server, session);
+}
+
+// Only unpaired connections are reaped for silence: in a game the deadlines
+// decide, and spectators never talk. Players waiting in the lobby send
+// nothing either, so a long enough wait there counts as idle too.
+static void handle_idle_timer(Server *server, Connection *conn, uint64_t now){
+  if(conn->session != NULL || conn->watching != NULL){
+    timer_arm(&server->timers, &conn->idle_timer, now + (uint64_t)idle_timeout * 1000ull);
+    return;
+  }
+  uint64_t quiet_until = conn->last_heard_ms + (uint64_t)idle_timeout * 1000ull;
+  if(quiet_until > now){
+    timer_arm(&server->timers, &conn->idle_timer, quiet_until); // Heard from since the timer was armed
+    return;
+  }
+  LOG("Closing a connection silent for %d s.\n", idle_timeout);
+  metric_add(&server->metrics.idle_reaped, 1);
+  close_connection(server, conn);
+}
+
+// Fire whatever is due. Handlers end games and close connections, which
+// cancels other timers, so they are taken from the wheel one at a time.
+static void expire_timers(Server *server){
+  uint64_t now = now_ms();
+  Timer *timer;
+  while((timer = timer_wheel_expire(&server->timers, now)) != NULL){
+    if(timer->kind == TIMER_DEADLINE)
+      handle_deadline(server, (Session *)((char *)timer - offsetof(Session, deadline)));
+    else
+      handle_idle_timer(server, (Connection *)((char *)timer - offsetof(Connection, idle_timer)), now);
+  }
+}
+
+static void publish_pool_stats(Server *server){
+  Pool *pools[METRICS_POOLS] = {
+    [POOL_SESSIONS] = &server->session_pool,
+    [POOL_CONNECTIONS] = &server->conn_pool,
+    [POOL_FRAMES] = &server->frame_pool,
+    [POOL_ARENA_CHUNKS] = &server->chunk_pool,
+    [POOL_OUT_BUFS] = &server->buf_pool
+  };
+  for(int i = 0; i < METRICS_POOLS; i++){
+    pool_reclaim(pools[i]);
+    metric_set(&server->metrics.pool_in_use[i], pools[i]->in_use);
+    metric_set(&server->metrics.pool_capacity[i], pools[i]->capacity);
+  }
+}
+
+static void print_lobby_stats(Server *server, int interval){
+  Lobby *lobby = &server->lobby;
+  double avg_ms = lobby->matched ? (double)lobby->wait_total_ns / lobby->matched / 1e6 : 0.0;
+  char prefix[32] = "Lobby";
+  if(num_shards > 1)
+    snprintf(prefix, sizeof(prefix), "Shard %d lobby", server->shard_idx);
+  printf("%s: %d waiting (peak %d), %llu matched, %llu handed off in %ds, time-to-match avg %.2f ms max %.2f ms, active games %d\n",
+         prefix, lobby->depth, lobby->peak_depth, (unsigned long long)lobby->matched,
+         (unsigned long long)lobby->handed_off, interval,
+         avg_ms, (double)lobby->wait_max_ns / 1e6, server->active_sessions);
+  fflush(stdout);
+  lobby->peak_depth = lobby->depth;
+  lobby->matched = 0;
+  lobby->handed_off = 0;
+  lobby->wait_total_ns = 0;
+  lobby->wait_max_ns = 0;
+}
+
+// Seat a freshly accepted socket: against the computer with -a, otherwise
+// in the lobby.
+static void adopt_socket(Server *server, int fd, int local){
+  Connection *conn = pool_alloc(&server->conn_pool);
+  if(conn == NULL){
+    fprintf(stderr, "Shard %d: connection pool exhausted\n", server->shard_idx);
+    close(fd);
+    return;
+  }
+  if(!local){
+    // Replies are already batched per loop iteration; don't let Nagle hold them back
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  }
+  conn->pool = &server->conn_pool;
+  conn->fd = fd;
+  conn->local = local;
+  conn->player_idx = -1;
+  conn->last_heard_ms = now_ms();
+  frame_reader_init(&conn->reader);
+  if(watch_connection(server, conn) < 0){
+    close(fd);
+    pool_free(&server->conn_pool, conn);
+    return;
+  }
+  metric_add(&server->metrics.connections_accepted, 1);
+  arm_idle_timer(server, conn);
+
+  if(ai_opponents)
+    start_session(server, conn, NULL);
+  else
+    lobby_push(&server->lobby, conn, now_ns());
+}
+
+// Accept up to ACCEPT_BATCH pending connections. The listener is level
+// triggered, so anything left over is picked up on the next epoll_wait
+// after the other ready sockets had their turn.
+static void handle_accept(Server *server, int listen_sock, int local){
+  for(int accepted = 0; accepted < ACCEPT_BATCH; accepted++){
+    struct sockaddr_in client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    int fd = accept4(listen_sock, local ? NULL : (struct sockaddr*)&client_addr, local ? NULL : &client_len, SOCK_NONBLOCK);
+    metric_add(&server->metrics.io_syscalls, 1);
+    if(fd < 0){
+      if(errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        perror("Accept failed");
+      return;
+    }
+    if(local)
+      LOG("Client connected on %s\n", unix_path);
+    else
+      LOG("Client connected from %s:%d\n", inet_ntoa(client_addr.sin_addr), ntohs(client_addr.sin_port));
+    adopt_socket(server, fd, local);
+  }
+}
+
+// io_uring: a receive completion. Data that arrives while a hand-off waits
+// for the ring to let go is only buffered; the new shard dispatches it.
+static void handle_recv_completion(Server *server, Connection *conn, const struct io_uring_cqe *cqe){
+  if(!(cqe->flags & IORING_CQE_F_MORE)){
+    conn->recv_armed = 0;
+    conn->uring_ops--;
+  }
+  int res = cqe->res;
+  if(cqe->flags & IORING_CQE_F_BUFFER){
+    unsigned bid = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+    const unsigned char *data = uring_buf(server->uring, bid);
+    if(res > 0 && !conn->closed && !conn->close_after_flush){
+      if(conn->handoff_target != NULL)
+        frame_reader_append(&conn->reader, data, (size_t)res);
+      else if(handle_received(server, conn, data, (size_t)res) < 0)
+        res = -EPROTO;
+    }
+    uring_recycle_buf(server->uring, bid);
+  }
+  if(conn->closed)
+    return;
+  if(conn->handoff_target != NULL){
+    finish_handoff(conn);
+    return;
+  }
+  if(res > 0 || res == -ENOBUFS){
+    // The kernel ends a multishot receive when it runs out of buffers
+    if(!conn->recv_armed && !conn->close_after_flush && arm_recv(server, conn) < 0)
+      handle_disconnect(server, conn);
+    return;
+  }
+  if(conn->close_after_flush)
+    close_connection(server, conn);
+  else
+    handle_disconnect(server, conn);
+}
+
+// io_uring: a send completion. Whatever queued up meanwhile goes out in
+// the next one.
+static void handle_send_completion(Server *server, Connection *conn, int kind, int res){
+  conn->sending = 0;
+  conn->uring_ops--;
+  if(conn->closed)
+    return;
+  if(res < 0){
+    conn->send_len = conn->send_off = 0;
+    if(conn->handoff_target != NULL)
+      finish_handoff(conn); // The new shard finds the socket broken
+    else if(conn->close_after_flush)
+      close_connection(server, conn);
+    else
+      handle_disconnect(server, conn);
+    return;
+  }
+  if(kind == URING_SEND){
+    conn->send_off += (size_t)res;
+    if(conn->send_off < conn->send_len){
+      if(submit_send(server, conn) < 0)
+        close_connection(server, conn);
+      return;
+    }
+    conn->send_len = conn->send_off = 0;
+  }
+  else{
+    frame_queue_consume(conn->frames, (size_t)res);
+  }
+  if(conn->handoff_target != NULL)
+    finish_handoff(conn);
+  else if(has_pending_output(conn))
+    mark_dirty(server, conn);
+  else if(conn->close_after_flush)
+    close_connection(server, conn);
+  else
+    start_shm(server, conn);
+}
+
+// io_uring: the shared-memory wakeup eventfd polled readable.
+static void handle_shm_completion(Server *server, Connection *conn, const struct io_uring_cqe *cqe){
+  if(!(cqe->flags & IORING_CQE_F_MORE)){
+    conn->shm_armed = 0;
+    conn->uring_ops--;
+  }
+  if(conn->closed)
+    return;
+  if(conn->handoff_target != NULL){
+    finish_handoff(conn);
+    return;
+  }
+  server->moved = NULL;
+  handle_shm_wakeup(server, conn);
+  if(conn->closed || conn->handoff_target != NULL || conn->shm_armed)
+    return;
+  if(arm_shm_poll(server, conn) < 0)
+    handle_disconnect(server, conn);
+}
+
+static void handle_completion(Server *server, const struct io_uring_cqe *cqe){
+  int kind = (int)(cqe->user_data & URING_KIND_MASK);
+  Connection *conn = (Connection *)(uintptr_t)(cqe->user_data & ~URING_KIND_MASK);
+  switch(kind){
+    case URING_ACCEPT:
+    case URING_ACCEPT_LOCAL:
+      if(cqe->res >= 0){
+        if(kind == URING_ACCEPT_LOCAL)
+          LOG("Client connected on %s\n", unix_path);
+        adopt_socket(server, cqe->res, kind == URING_ACCEPT_LOCAL);
+      }
+      else if(cqe->res != -EINTR && cqe->res != -ECANCELED)
+        fprintf(stderr, "Accept failed: %s\n", strerror(-cqe->res));
+      if(!(cqe->flags & IORING_CQE_F_MORE))
+        arm_accept(server, kind);
+      break;
+    case URING_INBOX:
+      drain_inbox(server);
+      if(!(cqe->flags & IORING_CQE_F_MORE))
+        arm_inbox_poll(server);
+      break;
+    case URING_RECV:
+      handle_recv_completion(server, conn, cqe);
+      break;
+    case URING_SEND:
+    case URING_SENDMSG:
+      handle_send_completion(server, conn, kind, cqe->res);
+      break;
+    case URING_SHM:
+      handle_shm_completion(server, conn, cqe);
+      break;
+    default:
+      break; // URING_CANCEL: the cancelled receive completes on its own
+  }
+}
+
+// epoll: write what the socket takes now and wait for EPOLLOUT for the
+// rest. Returns -1 if that left the connection closed.
+static int flush_socket(Server *server, Connection *conn){
+  if(write_socket(server, conn) < 0){
+    if(conn->close_after_flush)
+      close_connection(server, conn);
+    else
+      handle_disconnect(server, conn);
+    return -1;
+  }
+  if(conn->close_after_flush && !has_pending_output(conn)){
+    close_connection(server, conn);
+    return -1;
+  }
+  if(has_pending_output(conn) != conn->want_write)
+    update_events(server, conn);
+  start_shm(server, conn);
+  return 0;
+}
+
+// Once per loop iteration, one write per connection with output: a
+// gathered sendmsg() on epoll, a submitted send on io_uring. A shot's
+// replies to both players and the next turn prompt thus leave together.
+// Connections handed off in the meantime are published instead.
+static void flush_dirty(Server *server){
+  while(server->dirty_list != NULL){
+    Connection *conn = server->dirty_list;
+    server->dirty_list = conn->next_dirty;
+    conn->dirty = 0;
+    if(conn->handoff_target != NULL)
+      finish_handoff(conn);
+    else if(server->uring != NULL)
+      start_send(server, conn);
+    else if(!conn->closed)
+      flush_socket(server, conn);
+  }
+}
+
+static void snapshot_paths(const Server *server, char *path, char *tmp_path, size_t len){
+  snprintf(path, len, "%s/snapshot-%d.bin", journal_dir, server->shard_idx);
+  snprintf(tmp_path, len, "%s/snapshot-%d.tmp", journal_dir, server->shard_idx);
+}
+
+// Dump every live game of the shard. Sticks to write(2)-level calls and no
+// allocation, so it is safe in the child of fork() even though other
+// threads of the parent may hold locks.
+static int write_snapshot(const Server *server, uint64_t journal_records, const char *path, const char *tmp_path){
+  SnapshotFile file;
+  if(snapshot_begin(&file, tmp_path) < 0)
+    return -1;
+  for(const Session *session = server->sessions; session != NULL; session = session->next){
+    SnapshotGame game;
+    memset(&game, 0, sizeof(game));
+    game.id = session->id;
+    game.phase = session->current_game_phase;
+    game.current_player_turn = session->current_player_turn;
+    game.players_ready_for_shooting = session->players_ready_for_shooting;
+    game.ai_slot = session->ai_slot;
+    game.config = session->config;
+    memcpy(game.boards, session->player_boards, sizeof(game.boards));
+    game.ai = session->ai;
+    memcpy(game.seen, session->seen, sizeof(game.seen));
+    snapshot_add(&file, &game);
+  }
+
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  header.num_shards = (uint32_t)num_shards;
+  header.shard_idx = (uint32_t)server->shard_idx;
+  header.next_session_id = (uint32_t)server->next_session_id;
+  header.resume_secret = resume_secret;
+  header.journal_records = journal_records;
+  strncpy(header.journal_path, journal_writer_path(server->journal), SNAPSHOT_PATH_LEN - 1);
+  return snapshot_commit(&file, &header, tmp_path, path);
+}
+
+// Fork and let the child write the games out while this loop carries on.
+// Copy-on-write freezes the child's view at this batch boundary, which is
+// exactly where the journal was just flushed.
+static void start_snapshot(Server *server){
+  if(server->snapshot_pid > 0)
+    return; // The previous one is still being written
+  journal_writer_flush(server->journal);
+  uint64_t records = journal_writer_records(server->journal);
+  char path[4096], tmp_path[4096];
+  snapshot_paths(server, path, tmp_path, sizeof(path));
+
+  pid_t pid = fork();
+  if(pid < 0){
+    perror("fork failed");
+    return;
+  }
+  if(pid == 0)
+    _exit(write_snapshot(server, records, path, tmp_path) == 0 ? 0 : 1);
+  server->snapshot_pid = pid;
+}
+
+static void reap_snapshot(Server *server){
+  if(server->snapshot_pid <= 0)
+    return;
+  int status;
+  pid_t done = waitpid(server->snapshot_pid, &status, WNOHANG);
+  if(done == 0)
+    return;
+  if(done < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+    fprintf(stderr, "Shard %d: writing snapshot failed\n", server->shard_idx);
+  server->snapshot_pid = 0;
+}
+
+// A game rebuilt during restore. Snapshot games are sorted by id and games
+// started in the journal tail have larger ids, so the array stays sorted.
+typedef struct {
+  int id;
+  Session *session; // NULL once the tail ended it
+} RestoredGame;
+
+typedef struct {
+  RestoredGame *games;
+  size_t count;
+  size_t cap;
+} RestoredGames;
+
+static int compare_restored(const void *a, const void *b){
+  int ia = ((const RestoredGame *)a)->id, ib = ((const RestoredGame *)b)->id;
+  return (ia > ib) - (ia < ib);
+}
+
+static void add_restored(RestoredGames *restored, Session *session){
+  if(restored->count == restored->cap){
+    restored->cap = restored->cap ? restored->cap * 2 : 64;
+    restored->games = realloc(restored->games, restored->cap * sizeof(RestoredGame));
+    if(restored->games == NULL){
+      perror("realloc failed");
+      exit(EXIT_FAILURE);
+    }
+  }
+  restored->games[restored->count].id = session->id;
+  restored->games[restored->count].session = session;
+  restored->count++;
+}
+
+static Session *restore_new_session(Server *server, int id){
+  GameConfig classic;
+  game_config_classic(&classic);
+  Session *session = new_session(server, id, &classic);
+  if(session == NULL){
+    fprintf(stderr, "Shard %d: session pool exhausted\n", server->shard_idx);
+    exit(EXIT_FAILURE);
+  }
+  int n = (id - server->shard_idx - 1) / num_shards;
+  if(n >= server->next_session_id)
+    server->next_session_id = n + 1;
+  return session;
+}
+
+static void apply_tail_record(Server *server, RestoredGames *restored, const JournalRecord *rec){
+  if(rec->type == JOURNAL_GAME_START){
+    Session *session = restore_new_session(server, (int)rec->session_id);
+    session->config.salvo = (rec->flags & JOURNAL_FLAG_SALVO) != 0;
+    if(rec->player < MAX_CLIENT){
+      session->ai_slot = rec->player;
+      ai_init(&session->ai, (uint64_t)time(NULL) ^ ((uint64_t)session->id << 32));
+    }
+    add_restored(restored, session);
+    return;
+  }
+
+  RestoredGame key = { .id = (int)rec->session_id };
+  RestoredGame *game = bsearch(&key, restored->games, restored->count, sizeof(RestoredGame), compare_restored);
+  if(game == NULL || game->session == NULL)
+    return;
+  Session *session = game->session;
+  if(rec->type == JOURNAL_GAME_END){
+    end_session(server, session);
+    game->session = NULL;
+    return;
+  }
+  if(rec->type == JOURNAL_BOARD){
+    session->config.rows = rec->row;
+    session->config.cols = rec->col;
+    session->config.num_ships = rec->ship_type;
+    return;
+  }
+  if(rec->type == JOURNAL_FLEET){
+    if(rec->ship_type < 0 || rec->ship_type >= session->config.num_ships || rec->ship_type >= MAX_FLEET)
+      return;
+    session->config.ship_sizes[rec->ship_type] = rec->row;
+    if(rec->ship_type == session->config.num_ships - 1 && game_config_valid(&session->config)){
+      // Fleet complete: the boards were set up classic, start them over
+      for(int i = 0; i < MAX_CLIENT; i++){
+        game_board_free(&session->player_boards[i]);
+        game_board_init(&session->player_boards[i], &session->config);
+        use_session_arena(session, &session->player_boards[i]);
+      }
+    }
+    return;
+  }
+  if(rec->player >= MAX_CLIENT)
+    return;
+  switch(rec->type){
+    case JOURNAL_PLACEMENT:
+      game_board_place(&session->player_boards[rec->player], rec->ship_type, rec->row, rec->col, (Orientation)rec->orientation);
+      sync_placement_progress(session);
+      break;
+    case JOURNAL_SHOT: {
+      int is_hit, is_sunk, sunk_ship;
+      game_board_shoot(&session->player_boards[1 - rec->player], rec->row, rec->col, &is_hit, &is_sunk, &sunk_ship);
+      if(rec->player == session->ai_slot)
+        ai_observe(&session->ai, rec->row, rec->col, is_hit, (ShipType)sunk_ship);
+      else if(!session->player_boards[1 - rec->player].sparse)
+        observe_shot(&session->seen[rec->player], rec->row, rec->col, is_hit, (ShipType)sunk_ship);
+      session->current_player_turn = 1 - rec->player;
+      break;
+    }
+  }
+}
+
+// Replay the part of the journal written after the snapshot was taken.
+static uint64_t replay_journal_tail(Server *server, const char *path, uint64_t skip, RestoredGames *restored){
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if(fd < 0){
+    perror(path);
+    return 0;
+  }
+  struct stat st;
+  if(fstat(fd, &st) < 0 || (size_t)st.st_size < JOURNAL_HEADER_LEN){
+    close(fd);
+    return 0;
+  }
+  size_t size = (size_t)st.st_size;
+  const uint8_t *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(data == MAP_FAILED){
+    perror(path);
+    return 0;
+  }
+  uint64_t replayed = 0;
+  if(journal_decode_header(data, size, NULL) == 0){
+    size_t records = (size - JOURNAL_HEADER_LEN) / JOURNAL_RECORD_LEN;
+    for(size_t i = skip; i < records; i++, replayed++){
+      JournalRecord rec;
+      journal_decode_record(data + JOURNAL_HEADER_LEN + i * JOURNAL_RECORD_LEN, &rec);
+      apply_tail_record(server, restored, &rec);
+    }
+  }
+  munmap((void *)data, size);
+  return replayed;
+}
+
+// Bring back the games a previous server left behind: the shard's last
+// snapshot plus its journal tail. Players rejoin with their resume tokens.
+static void restore_shard(Server *server){
+  char path[4096], tmp_path[4096];
+  snapshot_paths(server, path, tmp_path, sizeof(path));
+  SnapshotHeader header;
+  SnapshotGame *saved;
+  int count = snapshot_load(path, &header, &saved);
+  if(count < 0)
+    return;
+  if(header.num_shards != (uint32_t)num_shards || header.shard_idx != (uint32_t)server->shard_idx){
+    fprintf(stderr, "%s: written by a server with %u shards, ignoring\n", path, header.num_shards);
+    for(int i = 0; i < count; i++)
+      for(int p = 0; p < MAX_CLIENT; p++)
+        game_board_free(&saved[i].boards[p]);
+    free(saved);
+    return;
+  }
+
+  uint64_t start = now_ns();
+  resume_secret = header.resume_secret;
+  server->next_session_id = (int)header.next_session_id;
+  RestoredGames restored = {0};
+  for(int i = 0; i < count; i++){
+    const SnapshotGame *game = &saved[i];
+    Session *session = restore_new_session(server, game->id);
+    session->current_game_phase = (GamePhase)game->phase;
+    session->current_player_turn = game->current_player_turn;
+    session->players_ready_for_shooting = game->players_ready_for_shooting;
+    session->ai_slot = game->ai_slot;
+    session->config = game->config;
+    memcpy(session->player_boards, game->boards, sizeof(session->player_boards)); // snapshot_load rebuilt any sparse tables
+    session->ai = game->ai;
+    memcpy(session->seen, game->seen, sizeof(session->seen));
+    add_restored(&restored, session);
+  }
+  free(saved);
+  qsort(restored.games, restored.count, sizeof(RestoredGame), compare_restored);
+
+  uint64_t replayed = replay_journal_tail(server, header.journal_path, header.journal_records, &restored);
+  free(restored.games);
+  printf("Shard %d: restored %d games from snapshot and %llu journal records in %.2f ms\n", server->shard_idx,
+         server->active_sessions, (unsigned long long)replayed, (double)(now_ns() - start) / 1e6);
+}
+
+// Listening socket for one shard. With several shards every socket binds
+// the same port with SO_REUSEPORT and the kernel spreads connects over them.
+static int open_listener(void){
+  int listen_sock = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if(listen_sock < 0){
     perror("Socket creation failed.\n");
     exit(EXIT_FAILURE);
   }
@@ -36,232 +2566,399 @@ int main(){
     close(listen_sock);
     exit(EXIT_FAILURE);
   }
+  if(num_shards > 1 && setsockopt(listen_sock, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)) < 0){
+    perror("setsockopt SO_REUSEPORT failed");
+    close(listen_sock);
+    exit(EXIT_FAILURE);
+  }
 
   // Prepare sockaddr_in structure
+  struct sockaddr_in server_addr;
+  memset(&server_addr, 0, sizeof(server_addr));
   server_addr.sin_family = AF_INET;
   server_addr.sin_addr.s_addr = INADDR_ANY; // Listen on all available interfaces
   server_addr.sin_port = htons(PORT);     // Host to network short
-  
+
   if(bind(listen_sock, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0){
     perror("Bind failed");
     close(listen_sock);
     exit(EXIT_FAILURE);
   }
 
-  if (listen(listen_sock, MAX_CLIENT) < 0) {
+  if (listen(listen_sock, SOMAXCONN) < 0) {
     perror("Listen failed");
     close(listen_sock);
     exit(EXIT_FAILURE);
   }
+  return listen_sock;
+}
 
-  printf("Server listening on port %d", PORT);
-
-  // Accept connections from 2 clients
-  for(int i = 0; i < MAX_CLIENT; i++){
-    printf("Waiting for client %d ...", i);
-    client_sock[i] = accept(listen_sock, (struct sockaddr*)&client_addr, &client_len);
-    if(client_sock[i] < 0){
-      perror("Accept failed");
-      close(listen_sock);
-      exit(EXIT_FAILURE);
-    }
-    printf("Player %d connected from %s:%d\n", i+1, inet_ntoa(client_addr.sin_addr), ntohs(client_addr.sin_port));
+// Listener for clients on this host (-u). Only shard 0 has one: Unix
+// sockets have no SO_REUSEPORT spreading, and lone players end up on
+// shard 0 anyway.
+static int open_unix_listener(void){
+  struct sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if(strlen(unix_path) >= sizeof(addr.sun_path)){
+    fprintf(stderr, "Unix socket path too long: %s\n", unix_path);
+    exit(EXIT_FAILURE);
+  }
+  strcpy(addr.sun_path, unix_path);
 
-    init_board(&player_boards[i]);
+  int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if(sock < 0){
+    perror("Socket creation failed");
+    exit(EXIT_FAILURE);
+  }
+  unlink(unix_path); // Left over from a previous run
+  if(bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0){
+    perror("Bind failed");
+    close(sock);
+    exit(EXIT_FAILURE);
+  }
+  if(listen(sock, SOMAXCONN) < 0){
+    perror("Listen failed");
+    close(sock);
+    exit(EXIT_FAILURE);
+  }
+  return sock;
+}
 
-    GameMessage msg;
+static void setup_shard(Server *server, int shard_idx){
+  memset(server, 0, sizeof(*server));
+  server->shard_idx = shard_idx;
+  atomic_init(&server->inbox, NULL);
+  timer_wheel_init(&server->timers, now_ms());
+  pool_init(&server->session_pool, sizeof(Session), POOL_SLAB_OBJECTS);
+  pool_init(&server->conn_pool, sizeof(Connection), POOL_SLAB_OBJECTS);
+  pool_init(&server->frame_pool, sizeof(SharedFrame) + PROTO_MAX_FRAME, FRAME_SLAB_OBJECTS);
+  pool_init(&server->chunk_pool, ARENA_CHUNK, POOL_SLAB_OBJECTS);
+  pool_init(&server->buf_pool, OUT_BUF_SIZE, POOL_SLAB_OBJECTS);
+  if(session_index_grow(server) < 0){
+    perror("calloc failed");
+    exit(EXIT_FAILURE);
+  }
+  server->listen_sock = open_listener();
+  server->unix_sock = (unix_path != NULL && shard_idx == 0) ? open_unix_listener() : -1;
 
-    msg.type = MSG_TYPE_TEST;
-    sprintf(msg.message, "Welcome Player %d", i + 1);
-    send(client_sock[i], &msg, sizeof(msg), 0);
+  server->epoll_fd = epoll_create1(0);
+  if(server->epoll_fd < 0){
+    perror("epoll_create1 failed");
+    exit(EXIT_FAILURE);
+  }
+  server->event_fd = eventfd(0, EFD_NONBLOCK);
+  if(server->event_fd < 0){
+    perror("eventfd failed");
+    exit(EXIT_FAILURE);
   }
 
-  printf("Both players connected.\n");
+  // The listening socket is registered with a NULL pointer and the eventfd
+  // with the inbox address so both can be told apart from client connections.
+  struct epoll_event ev;
+  ev.events = EPOLLIN;
+  ev.data.ptr = NULL;
+  if(epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_sock, &ev) < 0){
+    perror("epoll_ctl failed");
+    exit(EXIT_FAILURE);
+  }
+  ev.data.ptr = &server->inbox;
+  if(epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->event_fd, &ev) < 0){
+    perror("epoll_ctl failed");
+    exit(EXIT_FAILURE);
+  }
+  ev.data.ptr = &server->unix_sock;
+  if(server->unix_sock >= 0 && epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->unix_sock, &ev) < 0){
+    perror("epoll_ctl failed");
+    exit(EXIT_FAILURE);
+  }
 
-  GameMessage recieved_msg;
-  ssize_t bytes_recieved;
+  if(journal_dir != NULL){
+    // Restore before opening a new journal: it may reuse the old file name
+    if(snapshot_interval > 0)
+      restore_shard(server);
 
-  while(current_game_phase != GAME_PHASE_GAMEOVER){
-    int current_socket = client_sock[current_player_turn];
-    int opponent_socket = client_sock[(current_player_turn == 1)? 0 : 1];
-    PlayerBoard *current_player_board = &player_boards[current_player_turn];
-    PlayerBoard *opponent_player_board = &player_boards[(current_player_turn == 1)? 0 : 1];
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/journal-%ld-%d.bin", journal_dir, (long)time(NULL), shard_idx);
+    server->journal = journal_writer_open(path);
+    if(server->journal == NULL){
+      perror("Opening journal failed");
+      exit(EXIT_FAILURE);
+    }
 
-    // Placement Phase
-    if(current_game_phase == GAME_PHASE_PLACEMENT){
-      int all_ships_placed_for_current_player = 1;
-      for(int i = 0 ; i < NUM_SHIPS; i++){
-        if(!current_player_board->ships[i].is_placed){
-          all_ships_placed_for_current_player = 0;
-          break;
-        }
-      }
-      if(all_ships_placed_for_current_player){
-        players_ready_for_shooting++;
-        printf("Player %d finished placing ships. Total Ready : %d", current_player_turn + 1, players_ready_for_shooting);
-
-        if(players_ready_for_shooting == MAX_CLIENT){
-          current_game_phase = GAME_PHASE_SHOOTING;
-          printf("All players placed ships. Transitioning to shooting phase.\n");
-          current_player_turn = 0;
-
-          GameMessage game_start_msg;
-          game_start_msg.type = MSG_TYPE_TEST;
-          sprintf(game_start_msg.message, "All ships placed! Game starting!");
-          send(client_sock[0], &game_start_msg, sizeof(game_start_msg), 0);
-          send(client_sock[1], &game_start_msg, sizeof(game_start_msg), 0);
-
-          continue;
-        }
-        else{
-          current_player_turn = (current_player_turn == 1)? 0 : 1;
-          printf("Switching to Player %d for placement.\n", current_player_turn + 1);
-          continue;
-        }
-      }
-      
-      // Placing Prompts
-
-      // Find the first ship to be placed
-      ShipType ship_to_place_type = -1;
-      int ship_size_to_place = 0;
-      for(int i = 0 ; i < NUM_SHIPS; i++){
-        if(!current_player_board->ships[i].is_placed){
-          ship_to_place_type = current_player_board->ships[i].type;
-          ship_size_to_place = current_player_board->ships[i].size;
-          break; // Found the next ship to place
-        }
-      }
+    // Anchor the restored games to the new journal right away
+    if(snapshot_interval > 0){
+      char snapshot_path[4096], tmp_path[4096];
+      snapshot_paths(server, snapshot_path, tmp_path, sizeof(snapshot_path));
+      if(write_snapshot(server, 0, snapshot_path, tmp_path) < 0)
+        perror("Writing snapshot failed");
+    }
+    // A crash between a human's shot and the computer's reply leaves the
+    // computer to move; nothing else would wake it up. Humans get a fresh
+    // clock to come back and move.
+    for(Session *session = server->sessions, *next; session != NULL; session = next){
+      next = session->next;
+      if(session->current_game_phase == GAME_PHASE_SHOOTING && session->current_player_turn == session->ai_slot)
+        play_ai_turn(server, session);
+      else
+        arm_deadline(server, session);
+    }
+  }
+}
 
-      if (ship_to_place_type != -1) {
-        GameMessage placement_prompt_msg;
-        placement_prompt_msg.type = MSG_TYPE_PLACE_SHIP_PROMPT;
-        placement_prompt_msg.ship_type = ship_to_place_type;
-        sprintf(placement_prompt_msg.message, "Place your %s (size %d).", (ship_to_place_type == CARRIER) ? "Carrier" :(ship_to_place_type == BATTLESHIP) ? "Battleship" : (ship_to_place_type == CRUISER) ? "Cruiser" : (ship_to_place_type == SUBMARINE) ? "Submarine" : "Destroyer", ship_size_to_place);
-        send(current_socket, &placement_prompt_msg, sizeof(placement_prompt_msg), 0);
-        printf("Sent placement prompt for %s (Player %d).\n", placement_prompt_msg.message, current_player_turn + 1);
-
-        // Wait for response
-        bytes_recieved = recv(current_socket, &recieved_msg, sizeof(recieved_msg), 0);
-        if (bytes_recieved <= 0) {
-          printf("Player %d disconnected during placement or error.\n", current_player_turn + 1);
-          current_game_phase = GAME_PHASE_GAMEOVER; // End game if a player disconnects
-          continue;
-        }
-
-        if (recieved_msg.type == MSG_TYPE_PLACEMENT_REQ) {
-          Ship new_ship_placement = {
-            .type = recieved_msg.ship_type,
-            .row = recieved_msg.row,
-            .col = recieved_msg.col,
-            .orientation = recieved_msg.orientation,
-            .size = get_ship_size(recieved_msg.ship_type), // Get size based on type
-            .hits = 0, // Freshly placed
-            .is_placed = 0 // Will be set to 1 by place_ship if successful
-          };
-          GameMessage placement_response_msg;
-          placement_response_msg.type = MSG_TYPE_PLACEMENT_RES;
-          placement_response_msg.row = recieved_msg.row;
-          placement_response_msg.col = recieved_msg.col;
-          placement_response_msg.ship_type = recieved_msg.ship_type;
-          placement_response_msg.orientation = recieved_msg.orientation;
-
-
-          // Validate placement
-          if (can_place_ship(current_player_board, &new_ship_placement)) {
-            // Place ship on server's internal board
-            place_ship(current_player_board, &new_ship_placement); // This function will find and update the correct ship instance
-            placement_response_msg.success = 1; // Success
-            sprintf(placement_response_msg.message, "Ship placed successfully!");
-            printf("Player %d placed %s at (%d,%d) %s.\n", current_player_turn + 1, (recieved_msg.ship_type == CARRIER) ? "Carrier": (recieved_msg.ship_type == BATTLESHIP) ? "Battleship" : (recieved_msg.ship_type == CRUISER) ? "Cruiser" : (recieved_msg.ship_type == SUBMARINE) ? "Submarine" : "Destroyer", recieved_msg.row, recieved_msg.col, (recieved_msg.orientation == HORIZONTAL) ? "Horizontal" : "Vertical");
-          }
-          else{
-            placement_response_msg.success = 0; // Failure
-            sprintf(placement_response_msg.message, "Invalid placement. Try again.");
-            printf("Player %d tried invalid placement for %s.\n", current_player_turn + 1, (recieved_msg.ship_type == CARRIER) ? "Carrier" : (recieved_msg.ship_type == BATTLESHIP) ? "Battleship" : (recieved_msg.ship_type == CRUISER) ? "Cruiser" : (recieved_msg.ship_type == SUBMARINE) ? "Submarine" : "Destroyer");
-          }
-          send(current_socket, &placement_response_msg, sizeof(placement_response_msg), 0);
-
-          // If placement failed, stay on the same player and prompt for the same ship again.
-          // If successful, the loop will naturally move to the next unplaced ship for this player,
-          // or switch players/phase as handled above.
-        } 
-        else {
-          printf("Player %d sent unexpected message type %d during placement.\n", current_player_turn + 1, recieved_msg.type); // Could send an error message back, or simply ignore and re-prompt.
-        }
+// Handle one epoll_wait worth of events. Returns -1 if waiting failed.
+static int poll_epoll(Server *server, struct epoll_event *events, int timeout_ms){
+  int n = epoll_wait(server->epoll_fd, events, MAX_EVENTS, timeout_ms);
+  metric_add(&server->metrics.io_syscalls, 1);
+  if(n < 0){
+    if(errno == EINTR)
+      return 0;
+    perror("epoll_wait failed");
+    return -1;
+  }
+  for(int i = 0; i < n; i++){
+    void *tag = events[i].data.ptr;
+    if(tag == NULL){
+      handle_accept(server, server->listen_sock, 0);
+      continue;
+    }
+    if(tag == (void *)&server->unix_sock){
+      handle_accept(server, server->unix_sock, 1);
+      continue;
+    }
+    if((uintptr_t)tag & 1){
+      Connection *conn = (Connection *)((uintptr_t)tag & ~(uintptr_t)1);
+      if(!conn->closed){
+        server->moved = NULL;
+        handle_shm_wakeup(server, conn);
       }
+      continue;
     }
-    else if(current_game_phase == GAME_PHASE_SHOOTING){
-      GameMessage turn_msg;
-      turn_msg.type = MSG_TYPE_TURN_IND;
-      sprintf(turn_msg.message, "It's your turn.");
-      send(current_socket, &turn_msg, sizeof(turn_msg), 0);
-      printf("Sent turn message to Player %d\n", current_player_turn + 1);
-      // Wait for current player's action (e.g., a shot)
-      bytes_recieved = recv(current_socket, &recieved_msg, sizeof(recieved_msg), 0);
-      if (bytes_recieved <= 0) {
-        printf("Player %d disconnected or error.\n", current_player_turn + 1);
-        current_game_phase = GAME_PHASE_GAMEOVER; // End game if a player disconnects
+    if(tag == (void *)&server->inbox){
+      drain_inbox(server);
+      continue;
+    }
+    Connection *conn = tag;
+    if(conn->closed)
+      continue;
+    if((events[i].events & EPOLLOUT) && flush_socket(server, conn) < 0)
+      continue;
+    if(events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)){
+      if(conn->close_after_flush){
+        if(events[i].events & (EPOLLERR | EPOLLHUP))
+          close_connection(server, conn);
         continue;
       }
-      printf("Player %d sent message (Type: %d, Data: %s)\n", current_player_turn + 1, recieved_msg.type, recieved_msg.message);
-      if(recieved_msg.type == MSG_TYPE_SHOT_REQ){
-        int target_player_idx = (current_player_turn == 0) ? 1 : 0; // Other player
-        int is_hit_flag, is_sunk_flag;
-        int result_of_shot = take_shot(&player_boards[target_player_idx], recieved_msg.row, recieved_msg.col, &is_hit_flag, &is_sunk_flag);
-
-        GameMessage shot_result_msg_to_shooter;
-        shot_result_msg_to_shooter.type = MSG_TYPE_SHOT_RES;
-        shot_result_msg_to_shooter.row = recieved_msg.row;
-        shot_result_msg_to_shooter.col = recieved_msg.col;
-
-        GameMessage shot_result_msg_to_target; // To inform the target player
-        shot_result_msg_to_target.type = MSG_TYPE_SHOT_RES;
-        shot_result_msg_to_target.row = recieved_msg.row;
-        shot_result_msg_to_target.col = recieved_msg.col;
-
-        if (is_hit_flag) {
-          if (is_sunk_flag) {
-            sprintf(shot_result_msg_to_shooter.message, "HIT and SUNK! Your shot at (%d,%d) sunk a ship.", recieved_msg.row, recieved_msg.col);
-            sprintf(shot_result_msg_to_target.message, "Your ship at (%d,%d) was HIT and SUNK!", recieved_msg.row, recieved_msg.col);
-            printf("Player %d hit and sunk a ship on Player %d's board at (%d,%d)\n", current_player_turn + 1, target_player_idx + 1, recieved_msg.row, recieved_msg.col);
-          } 
-          else {
-            sprintf(shot_result_msg_to_shooter.message, "HIT! Your shot at (%d,%d) hit a ship.", recieved_msg.row, recieved_msg.col);
-            sprintf(shot_result_msg_to_target.message, "Your ship at (%d,%d) was HIT!", recieved_msg.row, recieved_msg.col);
-            printf("Player %d hit Player %d's board at (%d,%d)\n", current_player_turn + 1, target_player_idx + 1, recieved_msg.row, recieved_msg.col);
-          }
-        }
-        else{
-          sprintf(shot_result_msg_to_shooter.message, "MISS. Your shot at (%d,%d) hit water.", recieved_msg.row, recieved_msg.col);
-          sprintf(shot_result_msg_to_target.message, "Opponent MISSED your board at (%d,%d).", recieved_msg.row, recieved_msg.col);
-          printf("Player %d missed Player %d's board at (%d,%d)\n", current_player_turn + 1, target_player_idx + 1, recieved_msg.row, recieved_msg.col);
-        }
-        send(current_socket, &shot_result_msg_to_shooter, sizeof(shot_result_msg_to_shooter), 0);
-        send(opponent_socket, &shot_result_msg_to_target, sizeof(shot_result_msg_to_target), 0);
-        if(check_game_over(&player_boards[target_player_idx])){
-          GameMessage game_over_msg;
-          game_over_msg.type = MSG_TYPE_GAME_OVER;
-          sprintf(game_over_msg.message, "GAME OVER! Player %d wins!", current_player_turn + 1);
-          send(current_socket, &game_over_msg, sizeof(game_over_msg), 0); // Winner
-          sprintf(game_over_msg.message, "GAME OVER! Player %d loses! Player %d wins!", target_player_idx + 1, current_player_turn + 1);
-          send(opponent_socket, &game_over_msg, sizeof(game_over_msg), 0); // Loser
-          printf("Game Over! Player %d wins.\n", current_player_turn + 1);
-          current_game_phase = GAME_PHASE_GAMEOVER; // Set phase to exit loop
-        }
-        else{
-          current_player_turn = (current_player_turn == 0) ? 1 : 0; // swtich turns
-        }
-      }
-      else{
-        printf("Player %d sent unexpected message type %d during shooting phase.\n", current_player_turn + 1, recieved_msg.type);
-        // Could send a message back or something.
+      if(handle_readable(server, conn) < 0)
+        handle_disconnect(server, conn);
+    }
+  }
+  return 0;
+}
+
+// Submit everything the last iteration queued and wait for completions in
+// a single io_uring_enter, then handle them all. Returns -1 if it failed.
+static int poll_uring(Server *server, int timeout_ms){
+  Uring *ring = server->uring;
+  uint64_t enters = ring->enters;
+  int rc = uring_submit_and_wait(ring, timeout_ms);
+  if(rc < 0)
+    perror("io_uring_enter failed");
+  struct io_uring_cqe *cqe;
+  while(rc == 0 && (cqe = uring_peek_cqe(ring)) != NULL){
+    struct io_uring_cqe done = *cqe; // Handlers may queue requests, which can enter the kernel
+    uring_cqe_seen(ring);
+    handle_completion(server, &done);
+  }
+  metric_add(&server->metrics.io_syscalls, ring->enters - enters);
+  return rc;
+}
+
+// -U: move the shard onto io_uring. A single-issuer ring belongs to the
+// thread that creates it, so this runs on the shard's own thread. Kernels
+// that cannot run it leave the shard on epoll.
+static void start_uring(Server *server){
+  Uring *ring = malloc(sizeof(*ring));
+  if(ring == NULL || uring_init(ring, URING_ENTRIES, URING_BUFS, URING_BUF_SIZE) < 0){
+    if(server->shard_idx == 0)
+      fprintf(stderr, "io_uring unavailable (%s), staying on epoll\n", strerror(errno));
+    free(ring);
+    return;
+  }
+  server->uring = ring;
+  // The listener and eventfd stay in the epoll set, which is just never waited on
+  arm_accept(server, URING_ACCEPT);
+  if(server->unix_sock >= 0)
+    arm_accept(server, URING_ACCEPT_LOCAL);
+  arm_inbox_poll(server);
+  if(server->shard_idx == 0)
+    printf("Shards run on io_uring\n");
+}
+
+static void *run_shard(void *arg){
+  Server *server = arg;
+
+  if(num_shards > 1){
+    // One loop per core: keep the thread where its caches are warm
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(server->shard_idx % CPU_SETSIZE, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+  }
+
+  if(use_uring)
+    start_uring(server);
+
+  struct epoll_event events[MAX_EVENTS];
+  uint64_t stats_period_ns = (uint64_t)stats_interval * 1000000000ull;
+  uint64_t next_stats_ns = now_ns() + stats_period_ns;
+  int snapshots = (server->journal != NULL && snapshot_interval > 0);
+  uint64_t snapshot_period_ns = (uint64_t)snapshot_interval * 1000000000ull;
+  uint64_t next_snapshot_ns = now_ns() + snapshot_period_ns;
+  for(;;){
+    uint64_t now = now_ns();
+    int timeout_ms = handoff_timeout_ms(server, now);
+    if(stats_interval > 0){
+      int stats_ms = (next_stats_ns > now) ? (int)((next_stats_ns - now + 999999) / 1000000) : 0;
+      if(timeout_ms < 0 || stats_ms < timeout_ms)
+        timeout_ms = stats_ms;
+    }
+    if(snapshots){
+      // While a child is writing, wake up now and then to reap it
+      uint64_t due = server->snapshot_pid > 0 ? now + 10000000ull : next_snapshot_ns;
+      int snapshot_ms = (due > now) ? (int)((due - now + 999999) / 1000000) : 0;
+      if(timeout_ms < 0 || snapshot_ms < timeout_ms)
+        timeout_ms = snapshot_ms;
+    }
+    int timer_ms = timer_wheel_timeout_ms(&server->timers, now / 1000000ull);
+    if(timer_ms >= 0 && (timeout_ms < 0 || timer_ms < timeout_ms))
+      timeout_ms = timer_ms;
+    int rc = (server->uring != NULL) ? poll_uring(server, timeout_ms) : poll_epoll(server, events, timeout_ms);
+    if(rc < 0)
+      break;
+    expire_timers(server);
+    deliver_hints(server);
+    // Pair after the whole batch so a burst of connects is matched in one go
+    match_waiting(server);
+    flush_dirty(server);
+    release_closed_connections(server);
+    if(server->journal != NULL)
+      journal_writer_flush(server->journal);
+    metric_set(&server->metrics.active_games, server->active_sessions);
+    metric_set(&server->metrics.lobby_waiting, server->lobby.depth);
+    metric_set(&server->metrics.spectators, server->spectators);
+    publish_pool_stats(server);
+    if(num_shards > 1)
+      hand_off_stale_waiters(server);
+
+    if(stats_interval > 0 && now_ns() >= next_stats_ns){
+      print_lobby_stats(server, stats_interval);
+      next_stats_ns += stats_period_ns;
+    }
+    if(snapshots){
+      reap_snapshot(server);
+      if(now_ns() >= next_snapshot_ns){
+        start_snapshot(server);
+        next_snapshot_ns = now_ns() + snapshot_period_ns;
       }
     }
   }
-  close(client_sock[0]);
-  close(client_sock[1]);
-  close(listen_sock);
+
+  journal_writer_close(server->journal);
+  if(server->uring != NULL){
+    uring_exit(server->uring);
+    free(server->uring);
+  }
+  close(server->event_fd);
+  close(server->epoll_fd);
+  close(server->listen_sock);
+  if(server->unix_sock >= 0){
+    close(server->unix_sock);
+    unlink(unix_path);
+  }
+  return NULL;
+}
+
+int main(int argc, char *argv[]){
+  int opt;
+  while((opt = getopt(argc, argv, "qar:t:j:S:m:T:P:I:Uu:H:")) != -1){
+    switch(opt){
+      case 'q': quiet = 1; break;
+      case 'a': ai_opponents = 1; break;
+      case 'r': stats_interval = atoi(optarg); break;
+      case 't': num_shards = atoi(optarg); break;
+      case 'j': journal_dir = optarg; break;
+      case 'S': snapshot_interval = atoi(optarg); break;
+      case 'm': metrics_path = optarg; break;
+      case 'T': turn_timeout = atoi(optarg); break;
+      case 'P': placement_timeout = atoi(optarg); break;
+      case 'I': idle_timeout = atoi(optarg); break;
+      case 'U': use_uring = 1; break;
+      case 'u': unix_path = optarg; break;
+      case 'H': hint_budget_ms = atoi(optarg); break;
+      default:
+        fprintf(stderr, "Usage: %s [-q] [-a] [-r stats_seconds] [-t threads, 0 = one per core] [-j journal_dir [-S snapshot_seconds]] [-m metrics_socket] [-T turn_seconds] [-P placement_seconds] [-I idle_seconds] [-U] [-u unix_socket] [-H hint_ms]\n", argv[0]);
+        exit(EXIT_FAILURE);
+    }
+  }
+  if(num_shards <= 0){
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    num_shards = (cores > 0) ? (int)cores : 1;
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+
+  if(getrandom(&resume_secret, sizeof(resume_secret), 0) != (ssize_t)sizeof(resume_secret))
+    resume_secret = (uint64_t)time(NULL) ^ ((uint64_t)getpid() << 32);
+
+  shards = calloc(num_shards, sizeof(*shards));
+  if(shards == NULL){
+    perror("calloc failed");
+    exit(EXIT_FAILURE);
+  }
+  for(int i = 0; i < num_shards; i++)
+    setup_shard(&shards[i], i);
+
+  if(metrics_path != NULL){
+    Metrics **sources = calloc(num_shards, sizeof(*sources));
+    if(sources == NULL){
+      perror("calloc failed");
+      exit(EXIT_FAILURE);
+    }
+    for(int i = 0; i < num_shards; i++)
+      sources[i] = &shards[i].metrics;
+    if(metrics_serve(metrics_path, sources, num_shards) < 0){
+      perror("Metrics socket failed");
+      exit(EXIT_FAILURE);
+    }
+    printf("Metrics on unix:%s\n", metrics_path);
+  }
+
+  printf("Server listening on port %d (%d shard%s)\n", PORT, num_shards, num_shards == 1 ? "" : "s");
+  if(unix_path != NULL)
+    printf("Local clients on unix:%s\n", unix_path);
+
+  // Shard 0 runs on the main thread
+  for(int i = 1; i < num_shards; i++){
+    if(pthread_create(&shards[i].thread, NULL, run_shard, &shards[i]) != 0){
+      perror("pthread_create failed");
+      exit(EXIT_FAILURE);
+    }
+  }
+  run_shard(&shards[0]);
+  for(int i = 1; i < num_shards; i++)
+    pthread_join(shards[i].thread, NULL);
+  // Only now: pooled objects may have been freed across shards
+  for(int i = 0; i < num_shards; i++){
+    pool_destroy(&shards[i].session_pool);
+    pool_destroy(&shards[i].conn_pool);
+    pool_destroy(&shards[i].frame_pool);
+    pool_destroy(&shards[i].chunk_pool);
+    pool_destroy(&shards[i].buf_pool);
+    hint_worker_stop(shards[i].hints);
+    free(shards[i].by_id);
+  }
+  free(shards);
 
   printf("Server Shutting Down.\n");
   return 0;
@@ -0,0 +1,129 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "snapshot.h"
+
+static void file_write(SnapshotFile *file, const void *data, size_t len){
+  const unsigned char *p = data;
+  while(len > 0 && !file->failed){
+    ssize_t n = write(file->fd, p, len);
+    if(n < 0){
+      if(errno == EINTR)
+        continue;
+      file->failed = 1;
+      return;
+    }
+    p += n;
+    len -= (size_t)n;
+  }
+}
+
+static void file_flush(SnapshotFile *file){
+  file_write(file, file->buf, file->len);
+  file->len = 0;
+}
+
+int snapshot_begin(SnapshotFile *file, const char *tmp_path){
+  file->fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if(file->fd < 0)
+    return -1;
+  file->failed = 0;
+  file->len = 0;
+  file->game_count = 0;
+  // Room for the header, which is only known at the end
+  SnapshotHeader blank;
+  memset(&blank, 0, sizeof(blank));
+  file_write(file, &blank, sizeof(blank));
+  return file->failed ? -1 : 0;
+}
+
+static void file_put(SnapshotFile *file, const void *data, size_t len){
+  if(file->len + len > sizeof(file->buf))
+    file_flush(file);
+  memcpy(file->buf + file->len, data, len);
+  file->len += len;
+}
+
+void snapshot_add(SnapshotFile *file, const SnapshotGame *game){
+  file_put(file, game, sizeof(*game));
+  for(int p = 0; p < 2; p++){
+    const GameBoard *board = &game->boards[p];
+    if(!board->sparse)
+      continue;
+    for(uint32_t i = 0; i < board->big.cap; i++)
+      if(board->big.cells[i].cell != SPARSE_NO_CELL)
+        file_put(file, &board->big.cells[i], sizeof(SparseCell));
+  }
+  file->game_count++;
+}
+
+int snapshot_commit(SnapshotFile *file, SnapshotHeader *header, const char *tmp_path, const char *path){
+  file_flush(file);
+  memcpy(header->magic, SNAPSHOT_MAGIC, 4);
+  header->version = SNAPSHOT_VERSION;
+  header->board_size = sizeof(GameBoard);
+  header->ai_size = sizeof(AiPlayer);
+  header->game_count = file->game_count;
+  if(!file->failed && pwrite(file->fd, header, sizeof(*header), 0) != (ssize_t)sizeof(*header))
+    file->failed = 1;
+  if(!file->failed && fsync(file->fd) < 0)
+    file->failed = 1;
+  close(file->fd);
+  if(file->failed || rename(tmp_path, path) < 0){
+    unlink(tmp_path);
+    return -1;
+  }
+  return 0;
+}
+
+int snapshot_load(const char *path, SnapshotHeader *header, SnapshotGame **games){
+  FILE *fp = fopen(path, "rb");
+  if(fp == NULL)
+    return -1;
+  if(fread(header, sizeof(*header), 1, fp) != 1 || memcmp(header->magic, SNAPSHOT_MAGIC, 4) != 0 ||
+     header->version != SNAPSHOT_VERSION || header->board_size != sizeof(GameBoard) || header->ai_size != sizeof(AiPlayer)){
+    fprintf(stderr, "%s: not a snapshot written by this build, ignoring\n", path);
+    fclose(fp);
+    return -1;
+  }
+  header->journal_path[SNAPSHOT_PATH_LEN - 1] = '\0';
+
+  *games = malloc((header->game_count ? header->game_count : 1) * sizeof(SnapshotGame));
+  uint32_t loaded = 0;
+  int failed = (*games == NULL);
+  for(; loaded < header->game_count && !failed; loaded++){
+    SnapshotGame *game = &(*games)[loaded];
+    if(fread(game, sizeof(*game), 1, fp) != 1){
+      failed = 1;
+      break;
+    }
+    for(int p = 0; p < 2; p++){
+      GameBoard *board = &game->boards[p];
+      if(!board->sparse)
+        continue;
+      uint32_t count = board->big.used;
+      SparseCell *cells = malloc((count ? count : 1) * sizeof(SparseCell));
+      if(cells == NULL || fread(cells, sizeof(SparseCell), count, fp) != count || sparse_board_load_cells(&board->big, cells, count) < 0){
+        board->big.cells = NULL; // Nothing to free yet
+        board->big.cap = 0;
+        failed = 1;
+      }
+      free(cells);
+    }
+  }
+  fclose(fp);
+  if(failed){
+    fprintf(stderr, "%s: truncated snapshot, ignoring\n", path);
+    for(uint32_t i = 0; *games != NULL && i < loaded; i++)
+      for(int p = 0; p < 2; p++)
+        game_board_free(&(*games)[i].boards[p]);
+    free(*games);
+    return -1;
+  }
+  return (int)header->game_count;
+}
@@ -0,0 +1,74 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+
+#include "../common/common.h"
+#include "../common/ai.h"
+#include "../common/game_board.h"
+
+// Point-in-time image of one shard's live games, used to restart without
+// losing them. Unlike the journal this is a raw dump of the in-memory
+// structs: it is only meant to be read back by the same server binary, and
+// the header records the struct sizes so a mismatched build refuses it.
+// Sparse boards are the exception: their cell tables follow the game they
+// belong to, as many SparseCell entries as the board's used count.
+//
+// A snapshot covers the first journal_records records of journal_path; the
+// rest of that journal (the tail) is replayed on top of it.
+#define SNAPSHOT_MAGIC "BSHS"
+#define SNAPSHOT_VERSION 4
+#define SNAPSHOT_PATH_LEN 512
+
+typedef struct {
+  char magic[4];
+  uint32_t version;
+  uint32_t board_size; // sizeof(GameBoard)
+  uint32_t ai_size;    // sizeof(AiPlayer)
+  uint32_t num_shards;
+  uint32_t shard_idx;
+  uint32_t next_session_id;
+  uint32_t game_count;
+  uint64_t resume_secret;
+  uint64_t journal_records;
+  char journal_path[SNAPSHOT_PATH_LEN];
+} SnapshotHeader;
+
+typedef struct {
+  int id;
+  int phase;
+  int current_player_turn;
+  int players_ready_for_shooting;
+  int ai_slot;
+  GameConfig config;
+  GameBoard boards[2];
+  AiPlayer ai;
+  AiPlayer seen[2]; // Each player's view for hints
+} SnapshotGame;
+
+// Buffered writer that only calls write(2), fsync(2) and rename(2), so it
+// can run in a child forked from a multi-threaded server.
+typedef struct {
+  int fd;
+  int failed;
+  size_t len;
+  uint32_t game_count;
+  unsigned char buf[64 * 1024];
+} SnapshotFile;
+
+// Start writing tmp_path. Returns -1 if it cannot be created.
+int snapshot_begin(SnapshotFile *file, const char *tmp_path);
+
+// Append game, followed by the cell tables of its sparse boards.
+void snapshot_add(SnapshotFile *file, const SnapshotGame *game);
+
+// Write the header (game_count filled in here), fsync and atomically
+// rename tmp_path to path. Returns 0 on success.
+int snapshot_commit(SnapshotFile *file, SnapshotHeader *header, const char *tmp_path, const char *path);
+
+// Read a snapshot. On success returns the number of games and sets *games
+// to a malloc'd array, in which sparse boards own freshly built tables.
+// Returns -1 if the file is missing or unusable.
+int snapshot_load(const char *path, SnapshotHeader *header, SnapshotGame **games);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,157 @@
+#include <string.h>
+#include <limits.h>
+
+#include "timer_wheel.h"
+
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_SPAN (1ull << (WHEEL_BITS * WHEEL_LEVELS)) // Ticks covered by all levels
+
+void timer_wheel_init(TimerWheel *wheel, uint64_t now_ms){
+  memset(wheel, 0, sizeof(*wheel));
+  wheel->tick = now_ms / WHEEL_TICK_MS;
+}
+
+static void link_timer(Timer **head, Timer *timer){
+  timer->next = *head;
+  if(*head != NULL)
+    (*head)->pprev = &timer->next;
+  *head = timer;
+  timer->pprev = head;
+}
+
+static void unlink_timer(TimerWheel *wheel, Timer *timer){
+  *timer->pprev = timer->next;
+  if(timer->next != NULL)
+    timer->next->pprev = timer->pprev;
+  if(timer->slot >= 0){
+    int level = timer->slot / WHEEL_SLOTS, index = timer->slot % WHEEL_SLOTS;
+    if(wheel->slots[level][index] == NULL)
+      wheel->occupied[level] &= ~(1ull << index);
+  }
+  timer->next = NULL;
+  timer->pprev = NULL;
+}
+
+// File a timer by how far away it is: the finest level whose range covers
+// it, at the slot its expiry tick falls in.
+static void place_timer(TimerWheel *wheel, Timer *timer){
+  if(timer->expires < wheel->tick){
+    timer->slot = -1;
+    link_timer(&wheel->due, timer);
+    return;
+  }
+  uint64_t delta = timer->expires - wheel->tick;
+  uint64_t at = (delta < WHEEL_SPAN) ? timer->expires : wheel->tick + WHEEL_SPAN - 1;
+  int level = 0;
+  while(level < WHEEL_LEVELS - 1 && (at - wheel->tick) >= (1ull << (WHEEL_BITS * (level + 1))))
+    level++;
+  int index = (int)((at >> (WHEEL_BITS * level)) & WHEEL_MASK);
+  timer->slot = level * WHEEL_SLOTS + index;
+  link_timer(&wheel->slots[level][index], timer);
+  wheel->occupied[level] |= 1ull << index;
+}
+
+void timer_arm(TimerWheel *wheel, Timer *timer, uint64_t expires_ms){
+  if(timer_armed(timer))
+    unlink_timer(wheel, timer);
+  else
+    wheel->count++;
+  timer->expires = (expires_ms + WHEEL_TICK_MS - 1) / WHEEL_TICK_MS; // Round up: never fire early
+  place_timer(wheel, timer);
+}
+
+void timer_cancel(TimerWheel *wheel, Timer *timer){
+  if(!timer_armed(timer))
+    return;
+  unlink_timer(wheel, timer);
+  wheel->count--;
+}
+
+// Redistribute the current slot of level over the levels below. Runs when
+// every level under it has wrapped, the level above first if it wrapped too.
+static void cascade(TimerWheel *wheel, int level){
+  if(level >= WHEEL_LEVELS)
+    return;
+  int index = (int)((wheel->tick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+  if(index == 0)
+    cascade(wheel, level + 1);
+  Timer *list = wheel->slots[level][index];
+  wheel->slots[level][index] = NULL;
+  wheel->occupied[level] &= ~(1ull << index);
+  while(list != NULL){
+    Timer *next = list->next;
+    place_timer(wheel, list);
+    list = next;
+  }
+}
+
+Timer *timer_wheel_expire(TimerWheel *wheel, uint64_t now_ms){
+  uint64_t target = now_ms / WHEEL_TICK_MS;
+  while(wheel->due == NULL && wheel->tick <= target){
+    if(wheel->count == 0){
+      wheel->tick = target + 1;
+      break;
+    }
+    int index = (int)(wheel->tick & WHEEL_MASK);
+    if(index == 0)
+      cascade(wheel, 1);
+    if(wheel->occupied[0] == 0){
+      // Nothing in level 0 until the next cascade
+      uint64_t next = (wheel->tick | WHEEL_MASK) + 1;
+      wheel->tick = (next <= target) ? next : target + 1;
+      continue;
+    }
+    Timer *list = wheel->slots[0][index];
+    wheel->slots[0][index] = NULL;
+    wheel->occupied[0] &= ~(1ull << index);
+    while(list != NULL){
+      Timer *next = list->next;
+      list->slot = -1;
+      link_timer(&wheel->due, list);
+      list = next;
+    }
+    wheel->tick++;
+  }
+  Timer *timer = wheel->due;
+  if(timer == NULL)
+    return NULL;
+  unlink_timer(wheel, timer);
+  wheel->count--;
+  return timer;
+}
+
+// Distance from index from to the next set bit, wrapping around; -1 if none.
+static int next_occupied(uint64_t bits, int from){
+  if(bits == 0)
+    return -1;
+  uint64_t rotated = (bits >> from) | (from ? bits << (WHEEL_SLOTS - from) : 0);
+  return __builtin_ctzll(rotated);
+}
+
+int timer_wheel_timeout_ms(const TimerWheel *wheel, uint64_t now_ms){
+  if(wheel->due != NULL)
+    return 0;
+  if(wheel->count == 0)
+    return -1;
+  // Level 0 gives the exact tick; above it, the next cascade that has
+  // anything to move down is as far as it is safe to sleep
+  uint64_t wake = UINT64_MAX;
+  for(int level = 0; level < WHEEL_LEVELS; level++){
+    int shift = WHEEL_BITS * level;
+    uint64_t first = wheel->tick >> shift;
+    if(wheel->tick & ((1ull << shift) - 1))
+      first++; // This level's current slot was cascaded already
+    int distance = next_occupied(wheel->occupied[level], (int)(first & WHEEL_MASK));
+    if(distance < 0)
+      continue;
+    uint64_t at = (first + (uint64_t)distance) << shift;
+    if(at < wake)
+      wake = at;
+  }
+  if(wake == UINT64_MAX)
+    return -1;
+  uint64_t wake_ms = wake * WHEEL_TICK_MS;
+  if(wake_ms <= now_ms)
+    return 0;
+  return (wake_ms - now_ms > INT_MAX) ? INT_MAX : (int)(wake_ms - now_ms);
+}
@@ -0,0 +1,58 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdint.h>
+
+// Hierarchical timing wheel. Level 0 has one slot per tick, every level
+// above it has slots WHEEL_SLOTS times coarser; when a level wraps, the
+// next slot of the level above is cascaded down. Arming and cancelling are
+// O(1) list operations and a timer is moved at most once per level before
+// it fires, so the cost does not grow with the number of live timers.
+//
+// Timers are embedded in the objects they time. A wheel and its timers
+// belong to one event loop and are never shared between threads.
+
+#define WHEEL_TICK_MS 10
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_LEVELS 4 // 2^24 ticks, about 46 hours; later timers wait in the top level
+
+typedef struct Timer Timer;
+struct Timer {
+  uint64_t expires; // Tick
+  Timer *next;
+  Timer **pprev; // Link pointing at this timer, NULL while disarmed
+  int slot; // level * WHEEL_SLOTS + index, -1 once due
+  int kind; // Owner's tag, never read by the wheel
+};
+
+typedef struct {
+  uint64_t tick; // Next tick to process
+  Timer *slots[WHEEL_LEVELS][WHEEL_SLOTS];
+  uint64_t occupied[WHEEL_LEVELS]; // One bit per non-empty slot
+  Timer *due; // Expired and not handed out yet
+  unsigned long count; // Armed timers, due ones included
+} TimerWheel;
+
+void timer_wheel_init(TimerWheel *wheel, uint64_t now_ms);
+
+static inline int timer_armed(const Timer *timer){
+  return timer->pprev != NULL;
+}
+
+// Fire at or after expires_ms, on the same clock as now_ms. An armed timer
+// is moved.
+void timer_arm(TimerWheel *wheel, Timer *timer, uint64_t expires_ms);
+
+// No-op on a disarmed timer.
+void timer_cancel(TimerWheel *wheel, Timer *timer);
+
+// Next timer due by now_ms, disarmed, or NULL. Hand-outs are one at a time
+// so handlers may arm and cancel any timer, including ones also due.
+Timer *timer_wheel_expire(TimerWheel *wheel, uint64_t now_ms);
+
+// Milliseconds the event loop may sleep before timer_wheel_expire() has
+// work, -1 if nothing is armed. May be early, never late.
+int timer_wheel_timeout_ms(const TimerWheel *wheel, uint64_t now_ms);
+
+#endif // TIMER_WHEEL_H
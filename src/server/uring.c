@@ -0,0 +1,185 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "uring.h"
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *params){
+  return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, const void *arg, size_t argsz){
+  return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, argsz);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, const void *arg, unsigned nr_args){
+  return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+static int map_rings(Uring *ring, const struct io_uring_params *params){
+  ring->sq_map_len = params->sq_off.array + params->sq_entries * sizeof(unsigned);
+  ring->cq_map_len = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+  if(params->features & IORING_FEAT_SINGLE_MMAP){
+    if(ring->cq_map_len > ring->sq_map_len)
+      ring->sq_map_len = ring->cq_map_len;
+  }
+  ring->sq_map = mmap(NULL, ring->sq_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  if(ring->sq_map == MAP_FAILED)
+    return -1;
+  if(params->features & IORING_FEAT_SINGLE_MMAP){
+    ring->cq_map = ring->sq_map;
+    ring->cq_map_len = 0;
+  }
+  else{
+    ring->cq_map = mmap(NULL, ring->cq_map_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    if(ring->cq_map == MAP_FAILED)
+      return -1;
+  }
+  ring->sqes_len = params->sq_entries * sizeof(struct io_uring_sqe);
+  ring->sqes = mmap(NULL, ring->sqes_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  if(ring->sqes == MAP_FAILED)
+    return -1;
+
+  unsigned char *sq = ring->sq_map;
+  ring->sq_head = (unsigned *)(sq + params->sq_off.head);
+  ring->sq_tail = (unsigned *)(sq + params->sq_off.tail);
+  ring->sq_mask = *(unsigned *)(sq + params->sq_off.ring_mask);
+  ring->sq_entries = params->sq_entries;
+  // Entries are always used in order, so the indirection array is fixed
+  unsigned *array = (unsigned *)(sq + params->sq_off.array);
+  for(unsigned i = 0; i < params->sq_entries; i++)
+    array[i] = i;
+
+  unsigned char *cq = ring->cq_map;
+  ring->cq_head = (unsigned *)(cq + params->cq_off.head);
+  ring->cq_tail = (unsigned *)(cq + params->cq_off.tail);
+  ring->cq_mask = *(unsigned *)(cq + params->cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe *)(cq + params->cq_off.cqes);
+  return 0;
+}
+
+static int register_buffers(Uring *ring, unsigned buf_count, unsigned buf_size){
+  ring->buf_count = buf_count;
+  ring->buf_size = buf_size;
+  ring->buf_ring_len = buf_count * sizeof(struct io_uring_buf);
+  ring->buf_ring = mmap(NULL, ring->buf_ring_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(ring->buf_ring == MAP_FAILED){
+    ring->buf_ring = NULL;
+    return -1;
+  }
+  ring->bufs = mmap(NULL, (size_t)buf_count * buf_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(ring->bufs == MAP_FAILED){
+    ring->bufs = NULL;
+    return -1;
+  }
+
+  struct io_uring_buf_reg reg;
+  memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = (uint64_t)(uintptr_t)ring->buf_ring;
+  reg.ring_entries = buf_count;
+  reg.bgid = URING_BUF_GROUP;
+  if(sys_io_uring_register(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    return -1;
+  for(unsigned bid = 0; bid < buf_count; bid++)
+    uring_recycle_buf(ring, bid);
+  return 0;
+}
+
+int uring_init(Uring *ring, unsigned entries, unsigned buf_count, unsigned buf_size){
+  memset(ring, 0, sizeof(*ring));
+  ring->fd = -1;
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  // Multishot receives post many completions per submission
+  params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_CQSIZE;
+  params.cq_entries = entries * 8;
+  ring->fd = sys_io_uring_setup(entries, &params);
+  if(ring->fd < 0)
+    return -1;
+  if(!(params.features & IORING_FEAT_NODROP) || !(params.features & IORING_FEAT_EXT_ARG)){
+    uring_exit(ring);
+    errno = ENOSYS;
+    return -1;
+  }
+  if(map_rings(ring, &params) < 0 || register_buffers(ring, buf_count, buf_size) < 0){
+    int saved = errno;
+    uring_exit(ring);
+    errno = saved;
+    return -1;
+  }
+  return 0;
+}
+
+void uring_exit(Uring *ring){
+  if(ring->bufs != NULL)
+    munmap(ring->bufs, (size_t)ring->buf_count * ring->buf_size);
+  if(ring->buf_ring != NULL)
+    munmap(ring->buf_ring, ring->buf_ring_len);
+  if(ring->sqes != NULL && ring->sqes != MAP_FAILED)
+    munmap(ring->sqes, ring->sqes_len);
+  if(ring->cq_map != NULL && ring->cq_map != MAP_FAILED && ring->cq_map != ring->sq_map)
+    munmap(ring->cq_map, ring->cq_map_len);
+  if(ring->sq_map != NULL && ring->sq_map != MAP_FAILED)
+    munmap(ring->sq_map, ring->sq_map_len);
+  if(ring->fd >= 0)
+    close(ring->fd);
+  memset(ring, 0, sizeof(*ring));
+  ring->fd = -1;
+}
+
+static int enter(Uring *ring, unsigned min_complete, int timeout_ms){
+  struct timespec ts;
+  struct io_uring_getevents_arg arg;
+  memset(&arg, 0, sizeof(arg));
+  arg.sigmask_sz = _NSIG / 8;
+  if(timeout_ms >= 0){
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+    arg.ts = (uint64_t)(uintptr_t)&ts;
+  }
+  unsigned submit = ring->sq_pending;
+  ring->enters++;
+  int n = sys_io_uring_enter(ring->fd, submit, min_complete, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+  if(n < 0){
+    if(errno == ETIME || errno == EINTR)
+      return 0; // Anything submitted before the wait stays submitted
+    return -1;
+  }
+  ring->sq_pending -= (unsigned)n < submit ? (unsigned)n : submit;
+  return 0;
+}
+
+struct io_uring_sqe *uring_get_sqe(Uring *ring){
+  unsigned tail = *ring->sq_tail;
+  if(tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) == ring->sq_entries){
+    if(enter(ring, 0, 0) < 0)
+      return NULL;
+    if(tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) == ring->sq_entries)
+      return NULL;
+  }
+  struct io_uring_sqe *sqe = &ring->sqes[tail & ring->sq_mask];
+  memset(sqe, 0, sizeof(*sqe));
+  __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+  ring->sq_pending++;
+  return sqe;
+}
+
+int uring_submit_and_wait(Uring *ring, int timeout_ms){
+  if(uring_peek_cqe(ring) != NULL)
+    timeout_ms = 0; // Completions already waiting: just submit
+  return enter(ring, timeout_ms == 0 ? 0 : 1, timeout_ms);
+}
+
+void uring_recycle_buf(Uring *ring, unsigned bid){
+  struct io_uring_buf *buf = &ring->buf_ring->bufs[ring->buf_tail & (ring->buf_count - 1)];
+  buf->addr = (uint64_t)(uintptr_t)uring_buf(ring, bid);
+  buf->len = ring->buf_size;
+  buf->bid = (uint16_t)bid;
+  ring->buf_tail++;
+  __atomic_store_n(&ring->buf_ring->tail, ring->buf_tail, __ATOMIC_RELEASE);
+}
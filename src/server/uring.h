@@ -0,0 +1,84 @@
+#ifndef URING_H
+#define URING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <linux/io_uring.h>
+
+// Just enough io_uring for the server, over the raw system calls: one ring
+// with its submission and completion queues mapped, and one provided-buffer
+// ring that multishot receives pick their buffers from.
+//
+// The ring is set up single issuer with deferred task work, which needs
+// Linux 6.1. That is newer than everything else used here (multishot
+// receive and accept, buffer rings), so a ring that sets up at all can run
+// the server; anything older fails uring_init() and the caller falls back
+// to epoll.
+
+#define URING_BUF_GROUP 0
+
+typedef struct {
+  int fd;
+  // Submission queue
+  unsigned *sq_head;
+  unsigned *sq_tail;
+  unsigned sq_mask;
+  unsigned sq_entries;
+  unsigned sq_pending; // Queued since the last io_uring_enter
+  struct io_uring_sqe *sqes;
+  // Completion queue
+  unsigned *cq_head;
+  unsigned *cq_tail;
+  unsigned cq_mask;
+  struct io_uring_cqe *cqes;
+  // Provided buffers
+  struct io_uring_buf_ring *buf_ring;
+  unsigned char *bufs;
+  unsigned buf_count;
+  unsigned buf_size;
+  uint16_t buf_tail;
+  // Mappings, for uring_exit()
+  void *sq_map;
+  size_t sq_map_len;
+  void *cq_map;
+  size_t cq_map_len;
+  size_t sqes_len;
+  size_t buf_ring_len;
+  uint64_t enters; // io_uring_enter calls so far
+} Uring;
+
+// Returns -1 with errno set if the kernel lacks what the server needs.
+// buf_count must be a power of two.
+int uring_init(Uring *ring, unsigned entries, unsigned buf_count, unsigned buf_size);
+
+void uring_exit(Uring *ring);
+
+// Zeroed submission entry, queued for the next io_uring_enter. A full
+// queue is submitted first to make room. NULL if that fails.
+struct io_uring_sqe *uring_get_sqe(Uring *ring);
+
+// Submit everything queued and wait until at least one completion is
+// ready or timeout_ms passes (-1 waits forever, 0 only submits and reaps).
+// Returns 0 or -1 with errno set; timeouts and signals are not errors.
+int uring_submit_and_wait(Uring *ring, int timeout_ms);
+
+// Oldest unread completion, NULL if none. Release it with uring_cqe_seen().
+static inline struct io_uring_cqe *uring_peek_cqe(Uring *ring){
+  unsigned head = *ring->cq_head;
+  if(head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+    return NULL;
+  return &ring->cqes[head & ring->cq_mask];
+}
+
+static inline void uring_cqe_seen(Uring *ring){
+  __atomic_store_n(ring->cq_head, *ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+static inline unsigned char *uring_buf(const Uring *ring, unsigned bid){
+  return ring->bufs + (size_t)bid * ring->buf_size;
+}
+
+// Give a provided buffer back to the kernel once its data is consumed.
+void uring_recycle_buf(Uring *ring, unsigned bid);
+
+#endif // URING_H
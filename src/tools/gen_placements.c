@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../common/common.h"
+
+// Build-time generator for placement_table.h. For the compiled-in
+// BOARD_ROWS x BOARD_COLS board it enumerates every legal (row, col,
+// orientation) of every ship size and writes the cell masks as constant
+// tables, so placement checks and the AI read masks instead of doing
+// coordinate arithmetic at run time. The Makefile reruns it whenever
+// common.h changes.
+
+#define CELLS (BOARD_ROWS * BOARD_COLS)
+#define MAX_SIZE (BOARD_ROWS > BOARD_COLS ? BOARD_ROWS : BOARD_COLS)
+
+_Static_assert(CELLS <= 128, "placement masks are 128 bits wide");
+
+typedef unsigned __int128 Mask;
+
+static int fits(int row, int col, int size, int vertical){
+  if(vertical)
+    return row + size <= BOARD_ROWS;
+  return col + size <= BOARD_COLS;
+}
+
+static Mask cells_of(int row, int col, int size, int vertical){
+  Mask mask = 0;
+  for(int i = 0; i < size; i++){
+    int r = row + (vertical ? i : 0);
+    int c = col + (vertical ? 0 : i);
+    mask |= (Mask)1 << (r * BOARD_COLS + c);
+  }
+  return mask;
+}
+
+static void print_mask(Mask mask){
+  if(mask == 0){
+    printf("0");
+    return;
+  }
+  printf("PLACEMENT_MASK(0x%llxull, 0x%llxull)", (unsigned long long)(mask >> 64), (unsigned long long)mask);
+}
+
+int main(void){
+  printf("// Generated by src/tools/gen_placements.c. Do not edit.\n");
+  printf("#ifndef PLACEMENT_TABLE_H\n#define PLACEMENT_TABLE_H\n\n");
+  printf("#include <stdint.h>\n\n#include \"bitboard.h\"\n\n");
+  printf("_Static_assert(BOARD_ROWS == %d && BOARD_COLS == %d, \"placement_table.h is stale, rerun make\");\n\n", BOARD_ROWS, BOARD_COLS);
+  printf("#define PLACEMENT_MAX_SIZE %d\n", MAX_SIZE);
+  printf("#define PLACEMENT_MASK(hi, lo) (((BoardMask)(hi) << 64) | (BoardMask)(lo))\n\n");
+
+  // Mask of every placement by size, orientation and top-left cell
+  printf("// Cells covered by a ship of size s, orientation o, top-left cell i;\n");
+  printf("// 0 where the ship would leave the board.\n");
+  printf("static const BoardMask placement_at[PLACEMENT_MAX_SIZE + 1][2][BOARD_CELLS] = {\n");
+  for(int size = 0; size <= MAX_SIZE; size++){
+    printf("  { // Size %d\n", size);
+    for(int vertical = 0; vertical < 2; vertical++){
+      printf("    {");
+      for(int cell = 0; cell < CELLS; cell++){
+        int row = cell / BOARD_COLS, col = cell % BOARD_COLS;
+        Mask mask = (size > 0 && fits(row, col, size, vertical)) ? cells_of(row, col, size, vertical) : 0;
+        printf("%s", cell ? ", " : "");
+        print_mask(mask);
+      }
+      printf("},\n");
+    }
+    printf("  },\n");
+  }
+  printf("};\n\n");
+
+  // Top-left cells that keep a ship on the board
+  printf("// Legal top-left cells by size and orientation.\n");
+  printf("static const BoardMask placement_starts[PLACEMENT_MAX_SIZE + 1][2] = {\n");
+  for(int size = 0; size <= MAX_SIZE; size++){
+    printf("  {");
+    for(int vertical = 0; vertical < 2; vertical++){
+      Mask starts = 0;
+      for(int cell = 0; size > 0 && cell < CELLS; cell++)
+        if(fits(cell / BOARD_COLS, cell % BOARD_COLS, size, vertical))
+          starts |= (Mask)1 << cell;
+      printf("%s", vertical ? ", " : "");
+      print_mask(starts);
+    }
+    printf("},\n");
+  }
+  printf("};\n\n");
+
+  // Flat list of every legal placement, grouped by size
+  int first[MAX_SIZE + 2];
+  int total = 0;
+  for(int size = 0; size <= MAX_SIZE; size++){
+    first[size] = total;
+    for(int vertical = 0; size > 0 && vertical < 2; vertical++)
+      for(int cell = 0; cell < CELLS; cell++)
+        total += fits(cell / BOARD_COLS, cell % BOARD_COLS, size, vertical);
+  }
+  first[MAX_SIZE + 1] = total;
+
+  printf("// Legal placements of size s are placement_list[placement_first[s]]\n");
+  printf("// up to placement_list[placement_first[s + 1]], each the top-left cell\n");
+  printf("// index shifted left by one, or'd with 1 when vertical.\n");
+  printf("static const uint16_t placement_first[PLACEMENT_MAX_SIZE + 2] = {");
+  for(int size = 0; size <= MAX_SIZE + 1; size++)
+    printf("%s%d", size ? ", " : "", first[size]);
+  printf("};\n\n");
+
+  printf("static const uint16_t placement_list[%d] = {", total);
+  int n = 0;
+  for(int size = 1; size <= MAX_SIZE; size++)
+    for(int vertical = 0; vertical < 2; vertical++)
+      for(int cell = 0; cell < CELLS; cell++){
+        if(!fits(cell / BOARD_COLS, cell % BOARD_COLS, size, vertical))
+          continue;
+        printf("%s%s%d", n ? "," : "", (n % 16) ? " " : "\n  ", cell << 1 | vertical);
+        n++;
+      }
+  printf("\n};\n\n#endif // PLACEMENT_TABLE_H\n");
+
+  if(fflush(stdout) != 0){
+    perror("gen_placements");
+    exit(EXIT_FAILURE);
+  }
+  return 0;
+}